@@ -0,0 +1,160 @@
+﻿#ifndef ARCHIVEREADER_H
+#define ARCHIVEREADER_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QFile>
+#include <QtGlobal>
+
+typedef struct z_stream_s z_stream;
+
+/**
+ * @class ArchiveReader
+ * @brief Lecture en flux des archives .zip, .tar et .tar.gz / .tgz
+ *
+ * Les entrees sont lues une par une et leur contenu est transmis par blocs:
+ * rien n'est extrait dans un dossier temporaire et la memoire utilisee ne
+ * depend pas de la taille de l'archive (tampons fixes, y compris pour la
+ * decompression).
+ *
+ * Les chemins sont verifies avant d'etre renvoyes: chemins absolus, lecteurs
+ * Windows, composants ".." ou ".git" sont refuses (zip-slip). Les liens
+ * symboliques, liens physiques, fichiers speciaux et entrees chiffrees sont
+ * ignores et signales dans errors().
+ *
+ * La decompression (gzip, deflate) demande zlib (ROGUE_HAVE_ZLIB); sans elle,
+ * seuls les .tar et les entrees zip non compressees sont lisibles.
+ */
+class ArchiveReader {
+public:
+    enum class Format {
+        Unknown,
+        Tar,
+        TarGzip,
+        Zip
+    };
+
+    struct Entry {
+        QString path; // Chemin relatif verifie, separateur '/'
+        qint64 size = 0;
+        QFile::Permissions permissions;
+        bool isDirectory = false;
+    };
+
+    explicit ArchiveReader(const QString& archivePath);
+    ~ArchiveReader();
+
+    ArchiveReader(const ArchiveReader&) = delete;
+    ArchiveReader& operator=(const ArchiveReader&) = delete;
+
+    /**
+     * @brief Format d'apres les premiers octets du fichier
+     *
+     * Un flux gzip n'est une archive que s'il porte l'extension .tar.gz ou .tgz.
+     */
+    static Format detect(const QString& path);
+    static bool isArchive(const QString& path) { return detect(path) != Format::Unknown; }
+
+    /**
+     * @brief Nom du dossier d'extraction: nom du fichier sans .zip, .tar, .tar.gz ou .tgz
+     */
+    static QString baseName(const QString& path);
+
+    /**
+     * @brief Chemin d'entree normalise, vide s'il sort de la destination
+     */
+    static QString sanitizePath(const QString& rawPath);
+
+    bool open();
+    Format format() const { return m_format; }
+
+    /**
+     * @brief Nombre de fichiers, lu dans le repertoire central d'un zip
+     * @return -1 pour un tar (il faudrait tout decompresser pour le savoir)
+     */
+    qint64 fileCount();
+
+    /**
+     * @brief Entree suivante (le reste de l'entree courante est saute)
+     * @param entry Entree lue (output)
+     * @return false a la fin de l'archive ou sur erreur (voir errorString())
+     */
+    bool next(Entry& entry);
+
+    /**
+     * @brief Contenu de l'entree courante
+     * @return Octets lus, 0 a la fin de l'entree, -1 sur erreur
+     */
+    qint64 read(char* data, qint64 maxSize);
+
+    /**
+     * @brief Erreur fatale: archive tronquee, corrompue ou format non gere
+     */
+    QString errorString() const { return m_error; }
+
+    /**
+     * @brief Entrees ignorees (chemins refuses, liens, chiffrement...)
+     */
+    QStringList errors() const { return m_errors; }
+
+    static constexpr qint64 bufferSize() { return 256 * 1024; }
+
+private:
+    struct ZipHeader {
+        QByteArray name;
+        quint64 size = 0;
+        quint64 compressedSize = 0;
+        quint64 localOffset = 0;
+        quint32 crc = 0;
+        quint32 externalAttributes = 0;
+        quint16 flags = 0;
+        quint16 method = 0;
+        quint8 host = 0; // Systeme createur: 0 MS-DOS, 3 Unix
+    };
+
+    bool fail(const QString& message);
+
+    // Tar, eventuellement derriere gzip
+    bool nextTarEntry(Entry& entry);
+    qint64 readStream(char* data, qint64 maxSize);
+    qint64 readBlock(char* data, qint64 size);
+    bool skipStream(qint64 size);
+    bool readTarText(qint64 size, QByteArray& text);
+
+    // Zip: repertoire central puis donnees locales
+    bool openZip();
+    bool nextZipEntry(Entry& entry);
+    bool readZipCentralHeader(qint64& position, ZipHeader& header);
+    qint64 readZipData(char* data, qint64 maxSize);
+    static quint32 zipMode(const ZipHeader& header, bool& isDirectory, bool& isSymlink);
+
+    bool startInflate(bool gzip);
+    void endInflate();
+
+    QFile m_file;
+    Format m_format;
+    QString m_error;
+    QStringList m_errors;
+    QByteArray m_input; // Tampon d'entree de la decompression
+    z_stream* m_zstream;
+    bool m_streamEnded;
+
+    // Entree courante
+    qint64 m_remaining;      // Octets de donnees non lus
+    qint64 m_padding;        // Bourrage tar apres les donnees
+    qint64 m_compressedLeft; // Zip: octets compresses non lus
+    quint16 m_method;
+    quint32 m_expectedCrc;
+    quint32 m_crc;
+    bool m_checkCrc;
+
+    // Zip
+    qint64 m_centralOffset;
+    qint64 m_centralPosition;
+    qint64 m_entriesLeft;
+    qint64 m_entryTotal;
+    qint64 m_dataPosition; // Prochain octet compresse de l'entree courante
+};
+
+#endif // ARCHIVEREADER_H
@@ -0,0 +1,103 @@
+﻿#ifndef COMPACTPATHLIST_H
+#define COMPACTPATHLIST_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QHash>
+
+/**
+ * @class CompactPathList
+ * @brief Liste compacte de chemins relatifs a une racine (fichiers copies, indexes...)
+ *
+ * Les noms sont stockes en UTF-8 dans une arene unique; les dossiers sont
+ * internes et partages par tous leurs fichiers.
+ *
+ * Cout memoire par fichier: 12 octets d'index + la longueur UTF-8 de son nom
+ * (sans le chemin du dossier). Chaque dossier distinct coute en plus 8 octets
+ * et son chemin relatif UTF-8, present deux fois tant que la table d'interning
+ * existe (liberee par squeeze()). A titre de comparaison, un QStringList de
+ * chemins absolus coute ~2 octets par caractere du chemin complet plus ~40
+ * octets d'en-tete et de pointeur par fichier.
+ *
+ * La liste n'est pas copiable: elle se transmet par deplacement entre etapes.
+ */
+class CompactPathList {
+public:
+    explicit CompactPathList(const QString& root = QString());
+
+    CompactPathList(CompactPathList&& other) noexcept = default;
+    CompactPathList& operator=(CompactPathList&& other) noexcept = default;
+    CompactPathList(const CompactPathList&) = delete;
+    CompactPathList& operator=(const CompactPathList&) = delete;
+
+    QString root() const { return m_root; }
+
+    /**
+     * @brief Ajoute un fichier
+     * @param relativeDir Dossier relatif a la racine ("" pour la racine), separateur '/'
+     * @param fileName Nom du fichier
+     */
+    void append(const QString& relativeDir, const QString& fileName);
+
+    /**
+     * @brief Ajoute un fichier a partir de son chemin relatif complet
+     */
+    void appendPath(const QString& relativePath);
+
+    qsizetype size() const { return m_files.size(); }
+    bool isEmpty() const { return m_files.isEmpty(); }
+
+    QString relativePath(qsizetype index) const;
+    QString absolutePath(qsizetype index) const;
+
+    /**
+     * @brief Chemin relatif en UTF-8, pret a etre ecrit sur l'entree de git
+     */
+    QByteArray relativePathUtf8(qsizetype index) const;
+
+    /**
+     * @brief Libere la table d'interning et la capacite excedentaire
+     *
+     * Les ajouts restent possibles mais ne partagent plus les dossiers existants.
+     */
+    void squeeze();
+    void clear();
+
+    /**
+     * @brief Ne garde que les size premiers fichiers (leurs noms restent dans l'arene)
+     */
+    void truncate(qsizetype size);
+
+    /**
+     * @brief Octets alloues par la structure (hors en-tetes des conteneurs)
+     */
+    qsizetype memoryUsage() const;
+
+private:
+    struct Span {
+        quint32 offset;
+        quint32 length;
+    };
+
+    struct FileEntry {
+        quint32 dirIndex;
+        Span name;
+    };
+
+    Span store(const QByteArray& utf8);
+    quint32 internDirectory(const QString& relativeDir);
+
+    QString m_root;
+    QByteArray m_arena;
+    QVector<Span> m_dirs;
+    QVector<FileEntry> m_files;
+    QHash<QByteArray, quint32> m_dirLookup;
+
+    // Les fichiers d'un meme dossier arrivent consecutivement: evite le hachage
+    QString m_lastDir;
+    quint32 m_lastDirIndex = 0;
+    bool m_hasLastDir = false;
+};
+
+#endif // COMPACTPATHLIST_H
@@ -0,0 +1,146 @@
+﻿#ifndef DIRWALKER_H
+#define DIRWALKER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QSet>
+#include <QPair>
+#include <QtGlobal>
+
+/**
+ * @class DirWalker
+ * @brief Parcours d'arborescence en une passe, sans recursion ni stat par entree
+ *
+ * Chaque dossier est lu une seule fois (getdents64 sous Linux, readdir ailleurs
+ * sous Unix, FindFirstFileEx sous Windows) et le type des entrees vient de
+ * d_type. Les dossiers a visiter sont empiles explicitement: la profondeur de
+ * l'arborescence n'est pas limitee par la pile C++. Un dossier deja visite
+ * (meme peripherique et meme inode) n'est jamais parcouru deux fois.
+ *
+ * Les entrees .git ne sont jamais renvoyees. Les entrees cachees (nom commencant
+ * par un point, ou attribut cache sous Windows) sont ignorees sauf demande
+ * explicite, comme le faisaient les filtres QDir de la copie d'origine.
+ *
+ * Un dossier est renvoye avant son contenu; l'ordre entre freres n'est pas defini.
+ */
+class DirWalker {
+public:
+    /**
+     * @brief Traitement des liens symboliques
+     */
+    enum class SymlinkPolicy {
+        Skip,        // Liens ignores
+        FollowFiles, // Liens vers des fichiers suivis, liens vers des dossiers ignores
+        FollowAll    // Tous les liens suivis, cycles detectes par peripherique/inode
+    };
+
+    struct Entry {
+        QString relativeDir; // Dossier relatif a la racine ("" pour la racine), separateur '/'
+        QString name;
+        bool isDirectory = false;
+        bool isSymlink = false;  // Lien renvoye sans etre suivi (setReportSymlinks)
+        qint64 size = -1;        // Fichiers, avec setFileMetadata seulement
+        qint64 modifiedMSecs = 0;
+
+        QString relativePath() const {
+            return relativeDir.isEmpty() ? name : relativeDir + '/' + name;
+        }
+    };
+
+    explicit DirWalker(const QString& rootPath, SymlinkPolicy policy = SymlinkPolicy::FollowFiles,
+                       bool includeHidden = false);
+    ~DirWalker();
+
+    DirWalker(const DirWalker&) = delete;
+    DirWalker& operator=(const DirWalker&) = delete;
+
+    /**
+     * @return false si la racine n'est pas un dossier lisible
+     */
+    bool isValid() const { return m_valid; }
+    bool includesHidden() const { return m_includeHidden; }
+
+    /**
+     * @brief Parcours limite a la racine: ses sous-dossiers sont renvoyes, pas visites (defaut: recursif)
+     */
+    void setRecursive(bool recursive) { m_recursive = recursive; }
+
+    /**
+     * @brief Taille et date des fichiers renvoyes (defaut: non)
+     *
+     * Seuls les fichiers sont dates, d'un fstatat relatif au dossier deja
+     * ouvert; sous Windows, FindFirstFileEx les fournit sans appel de plus.
+     */
+    void setFileMetadata(bool enabled) { m_fileMetadata = enabled; }
+
+    /**
+     * @brief Liens renvoyes tels quels, comme des fichiers, sans etre suivis (defaut: non)
+     *
+     * La politique de liens est alors ignoree: sert a lister une destination
+     * ou un lien doit etre remplace, jamais traverse.
+     */
+    void setReportSymlinks(bool report) { m_reportSymlinks = report; }
+
+    /**
+     * @brief Entree suivante
+     * @param entry Entree lue (output)
+     * @return false a la fin du parcours
+     */
+    bool next(Entry& entry);
+
+    QString absolutePath(const Entry& entry) const;
+
+    /**
+     * @brief Dossiers illisibles ou cycles rencontres pendant le parcours
+     */
+    QStringList errors() const { return m_errors; }
+
+    /**
+     * @brief Vrai si une entree .git a ete rencontree (et ignoree) pendant le parcours
+     */
+    bool foundGitDir() const { return m_foundGitDir; }
+
+    /**
+     * @brief Compte les fichiers sous un chemin (un fichier simple compte pour 1)
+     * @param limit Arret du parcours des limit fichiers atteints (0 = sans limite)
+     */
+    static qint64 countFiles(const QString& path, SymlinkPolicy policy = SymlinkPolicy::FollowFiles,
+                             bool includeHidden = false, qint64 limit = 0);
+
+    /**
+     * @brief Nom d'un depot imbrique (.git, sans tenir compte de la casse)
+     */
+    static bool isGitDirName(const QString& name);
+
+private:
+    struct PendingDir {
+        QString relativePath;
+        bool viaSymlink;
+    };
+
+    bool readDirectory(const PendingDir& dir);
+    bool markVisited(quint64 device, quint64 inode);
+    Entry& addEntry(const QString& relativeDir, const QString& name, bool isDirectory, bool viaSymlink);
+
+    QString m_rootPath;
+    SymlinkPolicy m_policy;
+    bool m_includeHidden;
+    bool m_valid;
+    bool m_foundGitDir;
+    bool m_recursive;
+    bool m_fileMetadata;
+    bool m_reportSymlinks;
+    QVector<PendingDir> m_stack;
+    QVector<Entry> m_batch;
+    qsizetype m_batchIndex;
+    QSet<QPair<quint64, quint64>> m_visited;
+    QStringList m_errors;
+
+#if defined(Q_OS_UNIX)
+    int m_rootFd;
+    QByteArray m_buffer;
+#endif
+};
+
+#endif // DIRWALKER_H
@@ -0,0 +1,127 @@
+﻿#ifndef FETCHSCHEDULER_H
+#define FETCHSCHEDULER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QProcess>
+#include <QTimer>
+#include "gitmanager.h"
+
+/**
+ * @class FetchScheduler
+ * @brief Synchronise periodiquement la branche configuree en arriere-plan
+ *
+ * Chaque cycle lance un fetch de basse priorite, calcule l'avance et le retard
+ * de <branche> par rapport a origin/<branche> et avance la branche en
+ * fast-forward si elle est extraite et que l'arbre de travail est propre. Les
+ * processus sont asynchrones: l'interface n'est jamais bloquee.
+ */
+class FetchScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Suspend le planificateur pendant la duree de vie de l'objet
+     */
+    class PauseGuard {
+    public:
+        explicit PauseGuard(FetchScheduler* scheduler) : m_scheduler(scheduler) { m_scheduler->pause(); }
+        ~PauseGuard() { m_scheduler->resume(); }
+        PauseGuard(const PauseGuard&) = delete;
+        PauseGuard& operator=(const PauseGuard&) = delete;
+
+    private:
+        FetchScheduler* m_scheduler;
+    };
+
+    explicit FetchScheduler(QObject* parent = nullptr);
+    ~FetchScheduler();
+
+    /**
+     * @brief Configure le depot a synchroniser
+     * @param repoPath Chemin du depot local
+     * @param remoteUrl URL du depot distant
+     * @param branch Branche suivie
+     */
+    void setRepository(const QString& repoPath, const QString& remoteUrl, const QString& branch);
+
+    /**
+     * @brief Configure les identifiants utilises pour le fetch
+     * @param username Nom d'utilisateur GitHub
+     * @param token Token d'acces personnel GitHub
+     */
+    void setCredentials(const QString& username, const QString& token);
+
+    void setTransportProfile(TransportProfile profile) { m_transportProfile = profile; }
+
+    /**
+     * @brief Intervalle entre deux cycles de synchronisation
+     * @param intervalMs Intervalle en millisecondes
+     */
+    void setInterval(int intervalMs);
+
+    void start();
+    void stop();
+
+    /**
+     * @brief Lance un cycle immediatement (ou des la reprise si en pause)
+     */
+    void fetchNow();
+
+    /**
+     * @brief Suspend les cycles; un fetch en cours est interrompu
+     *
+     * Les appels s'imbriquent: chaque pause() doit etre suivie d'un resume().
+     */
+    void pause();
+    void resume();
+    bool isPaused() const { return m_pauseCount > 0; }
+
+    /**
+     * @brief Vrai pendant un cycle (fetch, comptage ou fast-forward en cours)
+     */
+    bool isRunning() const { return m_step != Step::Idle; }
+
+    int ahead() const { return m_ahead; }
+    int behind() const { return m_behind; }
+
+signals:
+    void remoteStatusChanged(int ahead, int behind);
+    void fastForwarded(int commits);
+    void fetchFailed(const QString& error);
+
+private slots:
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    enum class Step {
+        Idle,
+        Fetch,
+        Count,
+        Head,
+        Status,
+        Merge
+    };
+
+    void runStep(Step step, const QStringList& arguments);
+    QString redact(const QString& text) const;
+
+    QTimer* m_timer;
+    QProcess* m_process;
+    Step m_step;
+    int m_pauseCount;
+    bool m_pendingCycle;
+
+    QString m_repoPath;
+    QString m_remoteUrl;
+    QString m_branch;
+    QString m_username;
+    QString m_token;
+    TransportProfile m_transportProfile;
+
+    int m_ahead;
+    int m_behind;
+};
+
+#endif // FETCHSCHEDULER_H
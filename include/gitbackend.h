@@ -0,0 +1,106 @@
+﻿#ifndef GITBACKEND_H
+#define GITBACKEND_H
+
+#include <QString>
+#include <QVector>
+#include <QStringList>
+
+enum class GitError;
+class GitManager;
+
+/**
+ * @struct GitStatusEntry
+ * @brief Une entree de status: codes X (index) et Y (arbre de travail) du format porcelain
+ */
+struct GitStatusEntry {
+    QString path;
+    char index = ' ';
+    char worktree = ' ';
+};
+
+/**
+ * @class GitBackend
+ * @brief Moteur des operations Git locales (status, ajout, commit, references, remote)
+ *
+ * Les operations reseau (clone, fetch, push) restent confiees au processus git.
+ * Chaque moteur renseigne sa propre erreur; GitManager la reprend a son compte.
+ */
+class GitBackend {
+public:
+    enum class Kind {
+        Process = 0, // git lance pour chaque operation
+        Libgit2      // libgit2 dans le processus (si compile avec ROGUE_HAVE_LIBGIT2)
+    };
+
+    virtual ~GitBackend() = default;
+
+    virtual Kind kind() const = 0;
+    static QString kindName(Kind kind);
+
+    /**
+     * @brief Le moteur sait-il traiter ce depot (extensions d'index, sparse checkout...) ?
+     *
+     * Sinon, GitManager se replie sur le moteur processus pour ce depot.
+     */
+    virtual bool supports(const QString& repoPath) { Q_UNUSED(repoPath); return true; }
+
+    virtual bool status(const QString& repoPath, QVector<GitStatusEntry>& entries) = 0;
+
+    /**
+     * @brief Equivalent de git add -A (limite au dossier pathspec, pris a la lettre, si non vide)
+     */
+    virtual bool addAll(const QString& repoPath, const QString& pathspec = QString()) = 0;
+
+    /**
+     * @brief Commit de l'index sur HEAD (NothingToCommit si l'arbre est inchange)
+     */
+    virtual bool commit(const QString& repoPath, const QString& message) = 0;
+
+    /**
+     * @brief Fait pointer ref sur le commit designe par target (nom ou identifiant)
+     */
+    virtual bool updateRef(const QString& repoPath, const QString& ref, const QString& target) = 0;
+
+    /**
+     * @brief Cree (create = true) ou modifie l'URL d'un remote
+     */
+    virtual bool setRemoteUrl(const QString& repoPath, const QString& name, const QString& url,
+                              bool create) = 0;
+
+    GitError lastErrorCode() const { return m_lastErrorCode; }
+    QString lastError() const { return m_lastError; }
+
+protected:
+    GitBackend();
+    void setError(GitError code, const QString& message);
+
+private:
+    GitError m_lastErrorCode;
+    QString m_lastError;
+};
+
+/**
+ * @class ProcessGitBackend
+ * @brief Moteur historique: une commande git par operation, via GitManager
+ *
+ * Profite de l'annulation, du delai maximal et des metriques de executeGitCommand.
+ */
+class ProcessGitBackend : public GitBackend {
+public:
+    explicit ProcessGitBackend(GitManager& manager);
+
+    Kind kind() const override { return Kind::Process; }
+    bool status(const QString& repoPath, QVector<GitStatusEntry>& entries) override;
+    bool addAll(const QString& repoPath, const QString& pathspec = QString()) override;
+    bool commit(const QString& repoPath, const QString& message) override;
+    bool updateRef(const QString& repoPath, const QString& ref, const QString& target) override;
+    bool setRemoteUrl(const QString& repoPath, const QString& name, const QString& url,
+                      bool create) override;
+
+private:
+    bool run(const QString& repoPath, const QStringList& arguments);
+
+    GitManager& m_manager;
+};
+
+#endif // GITBACKEND_H
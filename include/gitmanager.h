@@ -7,6 +7,21 @@
 #include <QProcess>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QByteArray>
+#include <QFile>
+#include <QVector>
+#include <QHash>
+#include "gitmetrics.h"
+#include "compactpathlist.h"
+#include "dirwalker.h"
+#include "stagingpipeline.h"
+#include "gitbackend.h"
+#include <memory>
+
+class RepoStateCache;
+class ArchiveReader;
 
 /**
  * @brief Enumeration des codes d'erreur Git
@@ -29,6 +44,59 @@ enum class GitError {
     UnknownError
 };
 
+/**
+ * @brief Profils de transport appliques aux operations reseau (push/pull/fetch)
+ */
+enum class TransportProfile {
+    Default = 0,
+    LanBulk,
+    WanLowBandwidth,
+    ManySmallFiles
+};
+
+/**
+ * @brief Delais d'attente entre deux tentatives de push
+ *
+ * Attente avant la tentative n (n >= 1): min(initialDelayMs * multiplier^(n-1), maxDelayMs).
+ */
+struct RetryPolicy {
+    int initialDelayMs = 2000;
+    double multiplier = 2.0;
+    int maxDelayMs = 10000;
+};
+
+/**
+ * @brief Resume des modifications indexees, affiche avant un push
+ *
+ * Les compteurs de lignes ne sont pas calcules ici (il faut lire le contenu
+ * de chaque fichier): voir PrePushDialog, qui les obtient en arriere-plan.
+ */
+struct ChangeSummary {
+    struct FileChange {
+        QString path;
+        QChar status;  // A, M, D, T...
+        qint64 bytes;  // Taille du nouveau contenu (0 pour une suppression)
+    };
+
+    qint64 files = 0;
+    qint64 added = 0;
+    qint64 modified = 0;
+    qint64 deleted = 0;
+    qint64 bytes = 0;               // Taille totale des nouveaux contenus
+    QVector<FileChange> largest;    // Plus gros fichiers, par taille decroissante
+};
+
+/**
+ * @brief Bilan d'une copie en miroir (voir GitManager::setMirrorMode)
+ */
+struct MirrorSummary {
+    qint64 added = 0;
+    qint64 changed = 0;
+    qint64 removed = 0;
+    qint64 unchanged = 0;
+    qint64 failed = 0; // Suppressions impossibles ou refusees (depot imbrique)
+};
+
 /**
  * @class GitManager
  * @brief Gere les operations Git avec gestion complete des erreurs
@@ -42,8 +110,66 @@ public:
 
     bool isGitAvailable();
     bool isGitRepository(const QString& repoPath);
+
+    /**
+     * @brief Verifie un nom de branche avec git check-ref-format --branch
+     */
+    bool isValidBranchName(const QString& name);
     bool initRepository(const QString& repoPath);
+
+    /**
+     * @brief Initialise le depot local a partir d'un clone partiel du depot distant
+     *
+     * Le clone utilise --filter=blob:none: l'historique et le contenu des fichiers
+     * sont recuperes a la demande. Les fichiers deja presents dans repoPath sont
+     * conserves et seront stages comme des modifications. Les identifiants ne
+     * servent que pendant l'initialisation (voir credentialEnvironment): origin
+     * est enregistre sans token des le clone.
+     * @param repoPath Chemin du depot local
+     * @param remoteUrl URL du depot distant
+     * @param branch Branche a recuperer
+     * @param username Nom d'utilisateur GitHub
+     * @param token Token d'acces personnel GitHub
+     * @param depth Profondeur d'historique (0 = historique complet)
+     * @param singleBranch Si true, ne recupere que la branche configuree
+     * @return true si succes. Si la branche n'existe pas encore sur le distant,
+     *         retourne false avec lastErrorCode() == RemoteNotFound sans emettre
+     *         operationFailed (l'appelant peut alors utiliser initRepository).
+     */
+    bool bootstrapRepository(const QString& repoPath, const QString& remoteUrl,
+                             const QString& branch, const QString& username,
+                             const QString& token, int depth = 0,
+                             bool singleBranch = true);
+    /**
+     * @brief Configure origin; ne lance aucun processus si l'URL est deja la bonne
+     */
     bool setRemoteUrl(const QString& repoPath, const QString& remoteUrl);
+
+    /**
+     * @brief URL d'origin (git config --get remote.origin.url)
+     *
+     * Lue une fois par git, qui seul interprete toute la syntaxe de la
+     * configuration, puis gardee par le cache d'etat jusqu'a la prochaine
+     * modification de .git/config.
+     * @return URL, vide si origin n'est pas configure
+     */
+    QString originUrl(const QString& repoPath);
+
+    /**
+     * @brief Commit de HEAD, lu dans le cache d'etat du depot
+     *
+     * Repli sur git rev-parse si la reference ne peut pas etre lue sans git.
+     * @return SHA complet, vide avant le premier commit ou en cas d'erreur
+     */
+    QString headCommit(const QString& repoPath);
+
+    /**
+     * @brief Etat des depots (existence, origin, branche, HEAD) lu sans git
+     *
+     * Invalide par surveillance des fichiers et apres chaque commande git
+     * qui peut le modifier.
+     */
+    RepoStateCache* repoState() const { return m_repoState; }
     bool copyAndAddFiles(const QString& repoPath, const QStringList& files,
                          const QString& subdir = QString());
     bool addFiles(const QString& repoPath, const QStringList& files);
@@ -57,6 +183,73 @@ public:
      */
     bool copyProjectRecursively(const QString& repoPath, const QStringList& paths, 
                                  bool preserveStructure = true);
+
+    /**
+     * @brief Indexe les fichiers pendant leur copie (defaut: desactive)
+     *
+     * Si le depot cible existe deja, chaque fichier copie est filtre par
+     * .gitignore puis hache et ajoute a l'index sans attendre la fin de la
+     * copie (voir StagingPipeline). addAllFiles n'a plus ensuite qu'a constater
+     * que l'index est a jour. Le pipeline attend git dans une boucle
+     * d'evenements locale: il convient aussi au thread graphique. Un repli
+     * sur addAllFiles est signale par operationWarning.
+     */
+    void setPipelinedStaging(bool enabled) { m_pipelinedStaging = enabled; }
+    bool pipelinedStaging() const { return m_pipelinedStaging; }
+
+    /**
+     * @brief Nombre de fichiers copies par le dernier copyProjectRecursively
+     *
+     * La liste elle-meme reste interne: ensureLargeRepoMode la compte pour une
+     * premiere publication, addAllFiles l'indexe apres un miroir, puis la
+     * libere. Vide apres un echec ou une annulation.
+     */
+    qsizetype copiedFileCount() const { return m_copiedFiles.size(); }
+
+    /**
+     * @brief Traitement des liens symboliques pendant la copie (defaut: FollowFiles)
+     */
+    void setSymlinkPolicy(DirWalker::SymlinkPolicy policy) { m_symlinkPolicy = policy; }
+    DirWalker::SymlinkPolicy symlinkPolicy() const { return m_symlinkPolicy; }
+
+    /**
+     * @brief Copie des entrees cachees (.env, .cache...); .git n'est jamais copie (defaut: false)
+     */
+    void setIncludeHidden(bool include) { m_includeHidden = include; }
+    bool includeHidden() const { return m_includeHidden; }
+
+    /**
+     * @brief Extrait les archives au lieu de les copier (defaut: desactive)
+     *
+     * Un fichier .zip, .tar, .tar.gz ou .tgz passe a copyProjectRecursively est
+     * lu en flux et ses entrees ecrites directement dans <cible>/<nom sans
+     * extension>, chemins et droits conserves: ni extraction temporaire, ni
+     * seconde copie. Voir ArchiveReader.
+     */
+    void setArchiveExtraction(bool enabled) { m_archiveExtraction = enabled; }
+    bool archiveExtraction() const { return m_archiveExtraction; }
+
+    /**
+     * @brief Copie des dossiers en miroir (defaut: desactive)
+     *
+     * Chaque dossier est compare a sa copie dans le depot par fusion des deux
+     * listes triees, dossier par dossier: seuls les fichiers nouveaux ou
+     * modifies (taille ou date a la seconde pres, comme rsync) sont copies, et
+     * ce qui n'existe plus a la source est supprime du depot. La date de la
+     * source est reportee sur la copie pour la comparaison suivante.
+     *
+     * Les suppressions suivent les copies dans l'indexation au fil de l'eau.
+     * Les fichiers simples et les archives restent copies sans suppression.
+     *
+     * Si le miroir est la seule copie depuis le dernier addAllFiles, celui-ci
+     * indexe exactement ses ajouts, modifications et suppressions (filtre
+     * .gitignore puis update-index --add --remove, voir StagingPipeline) au
+     * lieu de parcourir le depot; rien a faire si la copie les a deja indexes.
+     */
+    void setMirrorMode(bool enabled) { m_mirrorMode = enabled; }
+    bool mirrorMode() const { return m_mirrorMode; }
+
+    MirrorSummary lastMirrorSummary() const { return m_mirrorSummary; }
     
     /**
      * @brief Ajoute recursivement tous les fichiers d'un depot a Git
@@ -64,8 +257,151 @@ public:
      * @return true si succes
      */
     bool addAllFiles(const QString& repoPath);
+
+    /**
+     * @brief Choisit le moteur des operations locales (status, ajout, commit,
+     *        references, remote); le reseau passe toujours par git
+     * @return false si ce moteur n'est pas disponible dans cette compilation;
+     *         une valeur inconnue selectionne le moteur processus
+     */
+    bool setBackend(GitBackend::Kind kind);
+    GitBackend::Kind backendKind() const { return m_backend->kind(); }
+    static QList<GitBackend::Kind> availableBackends();
+
+    /**
+     * @brief Moteur utilise pour ce depot: le moteur choisi, ou le processus
+     *        git si le depot utilise une fonction que ce moteur ne gere pas
+     */
+    GitBackend* backendFor(const QString& repoPath);
+
+    /**
+     * @brief Sous-dossier du depot qui recoit la publication (vide = racine)
+     *
+     * Si defini, seul ce dossier est materialise localement: le clone initial
+     * est partiel et clairseme (--sparse), puis limite a ce dossier en sparse
+     * checkout mode cone. La copie se fait dans ce dossier et addAllFiles n'y
+     * parcourt que lui; commit et push restent ceux du depot entier.
+     * @return false (valeur precedente conservee) pour un chemin absolu, un
+     *         segment ".." ou ".git"
+     */
+    bool setPublishSubdirectory(const QString& subdirectory);
+    QString publishSubdirectory() const { return m_publishSubdirectory; }
+
+    /**
+     * @brief Forme normalisee d'un sous-dossier de publication
+     * @param valid false si le chemin sort du depot ou vise .git (output)
+     */
+    static QString cleanSubdirectory(const QString& subdirectory, bool* valid = nullptr);
+
+    /**
+     * @brief Indique si le sparse checkout correspond deja au sous-dossier publie
+     *
+     * Le cone entier (git sparse-checkout list) doit etre exactement ce
+     * dossier; sans sparse checkout configure, aucun processus n'est lance.
+     */
+    bool isSparseCheckoutCurrent(const QString& repoPath);
+
+    /**
+     * @brief Limite l'arbre de travail au sous-dossier publie (sparse-checkout set --cone)
+     */
+    bool ensureSparseCheckout(const QString& repoPath);
+
+    /**
+     * @brief Nombre de fichiers indexes a partir duquel le mode grand depot
+     *        est active (0 = jamais; defaut: 100000)
+     */
+    void setLargeRepoThreshold(qint64 files) { m_largeRepoThreshold = files; }
+    qint64 largeRepoThreshold() const { return m_largeRepoThreshold; }
+
+    /**
+     * @brief Active le mode grand depot si le depot depasse le seuil
+     *
+     * Configuration unique du depot: feature.manyFiles, index v4, split-index,
+     * core.untrackedCache, index.threads et, sous Windows et macOS (git 2.37+),
+     * le demon fsmonitor integre. Le nombre de fichiers est le plus grand de
+     * l'en-tete de l'index et des fichiers de la derniere copie; sans index
+     * (premier ajout), l'arbre de travail est compte jusqu'au seuil. Aucun
+     * processus quand le mode est deja actif ou que le depot est petit.
+     * Appele par addAllFiles, qui continue si la configuration echoue. Les
+     * durees de l'ajout et de la lecture de l'index qui suivent sont
+     * journalisees avec le mode de l'index, premier appel apres activation
+     * compris: la comparaison avant/apres vient des publications reelles.
+     * @return false seulement si la configuration a echoue
+     */
+    bool ensureLargeRepoMode(const QString& repoPath);
+
+    /**
+     * @brief Lit la version et le nombre d'entrees de .git/index
+     * @return false si l'index est absent ou illisible
+     */
+    static bool readIndexHeader(const QString& repoPath, int& version, qint64& entries);
     
-    bool commit(const QString& repoPath, const QString& message);
+    /**
+     * @brief Cree un commit avec les modifications indexees
+     *
+     * Si la taille des fichiers indexes depasse le seuil de decoupage, la
+     * publication est repartie en plusieurs commits successifs.
+     * @param repoPath Chemin du depot
+     * @param message Message du commit
+     * @param stagedBytes Taille deja connue de l'index (resume), -1 pour la calculer
+     * @return true si succes
+     */
+    bool commit(const QString& repoPath, const QString& message, qint64 stagedBytes = -1);
+
+    /**
+     * @brief Commite le contenu indexe sur plusieurs branches, sans checkout
+     *
+     * Un seul arbre (write-tree) pour toutes les branches. Chaque branche
+     * recoit un commit (commit-tree) sur sa tete locale, sur origin/<branche>
+     * si elle n'existe que sur le distant, ou sans parent si elle est nouvelle.
+     * Une branche dont la tete porte deja cet arbre n'en recoit pas. Toutes
+     * les references changent en une transaction (update-ref --stdin): ni
+     * l'arbre de travail ni l'index ne sont modifies.
+     * @param repoPath Chemin du depot
+     * @param branches Branches cibles
+     * @param message Message des commits
+     * @param heads Nouvelle tete de chaque branche (output, optionnel)
+     * @return true si succes; en cas d'echec, aucune reference n'est modifiee
+     */
+    bool commitToBranches(const QString& repoPath, const QStringList& branches, const QString& message,
+                          QHash<QString, QString>* heads = nullptr);
+
+    /**
+     * @brief Seuil au-dela duquel commits et push sont decoupes en lots
+     * @param bytes Taille en octets (0 = jamais de decoupage)
+     */
+    void setChunkThreshold(qint64 bytes) { m_chunkThreshold = bytes; }
+    qint64 chunkThreshold() const { return m_chunkThreshold; }
+
+    /**
+     * @brief Timeout d'une invocation de git push (par lot en mode decoupe)
+     * @param timeoutMs Timeout en millisecondes
+     */
+    void setPushTimeout(int timeoutMs) { m_pushTimeoutMs = timeoutMs; }
+    int pushTimeout() const { return m_pushTimeoutMs; }
+
+    void setRetryPolicy(const RetryPolicy& policy) { m_retryPolicy = policy; }
+    RetryPolicy retryPolicy() const { return m_retryPolicy; }
+
+    /**
+     * @brief Estime la taille du pack que le prochain push enverra
+     * @param repoPath Chemin du depot
+     * @param revisions Revisions poussees (HEAD si vide)
+     * @return Taille en octets, ou -1 si impossible a estimer
+     */
+    qint64 estimatePushSize(const QString& repoPath, const QStringList& revisions = QStringList());
+
+    /**
+     * @brief Resume les modifications indexees (git diff --cached --raw)
+     *
+     * Seules les metadonnees sont lues: nombre de fichiers par etat, taille
+     * des nouveaux blobs (cat-file --batch-check) et plus gros fichiers.
+     * @param repoPath Chemin du depot
+     * @param summary Resume (output)
+     * @param largestCount Nombre de plus gros fichiers a conserver
+     * @return true si succes
+     */
+    bool summarizeStagedChanges(const QString& repoPath, ChangeSummary& summary, int largestCount = 20);
 
     /**
      * @brief Pousse les commits avec retry automatique
@@ -80,6 +416,22 @@ public:
               const QString& username = QString(), const QString& token = QString(),
               int maxRetries = 3);
 
+    /**
+     * @brief Pousse plusieurs branches locales en un seul push atomique
+     *
+     * Les branches deja annoncees par le distant avec la meme tete sont
+     * omises; origin/<branche> est mis a jour pour les autres.
+     * @param repoPath Chemin du depot
+     * @param branches Branches a pousser
+     * @param username Nom d'utilisateur GitHub
+     * @param token Token d'acces personnel GitHub
+     * @param maxRetries Nombre maximum de tentatives (defaut: 3)
+     * @return true si succes
+     */
+    bool pushBranches(const QString& repoPath, const QStringList& branches,
+                      const QString& username = QString(), const QString& token = QString(),
+                      int maxRetries = 3);
+
     /**
      * @brief Tire les updates d'un depot distant
      * @param repoPath Chemin du depot
@@ -104,12 +456,24 @@ public:
 
     /**
      * @brief Verifie l'etat du depot distant
+     *
+     * Un seul aller-retour (git ls-remote), sans transfert d'objets: le depot
+     * est a jour si la tete distante de la branche est deja un ancetre de HEAD.
      * @param repoPath Chemin du depot
      * @param branch Branche a verifier
      * @return true si a jour
      */
     bool checkRemoteStatus(const QString& repoPath, const QString& branch);
 
+    /**
+     * @brief Duree de validite des references distantes en cache (0 = pas de cache)
+     *
+     * Le cache est alimente par ls-remote et par chaque push reussi; il sert a
+     * checkRemoteStatus et au raccourci "deja a jour" de push.
+     */
+    void setRemoteRefCacheTtl(int ttlMs) { m_remoteRefCacheTtlMs = ttlMs; }
+    void invalidateRemoteRefs(const QString& repoPath = QString());
+
     /**
      * @brief Verifie la connexion internet
      * @return true si connecte
@@ -123,14 +487,106 @@ public:
      */
     bool checkGitHubConnectivity(int timeout = 5000);
 
+    /**
+     * @brief Remplace les adresses sondees par les verifications de connectivite
+     * @param internetProbeUrls URL essayees par checkInternetConnection (une suffit)
+     * @param githubProbeUrl URL interrogee par checkGitHubConnectivity
+     */
+    void setConnectivityEndpoints(const QStringList& internetProbeUrls, const QString& githubProbeUrl);
+
+    /**
+     * @brief Sondes internet puis GitHub, utilisables depuis un thread de travail
+     *
+     * Utilise son propre gestionnaire reseau et ne modifie pas l'etat d'erreur:
+     * la publication lance ces sondes pendant l'indexation et le commit, puis
+     * les declare faites via setConnectivityVerified.
+     */
+    bool probeConnectivity(int timeout = 5000);
+
+    /**
+     * @brief Le prochain push saute ses sondes de connectivite (deja faites)
+     */
+    void setConnectivityVerified(bool verified) { m_connectivityVerified = verified; }
+
     /**
      * @brief Annule l'operation en cours
+     *
+     * Termine l'arbre de processus Git complet (groupe de processus sous Unix,
+     * job object sous Windows), interrompt les copies en cours de fichier et
+     * supprime les verrous .lock laisses par le processus interrompu.
      */
     void cancelOperation();
 
+    /**
+     * @brief Delai entre la demande d'annulation et l'arret effectif
+     * @return Latence en millisecondes, -1 si aucune annulation mesuree
+     */
+    qint64 lastCancelLatencyMs() const { return m_lastCancelLatencyMs; }
+
+    /**
+     * @brief Vrai pendant l'execution d'une commande Git
+     *
+     * Une seule commande a la fois: un appel arrive pendant l'attente d'une
+     * autre (boucle d'evenements imbriquee) est refuse.
+     */
+    bool isBusy() const { return m_processBusy; }
+
+    /**
+     * @brief Compteurs et histogrammes de latence accumules depuis le demarrage
+     */
+    GitMetrics& metrics() { return m_metrics; }
+    const GitMetrics& metrics() const { return m_metrics; }
+
+    /**
+     * @brief Selectionne le profil de transport utilise par push, pull et fetch
+     * @param profile Profil de transport
+     */
+    void setTransportProfile(TransportProfile profile) { m_transportProfile = profile; }
+    TransportProfile transportProfile() const { return m_transportProfile; }
+
+    /**
+     * @brief Construit les surcharges "-c cle=valeur" d'un profil de transport
+     * @param profile Profil de transport
+     * @return Arguments a placer avant la sous-commande Git
+     */
+    static QStringList transportConfigArgs(TransportProfile profile);
+
+    /**
+     * @brief Nom lisible d'un profil de transport
+     * @param profile Profil de transport
+     * @return Nom affichable dans l'interface
+     */
+    static QString transportProfileName(TransportProfile profile);
+
+    /**
+     * @brief Insere les identifiants dans une URL HTTPS
+     * @param remoteUrl URL du depot distant
+     * @param username Nom d'utilisateur GitHub
+     * @param token Token d'acces personnel GitHub
+     * @return L'URL authentifiee, ou remoteUrl si non HTTPS ou sans identifiants
+     */
+    static QString authenticatedUrl(const QString& remoteUrl, const QString& username,
+                                    const QString& token);
+
+    /**
+     * @brief Environnement qui transmet les identifiants par un en-tete HTTP
+     *
+     * L'en-tete Authorization est declare pour remoteUrl seulement, par
+     * GIT_CONFIG_COUNT / GIT_CONFIG_KEY_n / GIT_CONFIG_VALUE_n (git 2.31+), a
+     * la suite des entrees deja presentes dans base. Il n'est ecrit ni dans
+     * .git/config ni sur la ligne de commande, et suit les processus lances
+     * par git (blobs recuperes a la demande d'un clone partiel).
+     * @return base inchange si remoteUrl n'est pas HTTPS ou sans identifiants
+     */
+    static QProcessEnvironment credentialEnvironment(const QProcessEnvironment& base,
+                                                     const QString& remoteUrl,
+                                                     const QString& username, const QString& token);
+
     GitError lastErrorCode() const { return m_lastErrorCode; }
     QString lastError() const { return m_lastError; }
     QString lastOutput() const { return m_lastOutput; }
+    /// Sortie standard seule de la derniere commande, a utiliser pour l'analyse
+    QString lastStandardOutput() const { return m_lastStandardOutput; }
     bool isOperationRunning() const { return m_operationRunning; }
 
 signals:
@@ -138,37 +594,176 @@ signals:
     void operationSuccess(const QString& message);
     void operationFailed(const QString& error, GitError errorCode);
     void operationCancelled();
+    void operationWarning(const QString& message); // Degradation sans echec (repli...)
     void retryAttempt(int attempt, int maxAttempts);
     void connectionCheckStarted();
     void connectionCheckCompleted(bool success);
     void progressUpdate(int current, int total, const QString& currentItem);
+    void busyChanged(bool busy);
 
 private:
+    friend class TestGitManager; // Acces aux primitives internes pour les tests unitaires
+    friend class GitManagerBenchmark; // Acces aux primitives internes pour les benchmarks
+    friend class ProcessGitBackend; // Execute ses commandes via executeGitCommand
+
     bool executeGitCommand(const QString& workingDir, const QStringList& arguments,
-                          int timeoutMs = 30000);
+                          int timeoutMs = 30000, const QByteArray& standardInput = QByteArray());
+
+    /**
+     * @brief Tetes de branches distantes d'origin (git ls-remote --heads), en cache
+     * @param target "origin" ou URL authentifiee du meme depot
+     * @param heads Nom de branche -> identifiant du commit (output)
+     * @param timeoutMs Court pour le raccourci des push: un echec n'y coute qu'un push complet
+     */
+    bool remoteHeads(const QString& repoPath, const QString& target, QHash<QString, QString>& heads,
+                     int timeoutMs = 60000);
     void setError(GitError code, const QString& message);
     QString getGitErrorMessage(const QString& gitOutput);
     GitError detectErrorType(const QString& errorOutput);
     bool shouldRetry(GitError errorCode);
+    bool restoreMissingFiles(const QString& repoPath);
+    /**
+     * @brief Indexe les listes du dernier miroir (voir setMirrorMode)
+     */
+    bool stageChangeSet(const QString& repoPath);
+
+    /**
+     * @brief Mode de l'index pour le journal des durees (en-tete lu, aucun processus)
+     */
+    QString indexModeLabel(const QString& repoPath) const;
+    bool executeGitWithPathspec(const QString& repoPath, const QStringList& arguments,
+                                const QStringList& paths, int timeoutMs = 30000);
+    /**
+     * @brief Entree indexee differente de HEAD (git diff --cached --raw)
+     */
+    struct StagedEntry {
+        QString path;
+        QString mode;  // Nouveau mode, "000000" pour une suppression
+        QString blob;  // Nouvel objet, que des zeros pour une suppression
+        QChar status;
+        qint64 bytes;  // Taille du blob indexe (0: suppression ou sous-module)
+    };
+    bool readStagedEntries(const QString& repoPath, QVector<StagedEntry>& entries);
+    bool commitInChunks(const QString& repoPath, const QString& message,
+                        const QVector<StagedEntry>& entries);
+    bool pushInChunks(const QString& repoPath, const QString& target,
+                      const QString& branch, int maxRetries);
+    bool pushWithRetry(const QString& repoPath, const QStringList& args, int maxRetries);
+    QString pushTarget(const QString& repoPath, const QString& username, const QString& token);
+    bool checkPushConnectivity();
+    void attachToProcessTree();
+    void killProcessTree();
+    void recordCancelLatency();
+    QStringList existingLocks(const QString& workingDir) const;
+    void cleanupStaleLocks(const QString& workingDir, const QStringList& before, const QDateTime& since);
+    void pumpEvents();
+
+    /**
+     * @brief Copie un fichier par blocs en verifiant l'annulation
+     * @param sourcePath Fichier source
+     * @param destPath Fichier destination (remplace uniquement en cas de succes)
+     * @return true si la copie est complete
+     */
+    bool copyFileInterruptible(const QString& sourcePath, const QString& destPath);
     void waitBeforeRetry(int attemptNumber);
     
     /**
      * @brief Copie recursivement un dossier
      * @param sourcePath Chemin source
      * @param destPath Chemin destination
-     * @param copiedFiles Liste des fichiers copies (output)
+     * @param copiedFiles Fichiers copies, ajoutes relativement a copiedFiles.root() (output)
      * @return Nombre de fichiers copies
      */
     int copyDirectoryRecursively(const QString& sourcePath, const QString& destPath, 
-                                  QStringList& copiedFiles);
+                                  CompactPathList& copiedFiles);
+
+    /**
+     * @brief Aligne destPath sur sourcePath (voir setMirrorMode)
+     * @param copiedFiles Fichiers nouveaux ou modifies (output)
+     * @param removedFiles Fichiers supprimes de destPath (output)
+     * @param summary Compteurs de la synchronisation (output)
+     * @return Nombre de fichiers copies ou supprimes
+     */
+    int mirrorDirectory(const QString& sourcePath, const QString& destPath, CompactPathList& copiedFiles,
+                        CompactPathList& removedFiles, MirrorSummary& summary);
+
+    /**
+     * @brief Supprime un fichier ou un dossier de la destination d'un miroir
+     * @param removedFiles Fichiers supprimes, pour l'index (output)
+     * @return Nombre de fichiers supprimes
+     */
+    int removeMirroredEntry(const QString& dirPath, const QString& listDir, const QString& name,
+                            bool isDirectory, CompactPathList& removedFiles, MirrorSummary& summary);
+
+    /**
+     * @brief Ecrit les entrees d'une archive sous destPath, en flux
+     * @param copiedFiles Fichiers ecrits, ajoutes relativement a copiedFiles.root() (output)
+     * @param count Nombre de fichiers ecrits (output)
+     * @return false si l'archive est illisible, tronquee ou corrompue (erreur signalee)
+     *         ou si l'extraction est annulee
+     */
+    bool extractArchive(const QString& archivePath, const QString& destPath, CompactPathList& copiedFiles,
+                        int& count);
+
+    /**
+     * @brief Ecrit l'entree courante de reader par blocs en verifiant l'annulation
+     */
+    bool extractEntryInterruptible(ArchiveReader& reader, const QString& destPath,
+                                   QFile::Permissions permissions);
 
     QString m_lastError;
     QString m_lastOutput;
+    QString m_lastStandardOutput;
+    QString m_lastRawError; // Sortie d'erreur non traduite du dernier echec de git
     GitError m_lastErrorCode;
     QProcess* m_process;
     QNetworkAccessManager* m_networkManager;
     bool m_operationRunning;
     bool m_cancelRequested;
+    bool m_processBusy;
+    TransportProfile m_transportProfile;
+    qint64 m_chunkThreshold;
+    int m_pushTimeoutMs;
+    RetryPolicy m_retryPolicy;
+    QStringList m_internetProbeUrls;
+    QString m_githubProbeUrl;
+#if defined(Q_OS_WIN)
+    void* m_jobHandle; // HANDLE du job object regroupant les processus Git
+#endif
+    QElapsedTimer m_cancelTimer;
+    qint64 m_lastCancelLatencyMs;
+    QElapsedTimer m_eventPumpTimer;
+    QByteArray m_copyBuffer;
+    GitMetrics m_metrics;
+    CompactPathList m_copiedFiles;
+    CompactPathList m_removedFiles;
+    MirrorSummary m_mirrorSummary;
+
+    struct RemoteRefSnapshot {
+        QHash<QString, QString> heads;
+        QElapsedTimer age;
+    };
+    QHash<QString, RemoteRefSnapshot> m_remoteRefCache; // Par depot local (remote origin)
+    int m_remoteRefCacheTtlMs;
+    bool m_connectivityVerified; // Consomme par le prochain push
+    RepoStateCache* m_repoState;
+    std::unique_ptr<GitBackend> m_processBackend;
+    std::unique_ptr<GitBackend> m_inProcessBackend; // libgit2, cree a la demande
+    GitBackend* m_backend; // L'un des deux precedents
+    DirWalker::SymlinkPolicy m_symlinkPolicy;
+    bool m_includeHidden;
+    bool m_pipelinedStaging;
+    bool m_copyPendingAdd;   // Copie faite depuis le dernier addAllFiles
+    bool m_exactChangeSet;   // m_copiedFiles et m_removedFiles couvrent tout ce qui change
+    bool m_changeSetStaged;  // ... et sont deja dans l'index (indexation au fil de la copie)
+    bool m_archiveExtraction;
+    bool m_mirrorMode;
+    qint64 m_largeRepoThreshold;
+    bool m_largeRepoJustEnabled; // Mode active par le dernier addAllFiles
+    QString m_publishSubdirectory; // Chemin relatif, separateurs '/'
+    StagingPipeline* m_stagingPipeline; // Non nul pendant une copie indexee au fil de l'eau
+    int m_progressDone;
+    int m_progressTotal;
 };
 
 #endif // GITMANAGER_H
\ No newline at end of file
@@ -0,0 +1,120 @@
+﻿#ifndef GITMETRICS_H
+#define GITMETRICS_H
+
+#include <QString>
+#include <QMap>
+#include <QVector>
+#include <QMutex>
+#include <QJsonObject>
+#include <QElapsedTimer>
+
+enum class GitError;
+
+/**
+ * @class LatencyHistogram
+ * @brief Histogramme de latences a seaux fixes (millisecondes)
+ *
+ * Les percentiles sont estimes par la borne superieure du seau concerne.
+ */
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    void record(qint64 ms);
+
+    qint64 count() const { return m_count; }
+    qint64 sum() const { return m_sum; }
+    qint64 max() const { return m_max; }
+
+    /**
+     * @brief Estime un percentile
+     * @param p Percentile entre 0 et 1 (0.95 pour p95)
+     * @return Borne superieure du seau en ms (0 si vide)
+     */
+    qint64 percentile(double p) const;
+
+    /**
+     * @brief Bornes superieures des seaux, en ms (le dernier seau est +Inf)
+     */
+    static const QVector<qint64>& bounds();
+    const QVector<qint64>& bucketCounts() const { return m_buckets; }
+
+    QJsonObject toJson() const;
+
+private:
+    QVector<qint64> m_buckets;
+    qint64 m_count;
+    qint64 m_sum;
+    qint64 m_max;
+};
+
+/**
+ * @class GitMetrics
+ * @brief Compteurs et histogrammes d'une instance de GitManager
+ *
+ * Thread-safe: les enregistrements peuvent venir de threads de travail.
+ */
+class GitMetrics {
+public:
+    /**
+     * @brief Mesure la duree d'une etape pendant la duree de vie de l'objet
+     */
+    class StageTimer {
+    public:
+        StageTimer(GitMetrics& metrics, const QString& stage)
+            : m_metrics(metrics), m_stage(stage) { m_timer.start(); }
+        ~StageTimer() { m_metrics.recordStage(m_stage, m_timer.elapsed()); }
+        StageTimer(const StageTimer&) = delete;
+        StageTimer& operator=(const StageTimer&) = delete;
+
+    private:
+        GitMetrics& m_metrics;
+        QString m_stage;
+        QElapsedTimer m_timer;
+    };
+
+    void recordProcess(qint64 ms);
+    void recordCopiedFile(qint64 bytes);
+    void recordRetry(GitError error);
+    void recordProbe(qint64 ms, bool success);
+    void recordStage(const QString& stage, qint64 ms);
+
+    qint64 processSpawns() const;
+    qint64 bytesCopied() const;
+    qint64 filesCopied() const;
+    qint64 totalRetries() const;
+
+    void reset();
+
+    /**
+     * @brief Resume lisible affiche dans le panneau de statistiques
+     */
+    QString summary() const;
+
+    QJsonObject toJson() const;
+
+    /**
+     * @brief Format texte d'exposition Prometheus
+     */
+    QString toPrometheus() const;
+
+    bool saveJson(const QString& filePath) const;
+    bool savePrometheus(const QString& filePath) const;
+
+    static QString errorName(GitError error);
+
+private:
+    mutable QMutex m_mutex;
+
+    qint64 m_processSpawns = 0;
+    qint64 m_bytesCopied = 0;
+    qint64 m_filesCopied = 0;
+    qint64 m_probeFailures = 0;
+    QMap<int, qint64> m_retriesByError;
+
+    LatencyHistogram m_processLatency;
+    LatencyHistogram m_probeLatency;
+    QMap<QString, LatencyHistogram> m_stageDurations;
+};
+
+#endif // GITMETRICS_H
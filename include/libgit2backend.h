@@ -0,0 +1,46 @@
+﻿#ifndef LIBGIT2BACKEND_H
+#define LIBGIT2BACKEND_H
+
+#include "gitbackend.h"
+#include <QHash>
+
+struct git_repository;
+
+/**
+ * @class Libgit2Backend
+ * @brief Operations locales dans le processus avec libgit2
+ *
+ * Ni processus ni decouverte du depot a chaque appel: le depot est ouvert une
+ * fois et garde, l'index n'est relu que s'il a change sur le disque. Les
+ * erreurs sont des codes libgit2, convertis directement en GitError.
+ *
+ * libgit2 ne gere ni le split-index, ni le sparse checkout, ni fsmonitor, et
+ * n'execute ni les filtres clean/process, ni les crochets, ni commit.gpgsign:
+ * ces depots sont refuses par supports() et passent par le processus git.
+ * Disponible seulement si le projet est compile avec ROGUE_HAVE_LIBGIT2.
+ */
+class Libgit2Backend : public GitBackend {
+public:
+    Libgit2Backend();
+    ~Libgit2Backend() override;
+
+    Libgit2Backend(const Libgit2Backend&) = delete;
+    Libgit2Backend& operator=(const Libgit2Backend&) = delete;
+
+    Kind kind() const override { return Kind::Libgit2; }
+    bool supports(const QString& repoPath) override;
+    bool status(const QString& repoPath, QVector<GitStatusEntry>& entries) override;
+    bool addAll(const QString& repoPath, const QString& pathspec = QString()) override;
+    bool commit(const QString& repoPath, const QString& message) override;
+    bool updateRef(const QString& repoPath, const QString& ref, const QString& target) override;
+    bool setRemoteUrl(const QString& repoPath, const QString& name, const QString& url,
+                      bool create) override;
+
+private:
+    git_repository* open(const QString& repoPath);
+    bool fail(int code, const QString& context);
+
+    QHash<QString, git_repository*> m_repositories; // Par chemin absolu du depot
+};
+
+#endif // LIBGIT2BACKEND_H
@@ -4,7 +4,11 @@
 #include <QMainWindow>
 #include <QStringList>
 #include <QProgressDialog>
+#include <QLabel>
 #include "gitmanager.h"
+#include "fetchscheduler.h"
+#include "pushqueue.h"
+#include "statustreemodel.h"
 
 // Forward declaration de la classe UI generee par Qt Designer
 QT_BEGIN_NAMESPACE
@@ -67,6 +71,12 @@ QT_END_NAMESPACE
          */
         void on_actionConfigurer_triggered();  // Nouveau: configurer Git
 
+        /**
+         * @brief Slot declenche par l'action "Statistiques" du menu.
+         * Affiche les compteurs et latences de GitManager et permet de les exporter.
+         */
+        void on_actionStatistiques_triggered();
+
         // Slots pour les signaux de GitManager
         /**
          * @brief Slot declenche par le debut d'une operation Git.
@@ -91,11 +101,36 @@ QT_END_NAMESPACE
          */
         void onGitOperationCancelled();
 
+        /**
+         * @brief Slot declenche quand une operation Git se degrade sans echouer.
+         * @param message Message d'avertissement.
+         */
+        void onGitOperationWarning(const QString& message);
+
         // Nouveaux slots pour gestion reseau
         void onRetryAttempt(int attempt, int maxAttempts);
         void onConnectionCheckStarted();
         void onConnectionCheckCompleted(bool success);
 
+        // Slots pour la synchronisation en arriere-plan
+        /**
+         * @brief Met a jour l'indicateur d'avance/retard de la barre d'etat.
+         * @param ahead Nombre de commits locaux non pousses.
+         * @param behind Nombre de commits distants non recuperes.
+         */
+        void onRemoteStatusChanged(int ahead, int behind);
+        void onFastForwarded(int commits);
+        void onBackgroundFetchFailed(const QString& error);
+
+        /**
+         * @brief Met a jour l'indicateur de la file de push de la barre d'etat.
+         * @param pending Nombre de commits en attente de push.
+         * @param state Etat de la file.
+         */
+        void onPushQueueChanged(int pending, PushQueue::State state);
+        void onBackgroundPushed(int commits);
+        void onBackgroundPushFailed(const QString& error, bool willRetry);
+
     private:
         /**
          * @brief Ajoute un message de log dans la zone de texte dediee.
@@ -158,16 +193,41 @@ QT_END_NAMESPACE
          */
         QString getErrorMessage(GitError errorCode, const QString& details);
 
+        /**
+         * @brief Transmet la configuration courante au planificateur de fetch
+         * et a la file de push.
+         */
+        void configureFetchScheduler();
+
+        /**
+         * @brief Relance git status pour le panneau des modifications a publier.
+         */
+        void refreshStatusView();
+
+        /**
+         * @brief Desactive les actions qui lancent Git pendant une operation ou une commande.
+         */
+        void updateActionsEnabled();
+
         Ui::MainWindow* ui; // Pointeur vers l'objet de l'interface utilisateur
         GitManager* m_gitManager; // Pointeur vers le gestionnaire Git
         QProgressDialog* m_progressDialog; // Boite de dialogue de progression
+        FetchScheduler* m_fetchScheduler; // Synchronisation periodique en arriere-plan
+        PushQueue* m_pushQueue; // Commits locaux pousses en arriere-plan
+        QLabel* m_syncStatusLabel; // Indicateur d'avance/retard dans la barre d'etat
+        QLabel* m_pushQueueLabel; // Indicateur de la file de push dans la barre d'etat
+        StatusTreeModel* m_statusModel; // Fichiers modifies du depot, charges a la demande
 
         // Configuration Git
         QString m_repositoryPath;
         QString m_remoteUrl;
         QString m_branch;
+        QStringList m_extraBranches; // Branches publiees avec le meme contenu que m_branch
         QString m_githubUsername;
         QString m_githubToken;  // NOUVEAU
+        TransportProfile m_transportProfile; // Profil reseau applique a push/pull
+        int m_cloneDepth; // Profondeur du clone initial (0 = historique complet)
+        bool m_localFirst; // Publication: commit local, push confie a la file
         
         bool m_operationInProgress; // Indique si une operation Git est en cours
 };
@@ -0,0 +1,58 @@
+﻿#ifndef PREPUSHDIALOG_H
+#define PREPUSHDIALOG_H
+
+#include <QDialog>
+#include <QProcess>
+#include <QHash>
+#include "gitmanager.h"
+
+class QLabel;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+/**
+ * @class PrePushDialog
+ * @brief Confirmation avant push: resume des modifications indexees
+ *
+ * Le resume (fichiers par etat, taille, plus gros fichiers) est affiche
+ * immediatement. Les lignes ajoutees/supprimees arrivent ensuite, lues au fil
+ * de l'eau sur git diff --cached --numstat -z. Le diff d'un fichier n'est
+ * calcule que lorsque l'utilisateur deploie son entree.
+ */
+class PrePushDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    PrePushDialog(const QString& repoPath, const QString& remoteUrl, const QString& branch,
+                  const ChangeSummary& summary, QWidget* parent = nullptr);
+    ~PrePushDialog();
+
+    /**
+     * @brief Taille maximale d'un diff affiche (au-dela, il est tronque)
+     */
+    static constexpr qint64 maxDiffBytes() { return 256 * 1024; }
+
+private slots:
+    void onNumstatReadyRead();
+    void onNumstatFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onItemExpanded(QTreeWidgetItem* item);
+
+private:
+    void parseNumstat();
+    void updateLinesLabel(bool finished);
+    void stopProcess(QProcess* process);
+
+    QString m_repoPath;
+    qint64 m_totalFiles;
+    QLabel* m_linesLabel;
+    QTreeWidget* m_largestTree;
+    QProcess* m_numstat;
+    QByteArray m_numstatBuffer;
+    qint64 m_numstatFiles;
+    qint64 m_linesAdded;
+    qint64 m_linesRemoved;
+    qint64 m_binaryFiles;
+    QHash<QProcess*, QTreeWidgetItem*> m_diffRequests;
+};
+
+#endif // PREPUSHDIALOG_H
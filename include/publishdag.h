@@ -0,0 +1,73 @@
+﻿#ifndef PUBLISHDAG_H
+#define PUBLISHDAG_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <functional>
+
+/**
+ * @class PublishDag
+ * @brief Execution d'etapes dependantes (graphe oriente sans cycle)
+ *
+ * Chaque etape declare ses dependances, une verification peu couteuse
+ * (satisfied: sans processus si possible) et son execution. Une etape deja
+ * satisfaite est sautee. Les etapes "concurrent" s'executent dans le pool de
+ * threads pendant que les autres avancent dans le thread appelant; elles ne
+ * doivent donc toucher a aucun QObject de ce thread.
+ *
+ * A la premiere etape en echec, plus aucune etape n'est lancee; celles deja
+ * en cours se terminent avant le retour de run().
+ */
+class PublishDag : public QObject {
+    Q_OBJECT
+
+public:
+    struct Step {
+        QString id;
+        QStringList dependsOn;
+        std::function<bool()> satisfied; // Optionnelle; true = rien a faire
+        std::function<bool()> run;       // true = succes
+        bool concurrent = false;
+    };
+
+    enum class Outcome {
+        Pending,
+        Running,
+        Skipped,
+        Done,
+        Failed
+    };
+
+    explicit PublishDag(QObject* parent = nullptr);
+
+    void addStep(const Step& step);
+
+    /**
+     * @brief Execute le graphe
+     * @return true si toutes les etapes sont faites ou sautees
+     */
+    bool run();
+
+    Outcome outcome(const QString& id) const { return m_outcomes.value(id, Outcome::Pending); }
+    QString failedStep() const { return m_failedStep; }
+    QStringList skippedSteps() const;
+
+signals:
+    void stepStarted(const QString& id);
+    void stepSkipped(const QString& id);
+    void stepFinished(const QString& id, bool success);
+
+private:
+    bool isReady(const Step& step) const;
+    void finishStep(const QString& id, bool success);
+
+    QVector<Step> m_steps;
+    QHash<QString, Outcome> m_outcomes;
+    QString m_failedStep;
+    int m_running;
+};
+
+#endif // PUBLISHDAG_H
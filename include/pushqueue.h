@@ -0,0 +1,162 @@
+﻿#ifndef PUSHQUEUE_H
+#define PUSHQUEUE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QDateTime>
+#include <QTimer>
+#include "gitmanager.h"
+
+class QThread;
+
+/**
+ * @class PushQueue
+ * @brief File persistante des commits locaux a pousser en arriere-plan
+ *
+ * La publication commite localement et rend la main; la file pousse ensuite
+ * les commits en attente des que le reseau le permet. Les branches en attente
+ * partent ensemble par GitManager::push / pushBranches: decoupage en lots
+ * au-dela du seuil, timeout de push et mise a jour de origin/<branche>
+ * compris.
+ *
+ * Le push tourne dans un GitManager dedie, sur son propre thread: ni le
+ * push, ni son annulation ne bloquent l'interface.
+ *
+ * La file est enregistree dans le depot (.git/rogue-publisher/push-queue):
+ * elle survit a la fermeture de l'application. Un echec reseau est retente
+ * avec un delai croissant, et immediatement quand le systeme signale le
+ * retour du reseau. Un refus du distant (historique divergent, identifiants)
+ * bloque la file jusqu'au prochain pushNow().
+ */
+class PushQueue : public QObject {
+    Q_OBJECT
+
+public:
+    enum class State {
+        Idle,     // File vide ou rien a tenter
+        Pushing,  // Push en cours
+        Waiting,  // Echec reseau: nouvel essai programme
+        Blocked   // Refus du distant: attend une action de l'utilisateur
+    };
+    Q_ENUM(State)
+
+    struct Entry {
+        QString commit;
+        QString branch;
+        QString message; // Premiere ligne du message de commit
+        QDateTime queuedAt;
+    };
+
+    /**
+     * @brief Suspend la file pendant la duree de vie de l'objet
+     */
+    class PauseGuard {
+    public:
+        explicit PauseGuard(PushQueue* queue) : m_queue(queue) { m_queue->pause(); }
+        ~PauseGuard() { m_queue->resume(); }
+        PauseGuard(const PauseGuard&) = delete;
+        PauseGuard& operator=(const PauseGuard&) = delete;
+
+    private:
+        PushQueue* m_queue;
+    };
+
+    explicit PushQueue(QObject* parent = nullptr);
+    ~PushQueue();
+
+    /**
+     * @brief Configure le depot et recharge sa file enregistree
+     */
+    void setRepository(const QString& repoPath, const QString& remoteUrl);
+    void setCredentials(const QString& username, const QString& token);
+    void setTransportProfile(TransportProfile profile) { m_transportProfile = profile; }
+
+    /**
+     * @brief Seuil de decoupage et timeout de push, comme GitManager
+     */
+    void setPushLimits(qint64 chunkThreshold, int pushTimeoutMs);
+
+    /**
+     * @brief Delais entre deux essais apres un echec reseau (doubles a chaque echec)
+     */
+    void setRetryDelays(int minimumMs, int maximumMs);
+
+    /**
+     * @brief Met un commit en file et tente un push des que possible
+     * @return false si la file n'a pas pu etre enregistree
+     */
+    bool enqueue(const QString& branch, const QString& commit, const QString& message);
+
+    /**
+     * @brief Retire les entrees d'une branche deja publiee par un push direct
+     */
+    void discard(const QString& branch);
+
+    /**
+     * @brief Tente un push immediatement; debloque la file
+     */
+    void pushNow();
+
+    /**
+     * @brief Suspend les essais; un push en cours est annule puis rejoue
+     *
+     * Ne bloque pas: l'annulation est transmise au thread du push. Les appels
+     * s'imbriquent: chaque pause() doit etre suivie d'un resume().
+     */
+    void pause();
+    void resume();
+
+    QVector<Entry> entries() const { return m_entries; }
+    int pending() const { return static_cast<int>(m_entries.size()); }
+    State state() const { return m_state; }
+    QString lastError() const { return m_lastError; }
+
+    /**
+     * @brief Delai avant le prochain essai automatique, -1 si aucun n'est programme
+     */
+    int retryInMs() const { return m_retryTimer->isActive() ? m_retryTimer->remainingTime() : -1; }
+
+signals:
+    void queueChanged(int pending, PushQueue::State state);
+    void pushed(int commits);
+    void pushFailed(const QString& error, bool willRetry);
+
+private:
+    void attempt();
+    void onPushFinished(int generation, bool success, GitError code, const QString& error);
+    void notify();
+    QString storagePath() const;
+    bool load();
+    bool save();
+    void setState(State state);
+    void scheduleRetry();
+    QString redact(const QString& text) const;
+
+    QTimer* m_retryTimer;
+    QThread* m_thread;
+    GitManager* m_git; // Vit sur m_thread
+    bool m_pushing;
+    int m_generation; // Incremente a chaque changement de depot
+    State m_state;
+    int m_pauseCount;
+    bool m_pendingAttempt;
+    int m_minRetryMs;
+    int m_maxRetryMs;
+    int m_retryMs;
+
+    QString m_repoPath;
+    QString m_remoteUrl;
+    QString m_username;
+    QString m_token;
+    TransportProfile m_transportProfile;
+    qint64 m_chunkThreshold;
+    int m_pushTimeoutMs;
+
+    QVector<Entry> m_entries;
+    QVector<Entry> m_inFlight; // Dernier commit en attente de chaque branche poussee
+    QString m_lastError;
+};
+
+#endif // PUSHQUEUE_H
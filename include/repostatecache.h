@@ -0,0 +1,99 @@
+﻿#ifndef REPOSTATECACHE_H
+#define REPOSTATECACHE_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QDateTime>
+
+class QFileSystemWatcher;
+
+/**
+ * @struct RepoState
+ * @brief Faits peu changeants d'un depot, lus sans lancer git
+ *
+ * Un champ "resolved" a false signifie que la valeur n'a pas pu etre lue
+ * directement (worktree, reference symbolique...) ou n'est pas encore connue:
+ * l'appelant doit alors interroger git. L'URL d'origin n'est jamais lue ici,
+ * seulement retenue une fois fournie par git (setOriginUrl).
+ */
+struct RepoState {
+    bool isRepository = false;
+    QString originUrl;          // Vide si origin n'est pas configure
+    bool originResolved = false;
+    QString branch;             // Vide si HEAD est detachee
+    QString head;               // Commit de HEAD, vide avant le premier commit
+    bool headResolved = false;
+    bool sparseCheckout = false; // core.sparseCheckout
+};
+
+/**
+ * @class RepoStateCache
+ * @brief Etat de chaque depot, charge une fois et invalide par surveillance
+ *
+ * Les fichiers lus (.git/HEAD, .git/config, .git/packed-refs, la reference de
+ * la branche courante) et les dossiers qui les contiennent sont surveilles:
+ * une modification exterieure (terminal, autre outil) invalide l'entree.
+ * Les notifications arrivent par la boucle d'evenements; les commandes git
+ * lancees par GitManager invalident donc aussi explicitement leur depot.
+ */
+class RepoStateCache : public QObject {
+    Q_OBJECT
+
+public:
+    explicit RepoStateCache(QObject* parent = nullptr);
+
+    /**
+     * @brief Etat du depot, charge au premier appel apres invalidation
+     */
+    const RepoState& state(const QString& repoPath);
+
+    /**
+     * @brief Oublie l'etat d'un depot (tous si repoPath est vide)
+     */
+    void invalidate(const QString& repoPath = QString());
+
+    /**
+     * @brief Retient l'URL d'origin lue par git, tant que .git/config ne change pas
+     *
+     * Conservee d'une invalidation a l'autre: seule une modification de
+     * .git/config (date ou taille) oblige a la redemander.
+     */
+    void setOriginUrl(const QString& repoPath, const QString& url);
+
+    /**
+     * @brief Nombre de chargements depuis le disque (diagnostic)
+     */
+    int loadCount() const { return m_loadCount; }
+
+signals:
+    void invalidated(const QString& repoPath);
+
+private slots:
+    void onPathChanged(const QString& path);
+
+private:
+    struct Entry {
+        RepoState state;
+        QStringList watchedPaths;
+        QHash<QString, QDateTime> stamps; // Fichiers lus -> date de modification
+    };
+
+    struct KnownOrigin {
+        QDateTime modified; // .git/config au moment de la lecture
+        qint64 size = -1;
+        QString url;
+    };
+
+    RepoState load(const QString& key, Entry& entry);
+    void watch(Entry& entry, const QString& path, bool stamp = true);
+    static void readConfig(const QString& configPath, RepoState& state);
+    static QString readRef(const QString& gitDir, const QString& ref, bool& resolved);
+
+    QFileSystemWatcher* m_watcher;
+    QHash<QString, Entry> m_entries; // Par chemin absolu du depot
+    QHash<QString, KnownOrigin> m_origins; // Survit aux invalidations
+    int m_loadCount;
+};
+
+#endif // REPOSTATECACHE_H
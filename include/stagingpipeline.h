@@ -0,0 +1,86 @@
+﻿#ifndef STAGINGPIPELINE_H
+#define STAGINGPIPELINE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QProcess>
+
+/**
+ * @class StagingPipeline
+ * @brief Indexation des fichiers au fil de la copie
+ *
+ * Deux processus git restent ouverts pendant la copie et travaillent en
+ * parallele avec elle:
+ *   chemin copie -> git check-ignore --stdin (filtre .gitignore)
+ *                -> git update-index --add --remove --stdin (hachage, ecriture du blob, index)
+ *
+ * Les deux files sont bornees: au-dela de maxInFlightPaths() chemins non
+ * filtres ou de maxBufferedBytes() octets en attente d'ecriture, submit()
+ * attend que git ait rattrape la copie. La memoire reste constante quelle
+ * que soit la taille du projet.
+ *
+ * Les verdicts sont lus et les ecritures videes par la boucle d'evenements
+ * du thread appelant (readyRead / bytesWritten), jamais par waitForReadyRead:
+ * les attentes de submit() et finish() tournent dans une boucle locale, et
+ * l'interface reste servie quand le pipeline vit sur le thread graphique.
+ *
+ * Les chemins sont relatifs a la racine du depot, en UTF-8. Un chemin qui
+ * n'existe plus dans l'arbre de travail est retire de l'index.
+ */
+class StagingPipeline {
+public:
+    explicit StagingPipeline(const QString& repoPath);
+    ~StagingPipeline();
+
+    StagingPipeline(const StagingPipeline&) = delete;
+    StagingPipeline& operator=(const StagingPipeline&) = delete;
+
+    /**
+     * @brief Demarre les deux processus git
+     * @return false si l'un d'eux n'a pas pu demarrer
+     */
+    bool start();
+
+    /**
+     * @brief Transmet un fichier copie; attend (boucle locale) si git est en retard
+     */
+    void submit(const QByteArray& relativePathUtf8);
+
+    /**
+     * @brief Ferme les entrees, attend la fin de l'indexation
+     * @return true si l'index a ete ecrit sans erreur
+     */
+    bool finish(int timeoutMs = 300000);
+
+    /**
+     * @brief Tue les processus; l'index n'est pas modifie
+     */
+    void abort();
+
+    bool isRunning() const { return m_running; }
+    QString errorString() const { return m_error; }
+
+    qint64 submitted() const { return m_submitted; }
+    qint64 staged() const { return m_staged; }
+    qint64 ignored() const { return m_ignored; }
+
+    static constexpr qint64 maxInFlightPaths() { return 4096; }
+    static constexpr qint64 maxBufferedBytes() { return 1024 * 1024; }
+
+private:
+    void waitForProgress(int waitMs);
+    void parseVerdicts();
+    bool startProcess(QProcess& process, const QStringList& arguments);
+
+    QString m_repoPath;
+    QProcess m_filter;
+    QProcess m_stager;
+    QByteArray m_verdicts;
+    bool m_running;
+    QString m_error;
+    qint64 m_submitted;
+    qint64 m_staged;
+    qint64 m_ignored;
+};
+
+#endif // STAGINGPIPELINE_H
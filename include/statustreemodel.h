@@ -0,0 +1,127 @@
+﻿#ifndef STATUSTREEMODEL_H
+#define STATUSTREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <QByteArray>
+#include <QVector>
+#include <QProcess>
+#include <QElapsedTimer>
+
+/**
+ * @class StatusTreeModel
+ * @brief Arborescence des fichiers modifies d'un depot, pour QTreeView
+ *
+ * La sortie de git status --porcelain=v2 -z est lue au fil de l'eau et
+ * stockee a plat (chemins UTF-8 dans une arene, 16 octets d'index par fichier).
+ * A la fin de la lecture les chemins sont tries une fois: chaque dossier
+ * correspond alors a un intervalle contigu. Les noeuds d'un dossier ne sont
+ * crees qu'a son premier deploiement (canFetchMore/fetchMore), si bien qu'un
+ * depot de 500 000 fichiers ne coute que les dossiers reellement ouverts.
+ *
+ * Colonnes: nom, etat (ajoute, modifie, supprime...) ou nombre de fichiers
+ * pour un dossier.
+ */
+class StatusTreeModel : public QAbstractItemModel {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Etat d'un fichier, tel que publie par le prochain commit
+     */
+    enum class FileState : char {
+        Added = 'A',
+        Modified = 'M',
+        Deleted = 'D',
+        Renamed = 'R',
+        Copied = 'C',
+        TypeChanged = 'T',
+        Unmerged = 'U',
+        Untracked = '?'
+    };
+
+    explicit StatusTreeModel(QObject* parent = nullptr);
+    ~StatusTreeModel();
+
+    /**
+     * @brief Relance git status sur un depot; l'ancien contenu reste affiche
+     *        jusqu'a la fin de la lecture
+     */
+    void refresh(const QString& repoPath);
+    void clear();
+
+    bool isLoading() const { return m_process->state() != QProcess::NotRunning; }
+    qsizetype fileCount() const { return m_sorted.size(); }
+
+    /**
+     * @brief Duree du dernier git status termine (-1 si aucun n'a ete lance)
+     */
+    qint64 lastLoadMs() const { return m_lastLoadMs; }
+
+    /**
+     * @brief Chemin relatif au depot d'un index (fichier ou dossier)
+     */
+    QString relativePath(const QModelIndex& index) const;
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    static QString stateName(FileState state);
+
+signals:
+    void loadingFinished(qsizetype files);
+    void loadingFailed(const QString& error);
+
+private slots:
+    void onReadyRead();
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    struct Record {
+        quint32 offset;
+        quint32 length;
+        FileState state;
+    };
+
+    struct Node {
+        int parent;         // -1 pour la racine
+        int row;            // Rang dans le parent
+        QByteArray prefix;  // Chemin du dossier avec '/' final ("" pour la racine)
+        qint32 begin;       // Intervalle [begin, end) dans m_sorted
+        qint32 end;
+        bool fetched;
+        QVector<int> dirs;      // Sous-dossiers (indices de noeuds)
+        QVector<qint32> files;  // Fichiers directs (indices dans m_sorted)
+    };
+
+    void parseRecords(bool atEnd);
+    void appendRecord(char x, char y, const char* path, qsizetype length);
+    void buildTree();
+    void populate(int nodeId);
+    QByteArray pathOf(qint32 sortedIndex) const;
+    QByteArray nameOf(qint32 sortedIndex, const Node& node) const;
+
+    QProcess* m_process;
+
+    // Lecture en cours
+    QByteArray m_pending;
+    bool m_skipOriginalPath; // Un enregistrement "2" est suivi du chemin d'origine
+    QByteArray m_loadingArena;
+    QVector<Record> m_loadingRecords;
+    QElapsedTimer m_loadTimer;
+    qint64 m_lastLoadMs;
+
+    // Donnees affichees
+    QByteArray m_arena;
+    QVector<Record> m_records;
+    QVector<qint32> m_sorted;
+    QVector<Node> m_nodes;
+};
+
+#endif // STATUSTREEMODEL_H
@@ -0,0 +1,764 @@
+﻿#include "include/archivereader.h"
+#include <QFileInfo>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#if defined(ROGUE_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Alias de .git sous Windows: ".git" suivi de points ou d'espaces,
+ *        ou nom court "git~1" (meme regle que is_ntfs_dotgit de git)
+ */
+bool isNtfsDotGit(const QString& part) {
+    qsizetype index;
+    if (part.startsWith(".git", Qt::CaseInsensitive)) {
+        index = 4;
+    } else if (part.startsWith("git~1", Qt::CaseInsensitive)) {
+        index = 5;
+    } else {
+        return false;
+    }
+    for (; index < part.size(); ++index) {
+        if (part.at(index) != '.' && part.at(index) != ' ') {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr qint64 TarBlock = 512;
+constexpr qint64 MaxTarText = 1024 * 1024; // Noms longs GNU et en-tetes pax
+#if defined(ROGUE_HAVE_ZLIB)
+constexpr bool HaveZlib = true;
+#else
+constexpr bool HaveZlib = false;
+#endif
+
+quint16 le16(const char* data) { return qFromLittleEndian<quint16>(data); }
+quint32 le32(const char* data) { return qFromLittleEndian<quint32>(data); }
+quint64 le64(const char* data) { return qFromLittleEndian<quint64>(data); }
+
+// Champ numerique tar: octal, ou base 256 (GNU) au-dela de 8 Go
+qint64 tarNumber(const char* field, int size) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(field);
+    qint64 value = 0;
+    if (bytes[0] & 0x80) {
+        value = bytes[0] & 0x7f;
+        for (int i = 1; i < size; ++i) {
+            if (value > (std::numeric_limits<qint64>::max() >> 8)) {
+                return -1;
+            }
+            value = (value << 8) | bytes[i];
+        }
+        return value;
+    }
+
+    int i = 0;
+    while (i < size && field[i] == ' ') {
+        ++i;
+    }
+    for (; i < size && field[i] >= '0' && field[i] <= '7'; ++i) {
+        value = value * 8 + (field[i] - '0');
+    }
+    return value;
+}
+
+QByteArray tarString(const char* field, int size) {
+    return QByteArray(field, static_cast<int>(qstrnlen(field, size)));
+}
+
+bool tarChecksumOk(const char* header) {
+    // Somme des octets, le champ de la somme compte comme 8 espaces
+    // (signee chez certains anciens tar)
+    qint64 unsignedSum = 0;
+    qint64 signedSum = 0;
+    for (int i = 0; i < TarBlock; ++i) {
+        const bool checksumField = (i >= 148 && i < 156);
+        unsignedSum += checksumField ? ' ' : static_cast<unsigned char>(header[i]);
+        signedSum += checksumField ? ' ' : static_cast<signed char>(header[i]);
+    }
+    const qint64 stored = tarNumber(header + 148, 8);
+    return stored == unsignedSum || stored == signedSum;
+}
+
+QFile::Permissions permissionsFromMode(quint32 mode) {
+    // Le proprietaire garde lecture et ecriture: la copie doit pouvoir etre remplacee
+    QFile::Permissions permissions = QFile::ReadOwner | QFile::WriteOwner | QFile::ReadUser | QFile::WriteUser;
+    if (mode == 0) {
+        return permissions | QFile::ReadGroup | QFile::ReadOther;
+    }
+    if (mode & 0100) permissions |= QFile::ExeOwner | QFile::ExeUser;
+    if (mode & 0040) permissions |= QFile::ReadGroup;
+    if (mode & 0020) permissions |= QFile::WriteGroup;
+    if (mode & 0010) permissions |= QFile::ExeGroup;
+    if (mode & 0004) permissions |= QFile::ReadOther;
+    if (mode & 0002) permissions |= QFile::WriteOther;
+    if (mode & 0001) permissions |= QFile::ExeOther;
+    return permissions;
+}
+
+bool hasSuffix(const QString& fileName, const char* suffix) {
+    return fileName.endsWith(QLatin1String(suffix), Qt::CaseInsensitive);
+}
+
+} // namespace
+
+ArchiveReader::ArchiveReader(const QString& archivePath)
+    : m_file(archivePath)
+    , m_format(Format::Unknown)
+    , m_zstream(nullptr)
+    , m_streamEnded(false)
+    , m_remaining(0)
+    , m_padding(0)
+    , m_compressedLeft(0)
+    , m_method(0)
+    , m_expectedCrc(0)
+    , m_crc(0)
+    , m_checkCrc(false)
+    , m_centralOffset(0)
+    , m_centralPosition(0)
+    , m_entriesLeft(0)
+    , m_entryTotal(0)
+    , m_dataPosition(0) {
+}
+
+ArchiveReader::~ArchiveReader() {
+    endInflate();
+}
+
+ArchiveReader::Format ArchiveReader::detect(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return Format::Unknown;
+    }
+    const QByteArray head = file.read(TarBlock);
+
+    if (head.startsWith("PK\x03\x04") || head.startsWith("PK\x05\x06")) {
+        return Format::Zip;
+    }
+    const QString fileName = QFileInfo(path).fileName();
+    if (head.startsWith("\x1f\x8b") && (hasSuffix(fileName, ".tar.gz") || hasSuffix(fileName, ".tgz"))) {
+        return Format::TarGzip;
+    }
+    // ustar/GNU par leur signature, ancien format v7 par son extension
+    if (head.size() == TarBlock && tarChecksumOk(head.constData()) &&
+        (head.mid(257, 5) == "ustar" || hasSuffix(fileName, ".tar"))) {
+        return Format::Tar;
+    }
+    return Format::Unknown;
+}
+
+QString ArchiveReader::baseName(const QString& path) {
+    const QString fileName = QFileInfo(path).fileName();
+    for (const char* suffix : { ".tar.gz", ".tgz", ".tar", ".zip" }) {
+        if (hasSuffix(fileName, suffix) && fileName.size() > int(qstrlen(suffix))) {
+            return fileName.left(fileName.size() - int(qstrlen(suffix)));
+        }
+    }
+    return fileName;
+}
+
+QString ArchiveReader::sanitizePath(const QString& rawPath) {
+    QString path = rawPath;
+    path.replace('\\', '/');
+    if (path.startsWith('/') || (path.size() >= 2 && path.at(1) == ':')) {
+        return QString(); // Absolu, ou lecteur Windows
+    }
+
+    QStringList parts;
+    for (const QString& part : path.split('/', Qt::SkipEmptyParts)) {
+        if (part == ".") {
+            continue;
+        }
+        // ".." sort de la destination, ".git" (ou un alias NTFS) ecrirait dans
+        // le depot lui-meme, ':' designe un flux alternatif NTFS
+        if (part == ".." || isNtfsDotGit(part) || part.contains(':')) {
+            return QString();
+        }
+        parts << part;
+    }
+    return parts.join('/');
+}
+
+bool ArchiveReader::fail(const QString& message) {
+    if (m_error.isEmpty()) {
+        m_error = message;
+    }
+    return false;
+}
+
+bool ArchiveReader::open() {
+    m_format = detect(m_file.fileName());
+    if (m_format == Format::Unknown) {
+        return fail("Format d'archive non reconnu");
+    }
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return fail("Lecture impossible: " + m_file.errorString());
+    }
+
+    switch (m_format) {
+    case Format::Zip: return openZip();
+    case Format::TarGzip: return startInflate(true);
+    default: return true;
+    }
+}
+
+qint64 ArchiveReader::fileCount() {
+    if (m_format != Format::Zip || !m_error.isEmpty()) {
+        return -1;
+    }
+
+    // Repertoire central seul: aucune donnee n'est lue ni decompressee
+    qint64 position = m_centralOffset;
+    qint64 count = 0;
+    for (qint64 i = 0; i < m_entryTotal; ++i) {
+        ZipHeader header;
+        if (!readZipCentralHeader(position, header)) {
+            return -1;
+        }
+        bool isDirectory = false;
+        bool isSymlink = false;
+        zipMode(header, isDirectory, isSymlink);
+        if (!isDirectory && !isSymlink) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool ArchiveReader::next(Entry& entry) {
+    if (!m_error.isEmpty() || !m_file.isOpen()) {
+        return false;
+    }
+    entry = Entry();
+    return m_format == Format::Zip ? nextZipEntry(entry) : nextTarEntry(entry);
+}
+
+qint64 ArchiveReader::read(char* data, qint64 maxSize) {
+    if (!m_error.isEmpty()) {
+        return -1;
+    }
+
+    const qint64 wanted = qMin(maxSize, m_remaining);
+    if (wanted <= 0) {
+        if (m_checkCrc) {
+            m_checkCrc = false;
+            if (m_crc != m_expectedCrc) {
+                fail("Somme de controle incorrecte");
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    const qint64 read = m_format == Format::Zip ? readZipData(data, wanted) : readStream(data, wanted);
+    if (read <= 0) {
+        fail("Archive tronquee ou corrompue");
+        return -1;
+    }
+    m_remaining -= read;
+#if defined(ROGUE_HAVE_ZLIB)
+    if (m_checkCrc) {
+        m_crc = static_cast<quint32>(crc32(m_crc, reinterpret_cast<const Bytef*>(data), static_cast<uInt>(read)));
+    }
+#endif
+    return read;
+}
+
+// --- Tar
+
+qint64 ArchiveReader::readStream(char* data, qint64 maxSize) {
+    if (m_format == Format::Tar) {
+        return m_file.read(data, maxSize);
+    }
+
+#if defined(ROGUE_HAVE_ZLIB)
+    z_stream* stream = m_zstream;
+    stream->next_out = reinterpret_cast<Bytef*>(data);
+    stream->avail_out = static_cast<uInt>(maxSize);
+    while (stream->avail_out > 0) {
+        if (stream->avail_in == 0) {
+            const qint64 read = m_file.read(m_input.data(), m_input.size());
+            if (read < 0) {
+                return -1;
+            }
+            if (read == 0) {
+                break;
+            }
+            stream->next_in = reinterpret_cast<Bytef*>(m_input.data());
+            stream->avail_in = static_cast<uInt>(read);
+        }
+        if (m_streamEnded) {
+            inflateReset(stream); // Membres gzip concatenes
+            m_streamEnded = false;
+        }
+
+        const int status = inflate(stream, Z_NO_FLUSH);
+        if (status == Z_STREAM_END) {
+            m_streamEnded = true;
+        } else if (status != Z_OK) {
+            fail("Flux gzip corrompu");
+            return -1;
+        }
+    }
+    return maxSize - stream->avail_out;
+#else
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+#endif
+}
+
+qint64 ArchiveReader::readBlock(char* data, qint64 size) {
+    qint64 total = 0;
+    while (total < size) {
+        const qint64 read = readStream(data + total, size - total);
+        if (read < 0) {
+            return -1;
+        }
+        if (read == 0) {
+            break;
+        }
+        total += read;
+    }
+    return total;
+}
+
+bool ArchiveReader::skipStream(qint64 size) {
+    if (size <= 0) {
+        return true;
+    }
+    if (m_format == Format::Tar) {
+        const qint64 target = m_file.pos() + size;
+        if (target > m_file.size() || !m_file.seek(target)) {
+            return fail("Archive tronquee");
+        }
+        return true;
+    }
+
+    char scratch[16 * 1024];
+    while (size > 0) {
+        const qint64 read = readStream(scratch, qMin<qint64>(size, sizeof(scratch)));
+        if (read <= 0) {
+            return fail("Archive tronquee");
+        }
+        size -= read;
+    }
+    return true;
+}
+
+bool ArchiveReader::readTarText(qint64 size, QByteArray& text) {
+    if (size < 0 || size > MaxTarText) {
+        return fail("En-tete tar etendu trop long");
+    }
+    text.resize(static_cast<int>(size));
+    if (readBlock(text.data(), size) != size) {
+        return fail("Archive tronquee");
+    }
+    const int end = text.indexOf('\0');
+    if (end >= 0) {
+        text.truncate(end);
+    }
+    return skipStream((TarBlock - size % TarBlock) % TarBlock);
+}
+
+bool ArchiveReader::nextTarEntry(Entry& entry) {
+    // Fin de l'entree precedente, lue ou non
+    if (!skipStream(m_remaining + m_padding)) {
+        return false;
+    }
+    m_remaining = 0;
+    m_padding = 0;
+
+    QByteArray longName;
+    QByteArray paxPath;
+    qint64 paxSize = -1;
+    char header[TarBlock];
+
+    for (;;) {
+        const qint64 read = readBlock(header, TarBlock);
+        if (read == 0) {
+            return false; // Fin sans blocs nuls: tolere
+        }
+        if (read != TarBlock) {
+            return fail("Archive tronquee");
+        }
+        if (std::all_of(header, header + TarBlock, [](char byte) { return byte == 0; })) {
+            return false; // Bloc de fin
+        }
+        if (!tarChecksumOk(header)) {
+            return fail("En-tete tar corrompu");
+        }
+
+        const char type = header[156];
+        qint64 size = tarNumber(header + 124, 12);
+        if (size < 0) {
+            return fail("Taille d'entree tar invalide");
+        }
+
+        // En-tetes etendus: ils s'appliquent a l'entree qui suit
+        if (type == 'L') {
+            if (!readTarText(size, longName)) {
+                return false;
+            }
+            continue;
+        }
+        if (type == 'x') {
+            QByteArray pax;
+            if (!readTarText(size, pax)) {
+                return false;
+            }
+            // Enregistrements "<longueur> <cle>=<valeur>\n"
+            int position = 0;
+            while (position < pax.size()) {
+                const int space = pax.indexOf(' ', position);
+                bool ok = false;
+                const int length = space > position ? pax.mid(position, space - position).toInt(&ok) : 0;
+                if (!ok || length <= space - position + 1 || position + length > pax.size()) {
+                    break;
+                }
+                const QByteArray record = pax.mid(space + 1, length - (space - position) - 2);
+                const int equals = record.indexOf('=');
+                if (equals > 0) {
+                    const QByteArray key = record.left(equals);
+                    if (key == "path") {
+                        paxPath = record.mid(equals + 1);
+                    } else if (key == "size") {
+                        paxSize = record.mid(equals + 1).toLongLong();
+                    }
+                }
+                position += length;
+            }
+            continue;
+        }
+        if (type == 'g' || type == 'K') {
+            if (!skipStream(size + (TarBlock - size % TarBlock) % TarBlock)) {
+                return false;
+            }
+            continue;
+        }
+
+        QByteArray name;
+        if (!paxPath.isEmpty()) {
+            name = paxPath;
+        } else if (!longName.isEmpty()) {
+            name = longName;
+        } else {
+            name = tarString(header, 100);
+            const QByteArray prefix = tarString(header + 345, 155);
+            // Prefixe POSIX seulement: le format GNU ("ustar  ") y range d'autres champs
+            if (std::memcmp(header + 257, "ustar", 6) == 0 && !prefix.isEmpty()) {
+                name = prefix + '/' + name;
+            }
+        }
+        if (paxSize >= 0) {
+            size = paxSize;
+        }
+        longName.clear();
+        paxPath.clear();
+        paxSize = -1;
+
+        // Donnees de cette entree, sautees au prochain appel si elles ne sont pas lues
+        m_remaining = size;
+        m_padding = (TarBlock - size % TarBlock) % TarBlock;
+
+        const QString rawPath = QString::fromUtf8(name);
+        const bool isFile = (type == '0' || type == '\0' || type == '7') && !name.endsWith('/');
+        const bool isDirectory = type == '5' || ((type == '0' || type == '\0') && name.endsWith('/'));
+        if (!isFile && !isDirectory) {
+            m_errors << QString("%1: %2 ignore").arg(rawPath,
+                type == '2' ? "lien symbolique" : type == '1' ? "lien physique" : "fichier special");
+            continue;
+        }
+
+        const QString path = sanitizePath(rawPath);
+        if (path.isEmpty()) {
+            if (isFile) {
+                m_errors << rawPath + ": chemin hors de la destination, ignore";
+            }
+            continue; // Un dossier "./" ou ".." n'a rien a creer
+        }
+
+        entry.path = path;
+        entry.isDirectory = isDirectory;
+        entry.size = isDirectory ? 0 : size;
+        entry.permissions = permissionsFromMode(static_cast<quint32>(tarNumber(header + 100, 8)));
+        m_checkCrc = false;
+        return true;
+    }
+}
+
+// --- Zip
+
+bool ArchiveReader::openZip() {
+    // Enregistrement de fin: dans les 22 derniers octets, plus un commentaire eventuel
+    const qint64 fileSize = m_file.size();
+    const qint64 tail = qMin<qint64>(fileSize, 22 + 0xFFFF);
+    if (!m_file.seek(fileSize - tail)) {
+        return fail("Lecture impossible: " + m_file.errorString());
+    }
+    const QByteArray end = m_file.read(tail);
+
+    int eocd = -1;
+    for (int i = end.size() - 22; i >= 0; --i) {
+        if (std::memcmp(end.constData() + i, "PK\x05\x06", 4) == 0) {
+            eocd = i;
+            break;
+        }
+    }
+    if (eocd < 0) {
+        return fail("Repertoire central du zip introuvable");
+    }
+
+    const char* record = end.constData() + eocd;
+    quint64 entries = le16(record + 10);
+    quint64 centralSize = le32(record + 12);
+    quint64 centralOffset = le32(record + 16);
+
+    if (entries == 0xFFFF || centralSize == 0xFFFFFFFF || centralOffset == 0xFFFFFFFF) {
+        // Zip64: le localisateur precede l'enregistrement de fin
+        if (eocd < 20 || std::memcmp(record - 20, "PK\x06\x07", 4) != 0) {
+            return fail("Localisateur zip64 introuvable");
+        }
+        char zip64[56];
+        if (!m_file.seek(static_cast<qint64>(le64(record - 20 + 8))) || m_file.read(zip64, 56) != 56 ||
+            std::memcmp(zip64, "PK\x06\x06", 4) != 0) {
+            return fail("Enregistrement de fin zip64 illisible");
+        }
+        entries = le64(zip64 + 32);
+        centralSize = le64(zip64 + 40);
+        centralOffset = le64(zip64 + 48);
+    }
+
+    if (centralOffset + centralSize > static_cast<quint64>(fileSize) ||
+        entries > static_cast<quint64>(std::numeric_limits<qint64>::max())) {
+        return fail("Repertoire central hors de l'archive");
+    }
+    m_centralOffset = static_cast<qint64>(centralOffset);
+    m_centralPosition = m_centralOffset;
+    m_entryTotal = static_cast<qint64>(entries);
+    m_entriesLeft = m_entryTotal;
+    return true;
+}
+
+bool ArchiveReader::readZipCentralHeader(qint64& position, ZipHeader& header) {
+    char fixed[46];
+    if (!m_file.seek(position) || m_file.read(fixed, 46) != 46 || std::memcmp(fixed, "PK\x01\x02", 4) != 0) {
+        return fail("Repertoire central du zip corrompu");
+    }
+
+    header.host = static_cast<quint8>(le16(fixed + 4) >> 8);
+    header.flags = le16(fixed + 8);
+    header.method = le16(fixed + 10);
+    header.crc = le32(fixed + 16);
+    header.compressedSize = le32(fixed + 20);
+    header.size = le32(fixed + 24);
+    const int nameLength = le16(fixed + 28);
+    const int extraLength = le16(fixed + 30);
+    const int commentLength = le16(fixed + 32);
+    header.externalAttributes = le32(fixed + 38);
+    header.localOffset = le32(fixed + 42);
+
+    header.name = m_file.read(nameLength);
+    const QByteArray extra = m_file.read(extraLength);
+    if (header.name.size() != nameLength || extra.size() != extraLength) {
+        return fail("Repertoire central du zip tronque");
+    }
+
+    // Champ zip64 (0x0001): seules les valeurs saturees y figurent, dans cet ordre
+    for (int offset = 0; offset + 4 <= extra.size();) {
+        const int id = le16(extra.constData() + offset);
+        const int length = le16(extra.constData() + offset + 2);
+        if (id == 0x0001) {
+            int field = offset + 4;
+            const int fieldEnd = qMin(offset + 4 + length, int(extra.size()));
+            for (quint64* value : { &header.size, &header.compressedSize, &header.localOffset }) {
+                if (*value == 0xFFFFFFFF && field + 8 <= fieldEnd) {
+                    *value = le64(extra.constData() + field);
+                    field += 8;
+                }
+            }
+        }
+        offset += 4 + length;
+    }
+
+    position += 46 + nameLength + extraLength + commentLength;
+    return true;
+}
+
+quint32 ArchiveReader::zipMode(const ZipHeader& header, bool& isDirectory, bool& isSymlink) {
+    // Mode Unix dans les 16 bits hauts des attributs externes
+    const quint32 mode = header.host == 3 ? header.externalAttributes >> 16 : 0;
+    isSymlink = (mode & 0170000) == 0120000;
+    isDirectory = header.name.endsWith('/') || (mode & 0170000) == 0040000 ||
+                  (header.host == 0 && (header.externalAttributes & 0x10));
+    return mode & 07777;
+}
+
+bool ArchiveReader::nextZipEntry(Entry& entry) {
+    endInflate();
+    m_remaining = 0;
+    m_checkCrc = false;
+
+    while (m_entriesLeft > 0) {
+        --m_entriesLeft;
+        ZipHeader header;
+        if (!readZipCentralHeader(m_centralPosition, header)) {
+            return false;
+        }
+
+        // Bit 11: nom en UTF-8, sinon page de code de l'outil (approchee par Latin-1)
+        const QString rawPath = (header.flags & 0x0800) ? QString::fromUtf8(header.name)
+                                                        : QString::fromLatin1(header.name);
+        bool isDirectory = false;
+        bool isSymlink = false;
+        const quint32 mode = zipMode(header, isDirectory, isSymlink);
+        if (isSymlink) {
+            m_errors << rawPath + ": lien symbolique ignore";
+            continue;
+        }
+        if (header.flags & 0x0001) {
+            m_errors << rawPath + ": entree chiffree ignoree";
+            continue;
+        }
+
+        const QString path = sanitizePath(rawPath);
+        if (path.isEmpty()) {
+            if (!isDirectory) {
+                m_errors << rawPath + ": chemin hors de la destination, ignore";
+            }
+            continue;
+        }
+
+        entry.path = path;
+        entry.isDirectory = isDirectory;
+        entry.permissions = permissionsFromMode(mode);
+        if (isDirectory) {
+            return true;
+        }
+
+        if (header.method != 0 && (header.method != 8 || !HaveZlib)) {
+            m_errors << QString("%1: methode de compression %2 non geree, ignore").arg(rawPath).arg(header.method);
+            continue;
+        }
+
+        // En-tete local de longueur variable; les tailles fiables sont celles
+        // du repertoire central (descripteur de donnees possible)
+        char local[30];
+        if (!m_file.seek(static_cast<qint64>(header.localOffset)) || m_file.read(local, 30) != 30 ||
+            std::memcmp(local, "PK\x03\x04", 4) != 0) {
+            return fail("En-tete local du zip corrompu: " + rawPath);
+        }
+        m_dataPosition = static_cast<qint64>(header.localOffset) + 30 + le16(local + 26) + le16(local + 28);
+        m_compressedLeft = static_cast<qint64>(header.compressedSize);
+        m_remaining = static_cast<qint64>(header.size);
+        m_method = header.method;
+        m_expectedCrc = header.crc;
+        m_crc = 0;
+#if defined(ROGUE_HAVE_ZLIB)
+        m_checkCrc = true;
+#endif
+        if (m_method == 8 && !startInflate(false)) {
+            return false;
+        }
+
+        entry.size = m_remaining;
+        return true;
+    }
+    return false;
+}
+
+qint64 ArchiveReader::readZipData(char* data, qint64 maxSize) {
+    // Le repertoire central est lu ailleurs dans le fichier: repositionnement a chaque bloc
+    if (m_method == 0) {
+        const qint64 wanted = qMin(maxSize, m_compressedLeft);
+        if (wanted <= 0 || !m_file.seek(m_dataPosition)) {
+            return wanted <= 0 ? 0 : -1;
+        }
+        const qint64 read = m_file.read(data, wanted);
+        if (read > 0) {
+            m_dataPosition += read;
+            m_compressedLeft -= read;
+        }
+        return read;
+    }
+
+#if defined(ROGUE_HAVE_ZLIB)
+    z_stream* stream = m_zstream;
+    stream->next_out = reinterpret_cast<Bytef*>(data);
+    stream->avail_out = static_cast<uInt>(maxSize);
+    while (stream->avail_out > 0 && !m_streamEnded) {
+        if (stream->avail_in == 0) {
+            const qint64 wanted = qMin<qint64>(m_input.size(), m_compressedLeft);
+            if (wanted <= 0) {
+                break;
+            }
+            if (!m_file.seek(m_dataPosition)) {
+                return -1;
+            }
+            const qint64 read = m_file.read(m_input.data(), wanted);
+            if (read <= 0) {
+                return -1;
+            }
+            m_dataPosition += read;
+            m_compressedLeft -= read;
+            stream->next_in = reinterpret_cast<Bytef*>(m_input.data());
+            stream->avail_in = static_cast<uInt>(read);
+        }
+
+        const int status = inflate(stream, Z_NO_FLUSH);
+        if (status == Z_STREAM_END) {
+            m_streamEnded = true;
+        } else if (status != Z_OK) {
+            fail("Donnees deflate corrompues");
+            return -1;
+        }
+    }
+    return maxSize - stream->avail_out;
+#else
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+#endif
+}
+
+// --- Decompression
+
+bool ArchiveReader::startInflate(bool gzip) {
+#if defined(ROGUE_HAVE_ZLIB)
+    endInflate();
+    if (m_input.isEmpty()) {
+        m_input.resize(bufferSize());
+    }
+
+    // gzip: en-tete et somme gzip geres par zlib; zip: deflate brut
+    m_zstream = new z_stream;
+    std::memset(m_zstream, 0, sizeof(z_stream));
+    if (inflateInit2(m_zstream, gzip ? MAX_WBITS + 16 : -MAX_WBITS) != Z_OK) {
+        delete m_zstream;
+        m_zstream = nullptr;
+        return fail("Initialisation de zlib impossible");
+    }
+    m_streamEnded = false;
+    return true;
+#else
+    Q_UNUSED(gzip);
+    return fail("Archive compressee: compile sans zlib");
+#endif
+}
+
+void ArchiveReader::endInflate() {
+#if defined(ROGUE_HAVE_ZLIB)
+    if (m_zstream) {
+        inflateEnd(m_zstream);
+        delete m_zstream;
+        m_zstream = nullptr;
+    }
+#endif
+}
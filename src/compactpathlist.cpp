@@ -0,0 +1,106 @@
+﻿#include "include/compactpathlist.h"
+#include <QDir>
+
+CompactPathList::CompactPathList(const QString& root)
+    : m_root(root) {
+}
+
+CompactPathList::Span CompactPathList::store(const QByteArray& utf8) {
+    Span span { static_cast<quint32>(m_arena.size()), static_cast<quint32>(utf8.size()) };
+    m_arena.append(utf8);
+    return span;
+}
+
+quint32 CompactPathList::internDirectory(const QString& relativeDir) {
+    if (m_hasLastDir && relativeDir == m_lastDir) {
+        return m_lastDirIndex;
+    }
+
+    QByteArray utf8 = relativeDir.toUtf8();
+    auto it = m_dirLookup.constFind(utf8);
+    quint32 index;
+    if (it != m_dirLookup.constEnd()) {
+        index = it.value();
+    } else {
+        index = static_cast<quint32>(m_dirs.size());
+        m_dirs.append(store(utf8));
+        m_dirLookup.insert(utf8, index);
+    }
+
+    m_lastDir = relativeDir;
+    m_lastDirIndex = index;
+    m_hasLastDir = true;
+    return index;
+}
+
+void CompactPathList::append(const QString& relativeDir, const QString& fileName) {
+    quint32 dirIndex = internDirectory(relativeDir);
+    m_files.append(FileEntry { dirIndex, store(fileName.toUtf8()) });
+}
+
+void CompactPathList::appendPath(const QString& relativePath) {
+    int slash = relativePath.lastIndexOf('/');
+    if (slash < 0) {
+        append(QString(), relativePath);
+    } else {
+        append(relativePath.left(slash), relativePath.mid(slash + 1));
+    }
+}
+
+QByteArray CompactPathList::relativePathUtf8(qsizetype index) const {
+    const FileEntry& file = m_files.at(index);
+    const Span& dir = m_dirs.at(file.dirIndex);
+
+    QByteArray path;
+    path.reserve(dir.length + 1 + file.name.length);
+    if (dir.length > 0) {
+        path.append(m_arena.constData() + dir.offset, dir.length);
+        path.append('/');
+    }
+    path.append(m_arena.constData() + file.name.offset, file.name.length);
+    return path;
+}
+
+QString CompactPathList::relativePath(qsizetype index) const {
+    return QString::fromUtf8(relativePathUtf8(index));
+}
+
+QString CompactPathList::absolutePath(qsizetype index) const {
+    return QDir(m_root).filePath(relativePath(index));
+}
+
+void CompactPathList::squeeze() {
+    m_dirLookup = QHash<QByteArray, quint32>();
+    m_lastDir.clear();
+    m_hasLastDir = false;
+    m_arena.squeeze();
+    m_dirs.squeeze();
+    m_files.squeeze();
+}
+
+void CompactPathList::clear() {
+    m_arena.clear();
+    m_dirs.clear();
+    m_files.clear();
+    m_dirLookup.clear();
+    m_lastDir.clear();
+    m_hasLastDir = false;
+}
+
+void CompactPathList::truncate(qsizetype size) {
+    if (size < m_files.size()) {
+        m_files.resize(size);
+    }
+}
+
+qsizetype CompactPathList::memoryUsage() const {
+    qsizetype lookup = 0;
+    for (auto it = m_dirLookup.constBegin(); it != m_dirLookup.constEnd(); ++it) {
+        lookup += it.key().capacity() + static_cast<qsizetype>(sizeof(quint32));
+    }
+
+    return m_arena.capacity()
+        + m_dirs.capacity() * static_cast<qsizetype>(sizeof(Span))
+        + m_files.capacity() * static_cast<qsizetype>(sizeof(FileEntry))
+        + lookup;
+}
@@ -0,0 +1,343 @@
+﻿#include "include/dirwalker.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(Q_OS_LINUX)
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace {
+
+#if defined(Q_OS_LINUX)
+// Format des enregistrements renvoyes par getdents64(2)
+struct LinuxDirent64 {
+    quint64 d_ino;
+    qint64 d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+#endif
+
+bool isDotOrDotDot(const char* name) {
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+#if defined(Q_OS_UNIX)
+void fillFileMetadata(DirWalker::Entry& entry, const struct stat& st) {
+    entry.size = static_cast<qint64>(st.st_size);
+#if defined(Q_OS_DARWIN)
+    entry.modifiedMSecs = static_cast<qint64>(st.st_mtimespec.tv_sec) * 1000 + st.st_mtimespec.tv_nsec / 1000000;
+#else
+    entry.modifiedMSecs = static_cast<qint64>(st.st_mtim.tv_sec) * 1000 + st.st_mtim.tv_nsec / 1000000;
+#endif
+}
+#endif
+
+bool isDotGit(const char* name) {
+    return name[0] == '.' && (name[1] == 'g' || name[1] == 'G') && (name[2] == 'i' || name[2] == 'I') &&
+           (name[3] == 't' || name[3] == 'T') && name[4] == '\0';
+}
+
+} // namespace
+
+DirWalker::DirWalker(const QString& rootPath, SymlinkPolicy policy, bool includeHidden)
+    : m_rootPath(QDir::cleanPath(rootPath))
+    , m_policy(policy)
+    , m_includeHidden(includeHidden)
+    , m_valid(false)
+    , m_foundGitDir(false)
+    , m_recursive(true)
+    , m_fileMetadata(false)
+    , m_reportSymlinks(false)
+    , m_batchIndex(0)
+#if defined(Q_OS_UNIX)
+    , m_rootFd(-1)
+#endif
+{
+#if defined(Q_OS_UNIX)
+    m_rootFd = ::open(QFile::encodeName(m_rootPath).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    struct stat st;
+    if (m_rootFd >= 0 && ::fstat(m_rootFd, &st) == 0) {
+        markVisited(static_cast<quint64>(st.st_dev), static_cast<quint64>(st.st_ino));
+        m_valid = true;
+    }
+#else
+    QFileInfo rootInfo(m_rootPath);
+    if (rootInfo.isDir()) {
+        markVisited(0, qHash(rootInfo.canonicalFilePath()));
+        m_valid = true;
+    }
+#endif
+
+    if (m_valid) {
+        m_stack.append(PendingDir { QString(), false });
+    }
+}
+
+DirWalker::~DirWalker() {
+#if defined(Q_OS_UNIX)
+    if (m_rootFd >= 0) {
+        ::close(m_rootFd);
+    }
+#endif
+}
+
+bool DirWalker::next(Entry& entry) {
+    while (m_batchIndex >= m_batch.size()) {
+        if (m_stack.isEmpty()) {
+            return false;
+        }
+
+        m_batch.clear();
+        m_batchIndex = 0;
+        PendingDir dir = m_stack.takeLast();
+        readDirectory(dir);
+    }
+
+    entry = m_batch.at(m_batchIndex++);
+    return true;
+}
+
+QString DirWalker::absolutePath(const Entry& entry) const {
+    return m_rootPath + '/' + entry.relativePath();
+}
+
+qint64 DirWalker::countFiles(const QString& path, SymlinkPolicy policy, bool includeHidden, qint64 limit) {
+    QFileInfo info(path);
+    if (!info.isDir()) {
+        return info.isFile() ? 1 : 0;
+    }
+
+    DirWalker walker(path, policy, includeHidden);
+    Entry entry;
+    qint64 count = 0;
+    while (walker.next(entry)) {
+        if (!entry.isDirectory && ++count == limit) {
+            break;
+        }
+    }
+    return count;
+}
+
+bool DirWalker::isGitDirName(const QString& name) {
+    return name.compare(".git", Qt::CaseInsensitive) == 0;
+}
+
+bool DirWalker::markVisited(quint64 device, quint64 inode) {
+    QPair<quint64, quint64> key(device, inode);
+    if (m_visited.contains(key)) {
+        return false;
+    }
+    m_visited.insert(key);
+    return true;
+}
+
+DirWalker::Entry& DirWalker::addEntry(const QString& relativeDir, const QString& name, bool isDirectory,
+                                     bool viaSymlink) {
+    Entry entry;
+    entry.relativeDir = relativeDir;
+    entry.name = name;
+    entry.isDirectory = isDirectory;
+
+    if (isDirectory && m_recursive) {
+        m_stack.append(PendingDir { entry.relativePath(), viaSymlink });
+    }
+    m_batch.append(entry);
+    return m_batch.last();
+}
+
+#if defined(Q_OS_UNIX)
+
+bool DirWalker::readDirectory(const PendingDir& dir) {
+    int fd;
+    if (dir.relativePath.isEmpty()) {
+        fd = ::dup(m_rootFd);
+    } else {
+        // O_NOFOLLOW: un dossier remplace par un lien entre la lecture et l'ouverture n'est pas suivi
+        int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC | (dir.viaSymlink ? 0 : O_NOFOLLOW);
+        fd = ::openat(m_rootFd, QFile::encodeName(dir.relativePath).constData(), flags);
+    }
+
+    if (fd < 0) {
+        m_errors << "Dossier illisible: " + dir.relativePath;
+        return false;
+    }
+
+    if (!dir.relativePath.isEmpty()) {
+        struct stat st;
+        if (::fstat(fd, &st) != 0 ||
+            !markVisited(static_cast<quint64>(st.st_dev), static_cast<quint64>(st.st_ino))) {
+            m_errors << "Cycle ignore: " + dir.relativePath;
+            ::close(fd);
+            return false;
+        }
+    }
+
+    auto handle = [this, fd, &dir](const char* rawName, unsigned char type) {
+        if (isDotGit(rawName)) {
+            m_foundGitDir = true;
+            return;
+        }
+        if (isDotOrDotDot(rawName) || (!m_includeHidden && rawName[0] == '.')) {
+            return;
+        }
+
+        struct stat st;
+        bool statted = false;
+        if (type == DT_UNKNOWN) {
+            // Systeme de fichiers sans d_type: un stat sans suivre les liens
+            if (::fstatat(fd, rawName, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+                return;
+            }
+            statted = true;
+            type = S_ISREG(st.st_mode) ? DT_REG : S_ISDIR(st.st_mode) ? DT_DIR
+                 : S_ISLNK(st.st_mode) ? DT_LNK : DT_UNKNOWN;
+        }
+
+        QString name = QFile::decodeName(rawName);
+        if (type == DT_REG) {
+            Entry& added = addEntry(dir.relativePath, name, false, false);
+            if (m_fileMetadata && (statted || ::fstatat(fd, rawName, &st, AT_SYMLINK_NOFOLLOW) == 0)) {
+                fillFileMetadata(added, st);
+            }
+        } else if (type == DT_DIR) {
+            addEntry(dir.relativePath, name, true, dir.viaSymlink);
+        } else if (type == DT_LNK && m_reportSymlinks) {
+            addEntry(dir.relativePath, name, false, false).isSymlink = true;
+        } else if (type == DT_LNK && m_policy != SymlinkPolicy::Skip) {
+            if (::fstatat(fd, rawName, &st, 0) != 0) {
+                return; // Lien casse
+            }
+            if (S_ISREG(st.st_mode)) {
+                Entry& added = addEntry(dir.relativePath, name, false, false);
+                if (m_fileMetadata) {
+                    fillFileMetadata(added, st);
+                }
+            } else if (S_ISDIR(st.st_mode) && m_policy == SymlinkPolicy::FollowAll) {
+                // Lien vers un ancetre deja parcouru: cycle
+                if (m_visited.contains(qMakePair(static_cast<quint64>(st.st_dev),
+                                                 static_cast<quint64>(st.st_ino)))) {
+                    m_errors << "Cycle ignore: " + (dir.relativePath.isEmpty() ? name
+                                                    : dir.relativePath + '/' + name);
+                    return;
+                }
+                addEntry(dir.relativePath, name, true, true);
+            }
+        }
+    };
+
+#if defined(Q_OS_LINUX)
+    if (m_buffer.isEmpty()) {
+        m_buffer.resize(64 * 1024);
+    }
+
+    while (true) {
+        long read = ::syscall(SYS_getdents64, fd, m_buffer.data(), m_buffer.size());
+        if (read <= 0) {
+            if (read < 0) {
+                m_errors << "Lecture interrompue: " + dir.relativePath;
+            }
+            break;
+        }
+
+        for (long offset = 0; offset < read;) {
+            const LinuxDirent64* record = reinterpret_cast<const LinuxDirent64*>(m_buffer.constData() + offset);
+            handle(record->d_name, record->d_type);
+            offset += record->d_reclen;
+        }
+    }
+    ::close(fd);
+#else
+    DIR* handleDir = ::fdopendir(fd);
+    if (!handleDir) {
+        ::close(fd);
+        m_errors << "Dossier illisible: " + dir.relativePath;
+        return false;
+    }
+    while (struct dirent* current = ::readdir(handleDir)) {
+        handle(current->d_name, current->d_type);
+    }
+    ::closedir(handleDir);
+#endif
+
+    return true;
+}
+
+#else
+
+bool DirWalker::readDirectory(const PendingDir& dir) {
+    QString absoluteDir = dir.relativePath.isEmpty() ? m_rootPath : m_rootPath + '/' + dir.relativePath;
+
+    if (dir.viaSymlink) {
+        // Pas d'inode expose sans ouvrir le dossier: le chemin canonique en tient lieu
+        if (!markVisited(0, qHash(QFileInfo(absoluteDir).canonicalFilePath()))) {
+            m_errors << "Cycle ignore: " + dir.relativePath;
+            return false;
+        }
+    }
+
+    WIN32_FIND_DATAW data;
+    QString pattern = QDir::toNativeSeparators(absoluteDir) + "\\*";
+    HANDLE find = FindFirstFileExW(reinterpret_cast<const wchar_t*>(pattern.utf16()),
+                                   FindExInfoBasic, &data, FindExSearchNameMatch,
+                                   nullptr, FIND_FIRST_EX_LARGE_FETCH);
+    if (find == INVALID_HANDLE_VALUE) {
+        m_errors << "Dossier illisible: " + dir.relativePath;
+        return false;
+    }
+
+    do {
+        QString name = QString::fromWCharArray(data.cFileName);
+        if (isGitDirName(name)) {
+            m_foundGitDir = true;
+            continue;
+        }
+        if (name == "." || name == "..") {
+            continue;
+        }
+        if (!m_includeHidden && (name.startsWith('.') || (data.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN))) {
+            continue;
+        }
+
+        bool isDirectory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        bool isLink = (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
+
+        if (isLink && m_reportSymlinks) {
+            addEntry(dir.relativePath, name, false, false).isSymlink = true;
+        } else if (!isLink) {
+            Entry& added = addEntry(dir.relativePath, name, isDirectory, dir.viaSymlink);
+            if (m_fileMetadata && !isDirectory) {
+                // Taille et date deja fournies par FindFirstFileEx (FILETIME: 100 ns depuis 1601)
+                added.size = (static_cast<qint64>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+                const qint64 ticks = (static_cast<qint64>(data.ftLastWriteTime.dwHighDateTime) << 32) |
+                                     data.ftLastWriteTime.dwLowDateTime;
+                added.modifiedMSecs = ticks / 10000 - Q_INT64_C(11644473600000);
+            }
+        } else if (m_policy == SymlinkPolicy::FollowAll ||
+                   (m_policy == SymlinkPolicy::FollowFiles && !isDirectory)) {
+            Entry& added = addEntry(dir.relativePath, name, isDirectory, true);
+            if (m_fileMetadata && !isDirectory) {
+                // Donnees de FindFirstFileEx: celles du lien, pas de sa cible
+                const QFileInfo target(absoluteDir + '/' + name);
+                added.size = target.size();
+                added.modifiedMSecs = target.lastModified().toMSecsSinceEpoch();
+            }
+        }
+    } while (FindNextFileW(find, &data));
+
+    FindClose(find);
+    return true;
+}
+
+#endif
@@ -0,0 +1,227 @@
+﻿#include "include/fetchscheduler.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QProcessEnvironment>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+FetchScheduler::FetchScheduler(QObject* parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_process(new QProcess(this))
+    , m_step(Step::Idle)
+    , m_pauseCount(0)
+    , m_pendingCycle(false)
+    , m_transportProfile(TransportProfile::Default)
+    , m_ahead(0)
+    , m_behind(0) {
+    m_timer->setInterval(5 * 60 * 1000);
+    connect(m_timer, &QTimer::timeout, this, &FetchScheduler::fetchNow);
+    connect(m_process, &QProcess::finished, this, &FetchScheduler::onProcessFinished);
+    connect(m_process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            m_step = Step::Idle;
+            emit fetchFailed("Impossible de demarrer Git pour la synchronisation.");
+        }
+    });
+
+    // Jamais d'invite d'identifiants depuis un processus d'arriere-plan
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert("GIT_TERMINAL_PROMPT", "0");
+    m_process->setProcessEnvironment(env);
+
+    // Priorite basse: la synchronisation ne doit pas ralentir l'utilisateur
+#if defined(Q_OS_WIN)
+    m_process->setCreateProcessArgumentsModifier([](QProcess::CreateProcessArguments* args) {
+        args->flags |= BELOW_NORMAL_PRIORITY_CLASS;
+    });
+#elif defined(Q_OS_UNIX)
+    m_process->setChildProcessModifier([]() {
+        ::setpriority(PRIO_PROCESS, 0, 10);
+    });
+#endif
+}
+
+FetchScheduler::~FetchScheduler() {
+    if (m_process->state() != QProcess::NotRunning) {
+        m_process->kill();
+        m_process->waitForFinished();
+    }
+}
+
+void FetchScheduler::setRepository(const QString& repoPath, const QString& remoteUrl,
+                                   const QString& branch) {
+    if (repoPath != m_repoPath || remoteUrl != m_remoteUrl || branch != m_branch) {
+        m_repoPath = repoPath;
+        m_remoteUrl = remoteUrl;
+        m_branch = branch;
+        m_ahead = 0;
+        m_behind = 0;
+    }
+}
+
+void FetchScheduler::setCredentials(const QString& username, const QString& token) {
+    m_username = username;
+    m_token = token;
+}
+
+void FetchScheduler::setInterval(int intervalMs) {
+    m_timer->setInterval(intervalMs);
+}
+
+void FetchScheduler::start() {
+    m_timer->start();
+    fetchNow();
+}
+
+void FetchScheduler::stop() {
+    m_timer->stop();
+    m_pendingCycle = false;
+    if (m_process->state() != QProcess::NotRunning) {
+        m_process->kill();
+        m_process->waitForFinished(1000);
+    }
+}
+
+void FetchScheduler::fetchNow() {
+    if (m_pauseCount > 0) {
+        m_pendingCycle = true;
+        return;
+    }
+
+    if (m_step != Step::Idle) {
+        return;
+    }
+
+    if (m_repoPath.isEmpty() || m_remoteUrl.isEmpty() || m_branch.isEmpty() ||
+        !QFileInfo::exists(QDir(m_repoPath).filePath(".git"))) {
+        return;
+    }
+
+    m_pendingCycle = false;
+
+    // Refspec explicite: l'URL authentifiee ne met pas a jour origin/* d'elle-meme
+    QStringList args = GitManager::transportConfigArgs(m_transportProfile);
+    args << "fetch" << "--quiet" << "--no-tags"
+         << GitManager::authenticatedUrl(m_remoteUrl, m_username, m_token)
+         << QString("+refs/heads/%1:refs/remotes/origin/%1").arg(m_branch);
+
+    runStep(Step::Fetch, args);
+}
+
+void FetchScheduler::pause() {
+    ++m_pauseCount;
+
+    if (m_step == Step::Merge) {
+        // Le fast-forward est local et court: on le laisse se terminer
+        m_process->waitForFinished(5000);
+    } else if (m_step != Step::Idle) {
+        m_process->kill();
+        m_process->waitForFinished(1000);
+    }
+}
+
+void FetchScheduler::resume() {
+    if (m_pauseCount == 0) {
+        return;
+    }
+
+    if (--m_pauseCount == 0 && m_pendingCycle) {
+        QTimer::singleShot(0, this, &FetchScheduler::fetchNow);
+    }
+}
+
+void FetchScheduler::runStep(Step step, const QStringList& arguments) {
+    m_step = step;
+    m_process->setWorkingDirectory(m_repoPath);
+    m_process->start("git", arguments);
+}
+
+void FetchScheduler::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    Step step = m_step;
+    m_step = Step::Idle;
+
+    QString output = QString::fromUtf8(m_process->readAllStandardOutput()).trimmed();
+    QString errorOutput = QString::fromUtf8(m_process->readAllStandardError()).trimmed();
+    bool success = (exitStatus == QProcess::NormalExit && exitCode == 0);
+
+    if (step == Step::Merge) {
+        if (success) {
+            int commits = m_behind;
+            m_behind = 0;
+            emit fastForwarded(commits);
+            emit remoteStatusChanged(m_ahead, m_behind);
+        } else {
+            emit fetchFailed(redact(errorOutput));
+        }
+        return;
+    }
+
+    // Une operation a commence entre-temps: le cycle sera rejoue a la reprise
+    if (m_pauseCount > 0) {
+        m_pendingCycle = true;
+        return;
+    }
+
+    switch (step) {
+        case Step::Fetch:
+            if (!success) {
+                emit fetchFailed(redact(errorOutput));
+                return;
+            }
+            // Branche suivie, pas HEAD: l'arbre de travail peut etre sur une autre
+            runStep(Step::Count, QStringList() << "rev-list" << "--left-right" << "--count"
+                    << QString("refs/heads/%1...refs/remotes/origin/%1").arg(m_branch));
+            return;
+
+        case Step::Count: {
+            // Echec attendu si la branche n'existe pas encore (depot sans commit)
+            QStringList counts = output.split('\t');
+            if (!success || counts.size() != 2) {
+                return;
+            }
+
+            m_ahead = counts.at(0).toInt();
+            m_behind = counts.at(1).toInt();
+            emit remoteStatusChanged(m_ahead, m_behind);
+
+            if (m_behind > 0 && m_ahead == 0) {
+                runStep(Step::Head, QStringList() << "symbolic-ref" << "-q" << "HEAD");
+            }
+            return;
+        }
+
+        case Step::Head:
+            // merge --ff-only avance la branche courante: seulement si c'est la branche suivie
+            if (success && output == QString("refs/heads/%1").arg(m_branch)) {
+                runStep(Step::Status, QStringList() << "status" << "--porcelain"
+                        << "--untracked-files=no");
+            }
+            return;
+
+        case Step::Status:
+            // Fast-forward uniquement si l'arbre de travail est propre
+            if (success && output.isEmpty()) {
+                runStep(Step::Merge, QStringList() << "merge" << "--ff-only" << "--quiet"
+                        << QString("refs/remotes/origin/%1").arg(m_branch));
+            }
+            return;
+
+        case Step::Merge:
+        case Step::Idle:
+            return;
+    }
+}
+
+QString FetchScheduler::redact(const QString& text) const {
+    if (m_token.isEmpty()) {
+        return text;
+    }
+
+    QString redacted = text;
+    return redacted.replace(m_token, "********");
+}
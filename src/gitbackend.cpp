@@ -0,0 +1,81 @@
+﻿#include "include/gitbackend.h"
+#include "include/gitmanager.h"
+
+GitBackend::GitBackend()
+    : m_lastErrorCode(GitError::None) {
+}
+
+QString GitBackend::kindName(Kind kind) {
+    switch (kind) {
+    case Kind::Process: return "processus git";
+    case Kind::Libgit2: return "libgit2";
+    }
+    return QString();
+}
+
+void GitBackend::setError(GitError code, const QString& message) {
+    m_lastErrorCode = code;
+    m_lastError = message;
+}
+
+ProcessGitBackend::ProcessGitBackend(GitManager& manager)
+    : m_manager(manager) {
+}
+
+bool ProcessGitBackend::run(const QString& repoPath, const QStringList& arguments) {
+    if (m_manager.executeGitCommand(repoPath, arguments)) {
+        setError(GitError::None, QString());
+        return true;
+    }
+    setError(m_manager.lastErrorCode(), m_manager.lastError());
+    return false;
+}
+
+bool ProcessGitBackend::status(const QString& repoPath, QVector<GitStatusEntry>& entries) {
+    entries.clear();
+    if (!run(repoPath, QStringList() << "status" << "--porcelain" << "-z" << "--no-renames"
+                                     << "--untracked-files=all")) {
+        return false;
+    }
+
+    // Enregistrements "XY chemin" separes par NUL
+    const QStringList records = m_manager.lastStandardOutput().split(QChar('\0'), Qt::SkipEmptyParts);
+    for (const QString& record : records) {
+        if (record.size() < 4) {
+            continue;
+        }
+        GitStatusEntry entry;
+        entry.index = record.at(0).toLatin1();
+        entry.worktree = record.at(1).toLatin1();
+        entry.path = record.mid(3);
+        entries.append(entry);
+    }
+    return true;
+}
+
+bool ProcessGitBackend::addAll(const QString& repoPath, const QString& pathspec) {
+    QStringList args = QStringList() << "add" << "-A";
+    if (!pathspec.isEmpty()) {
+        args << "--" << ":(literal)" + pathspec;
+    }
+    return run(repoPath, args);
+}
+
+bool ProcessGitBackend::commit(const QString& repoPath, const QString& message) {
+    if (run(repoPath, QStringList() << "commit" << "-m" << message)) {
+        return true;
+    }
+    if (m_manager.lastOutput().contains("nothing to commit", Qt::CaseInsensitive)) {
+        setError(GitError::NothingToCommit, "Aucune modification a commiter.");
+    }
+    return false;
+}
+
+bool ProcessGitBackend::updateRef(const QString& repoPath, const QString& ref, const QString& target) {
+    return run(repoPath, QStringList() << "update-ref" << ref << target);
+}
+
+bool ProcessGitBackend::setRemoteUrl(const QString& repoPath, const QString& name, const QString& url,
+                                     bool create) {
+    return run(repoPath, QStringList() << "remote" << (create ? "add" : "set-url") << name << url);
+}
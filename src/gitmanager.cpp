@@ -1,4 +1,11 @@
 ﻿#include "include/gitmanager.h"
+#include "include/tracer.h"
+#include "include/dirwalker.h"
+#include "include/repostatecache.h"
+#include "include/archivereader.h"
+#if defined(ROGUE_HAVE_LIBGIT2)
+#include "include/libgit2backend.h"
+#endif
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
@@ -7,6 +14,119 @@
 #include <QEventLoop>
 #include <QTimer>
 #include <QThread>
+#include <QTemporaryFile>
+#include <QSaveFile>
+#include <QDirIterator>
+#include <QDateTime>
+#include <QCoreApplication>
+#include <QRegularExpression>
+#include <QtMath>
+#include <QScopedPointer>
+#include <QScopeGuard>
+#include <QSet>
+#include <algorithm>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <tlhelp32.h>
+#elif defined(Q_OS_UNIX)
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Lecture ls-remote du raccourci des push, faite avant les sondes: un distant
+// injoignable ne doit pas bloquer plus longtemps que le push complet lui-meme
+constexpr int FastPathTimeoutMs = 10000;
+
+/**
+ * @brief Marque une operation comme en cours pour la duree d'une portee
+ */
+class OperationScope {
+public:
+    explicit OperationScope(bool& flag) : m_flag(flag), m_previous(flag) { m_flag = true; }
+    ~OperationScope() { m_flag = m_previous; }
+
+private:
+    bool& m_flag;
+    bool m_previous;
+};
+
+/**
+ * @brief Commande qui ne modifie ni HEAD, ni les references, ni la configuration
+ */
+bool isReadOnlyCommand(const QStringList& arguments) {
+    static const QStringList readOnly = { "status", "diff", "ls-files", "ls-remote", "rev-parse", "rev-list",
+                                          "cat-file", "merge-base", "check-ignore", "log", "show",
+                                          "hash-object", "for-each-ref", "version", "--version" };
+    // Options "-c cle=valeur" du profil de transport avant la sous-commande
+    int index = 0;
+    while (index + 1 < arguments.size() && arguments.at(index) == "-c") {
+        index += 2;
+    }
+    if (index >= arguments.size()) {
+        return true;
+    }
+    const QString& command = arguments.at(index);
+    if (command == "remote") {
+        return arguments.value(index + 1) == "get-url";
+    }
+    if (command == "config") {
+        return arguments.value(index + 1) == "--get";
+    }
+    return readOnly.contains(command);
+}
+
+/**
+ * @brief Entree d'un dossier compare en mode miroir
+ */
+struct MirrorEntry {
+    QString name;
+    bool isDirectory = false;
+    qint64 size = -1;
+    QDateTime modified;
+};
+
+/**
+ * @brief Contenu d'un seul dossier, trie par nom (ordre binaire des deux cotes)
+ *
+ * Une seule lecture du dossier par DirWalker, types donnes par d_type: seuls
+ * les fichiers sont dates, les dossiers ne coutent aucun stat.
+ * @param source Source: liens traites selon policy; destination: liens jamais suivis
+ * @param includeHidden Entrees cachees comparees; sinon ignorees des deux cotes, comme par DirWalker
+ * @param foundGitDir Vrai si le dossier contient un .git (depot imbrique)
+ */
+QVector<MirrorEntry> listMirrorDirectory(const QString& path, DirWalker::SymlinkPolicy policy, bool source,
+                                         bool includeHidden, bool* foundGitDir = nullptr) {
+    DirWalker walker(path, policy, includeHidden);
+    walker.setRecursive(false);
+    walker.setFileMetadata(true);
+    // Lien cote depot: remplace ou supprime comme un fichier
+    walker.setReportSymlinks(!source);
+    
+    QVector<MirrorEntry> entries;
+    DirWalker::Entry listed;
+    while (walker.next(listed)) {
+        MirrorEntry entry;
+        entry.name = listed.name;
+        entry.isDirectory = listed.isDirectory;
+        if (!listed.isDirectory && !listed.isSymlink) {
+            entry.size = listed.size;
+            entry.modified = QDateTime::fromMSecsSinceEpoch(listed.modifiedMSecs);
+        }
+        entries.append(entry);
+    }
+    if (foundGitDir) {
+        *foundGitDir = walker.foundGitDir();
+    }
+    
+    std::sort(entries.begin(), entries.end(),
+              [](const MirrorEntry& a, const MirrorEntry& b) { return a.name < b.name; });
+    return entries;
+}
+
+} // namespace
 
 GitManager::GitManager(QObject* parent)
     : QObject(parent)
@@ -14,26 +134,368 @@ GitManager::GitManager(QObject* parent)
     , m_process(new QProcess(this))
     , m_networkManager(new QNetworkAccessManager(this))
     , m_operationRunning(false)
-    , m_cancelRequested(false) {
+    , m_cancelRequested(false)
+    , m_processBusy(false)
+    , m_transportProfile(TransportProfile::Default)
+    , m_chunkThreshold(1024LL * 1024 * 1024)
+    , m_pushTimeoutMs(120000)
+    , m_internetProbeUrls({ "https://www.google.com", "https://1.1.1.1", "https://8.8.8.8" })
+    , m_githubProbeUrl("https://api.github.com")
+    , m_lastCancelLatencyMs(-1)
+    , m_symlinkPolicy(DirWalker::SymlinkPolicy::FollowFiles)
+    , m_includeHidden(false)
+    , m_pipelinedStaging(false)
+    , m_copyPendingAdd(false)
+    , m_exactChangeSet(false)
+    , m_changeSetStaged(false)
+    , m_archiveExtraction(false)
+    , m_mirrorMode(false)
+    , m_largeRepoThreshold(100000)
+    , m_largeRepoJustEnabled(false)
+    , m_remoteRefCacheTtlMs(30000)
+    , m_connectivityVerified(false)
+    , m_repoState(new RepoStateCache(this))
+    , m_processBackend(new ProcessGitBackend(*this))
+    , m_backend(m_processBackend.get())
+    , m_stagingPipeline(nullptr)
+    , m_progressDone(0)
+    , m_progressTotal(-1) {
+#if defined(Q_OS_WIN)
+    // Tous les processus lances (et leurs fils) appartiennent a un job:
+    // l'annulation termine l'arbre complet, pas seulement git.exe
+    m_jobHandle = CreateJobObjectW(nullptr, nullptr);
+    if (m_jobHandle) {
+        JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits = {};
+        limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+        SetInformationJobObject(m_jobHandle, JobObjectExtendedLimitInformation,
+                                &limits, sizeof(limits));
+        
+        // Demarrage suspendu: git est rattache au job avant d'avoir pu lancer un fils
+        m_process->setCreateProcessArgumentsModifier([](QProcess::CreateProcessArguments* args) {
+            args->flags |= CREATE_SUSPENDED;
+        });
+    }
+#elif defined(Q_OS_UNIX)
+    // Chaque git demarre son propre groupe de processus: l'annulation tue
+    // aussi git-remote-https, pack-objects, etc.
+    m_process->setChildProcessModifier([]() {
+        ::setpgid(0, 0);
+    });
+#endif
 }
 
 GitManager::~GitManager() {
     if (m_process->state() != QProcess::NotRunning) {
-        m_process->kill();
+        killProcessTree();
         m_process->waitForFinished();
     }
+    
+#if defined(Q_OS_WIN)
+    if (m_jobHandle) {
+        CloseHandle(m_jobHandle);
+    }
+#endif
 }
 
 void GitManager::cancelOperation() {
     if (m_operationRunning) {
         m_cancelRequested = true;
+        m_cancelTimer.start();
         if (m_process->state() != QProcess::NotRunning) {
-            m_process->kill();
+            killProcessTree();
         }
         emit operationCancelled();
     }
 }
 
+void GitManager::attachToProcessTree() {
+#if defined(Q_OS_WIN)
+    if (!m_jobHandle) {
+        return;
+    }
+    
+    const DWORD processId = static_cast<DWORD>(m_process->processId());
+    HANDLE process = OpenProcess(PROCESS_SET_QUOTA | PROCESS_TERMINATE, FALSE, processId);
+    if (process) {
+        AssignProcessToJobObject(m_jobHandle, process);
+        CloseHandle(process);
+    }
+    
+    // Reprise du thread principal, suspendu depuis la creation
+    bool resumed = false;
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+    if (snapshot != INVALID_HANDLE_VALUE) {
+        THREADENTRY32 thread = {};
+        thread.dwSize = sizeof(thread);
+        for (BOOL more = Thread32First(snapshot, &thread); more; more = Thread32Next(snapshot, &thread)) {
+            if (thread.th32OwnerProcessID != processId) {
+                continue;
+            }
+            HANDLE handle = OpenThread(THREAD_SUSPEND_RESUME, FALSE, thread.th32ThreadID);
+            if (handle) {
+                resumed = ResumeThread(handle) != static_cast<DWORD>(-1) || resumed;
+                CloseHandle(handle);
+            }
+        }
+        CloseHandle(snapshot);
+    }
+    
+    // Jamais repris: le tuer plutot que d'attendre le timeout
+    if (!resumed) {
+        qWarning() << "Reprise du processus Git impossible:" << GetLastError();
+        killProcessTree();
+    }
+#endif
+}
+
+void GitManager::killProcessTree() {
+#if defined(Q_OS_WIN)
+    if (m_jobHandle) {
+        TerminateJobObject(m_jobHandle, 1);
+    }
+#elif defined(Q_OS_UNIX)
+    qint64 pid = m_process->processId();
+    if (pid > 0) {
+        ::kill(-static_cast<pid_t>(pid), SIGKILL);
+    }
+#endif
+    m_process->kill();
+}
+
+void GitManager::recordCancelLatency() {
+    if (!m_cancelTimer.isValid()) {
+        return;
+    }
+    
+    m_lastCancelLatencyMs = m_cancelTimer.elapsed();
+    m_cancelTimer.invalidate();
+    
+    if (m_lastCancelLatencyMs > 200) {
+        qWarning() << "Annulation lente:" << m_lastCancelLatencyMs << "ms (objectif: 200 ms)";
+    }
+}
+
+QStringList GitManager::existingLocks(const QString& workingDir) const {
+    QDir gitDir(QDir(workingDir).filePath(".git"));
+    QStringList locks;
+    if (!gitDir.exists()) {
+        return locks;
+    }
+    
+    const QStringList topLevelLocks = {
+        "index.lock", "HEAD.lock", "ORIG_HEAD.lock", "FETCH_HEAD.lock",
+        "config.lock", "packed-refs.lock", "shallow.lock"
+    };
+    for (const QString& name : topLevelLocks) {
+        if (gitDir.exists(name)) {
+            locks << gitDir.filePath(name);
+        }
+    }
+    
+    QDirIterator it(gitDir.filePath("refs"), QStringList() << "*.lock",
+                    QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        locks << it.next();
+    }
+    return locks;
+}
+
+void GitManager::cleanupStaleLocks(const QString& workingDir, const QStringList& before,
+                                   const QDateTime& since) {
+    // Seuls les verrous apparus pendant la vie du processus interrompu sont
+    // supprimes: ceux d'avant son lancement appartiennent a un autre git,
+    // comme ceux qui datent d'apres son arret
+    const QDateTime until = QDateTime::currentDateTime();
+    const QDateTime threshold = since.addSecs(-1);
+    const QSet<QString> previous(before.cbegin(), before.cend());
+    
+    for (const QString& lock : existingLocks(workingDir)) {
+        if (previous.contains(lock)) {
+            continue;
+        }
+        QFileInfo lockInfo(lock);
+        if (lockInfo.lastModified() >= threshold && lockInfo.lastModified() <= until) {
+            if (QFile::remove(lock)) {
+                qDebug() << "Verrou orphelin supprime:" << lock;
+            }
+        }
+    }
+}
+
+void GitManager::pumpEvents() {
+    // Traiter les evenements au plus toutes les 50 ms pendant les copies
+    if (!m_eventPumpTimer.isValid() || m_eventPumpTimer.elapsed() >= 50) {
+        QCoreApplication::processEvents();
+        m_eventPumpTimer.start();
+    }
+}
+
+bool GitManager::copyFileInterruptible(const QString& sourcePath, const QString& destPath) {
+    QFile source(sourcePath);
+    if (!source.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    
+    // QSaveFile ecrit dans un fichier temporaire renomme a la fin: un fichier
+    // annule ou en echec ne remplace jamais la destination existante.
+    QSaveFile dest(destPath);
+    if (!dest.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    
+    if (m_copyBuffer.isEmpty()) {
+        m_copyBuffer.resize(1024 * 1024);
+    }
+    
+    while (!source.atEnd()) {
+        qint64 read = source.read(m_copyBuffer.data(), m_copyBuffer.size());
+        if (read < 0 || dest.write(m_copyBuffer.constData(), read) != read) {
+            dest.cancelWriting();
+            return false;
+        }
+        
+        pumpEvents();
+        if (m_cancelRequested) {
+            dest.cancelWriting();
+            return false;
+        }
+    }
+    
+    if (!dest.commit()) {
+        return false;
+    }
+    
+    QFile::setPermissions(destPath, source.permissions());
+    m_metrics.recordCopiedFile(source.size());
+    return true;
+}
+
+bool GitManager::extractEntryInterruptible(ArchiveReader& reader, const QString& destPath,
+                                           QFile::Permissions permissions) {
+    QSaveFile dest(destPath);
+    if (!dest.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    
+    if (m_copyBuffer.isEmpty()) {
+        m_copyBuffer.resize(1024 * 1024);
+    }
+    
+    // Les donnees passent de l'archive au depot sans fichier intermediaire
+    qint64 written = 0;
+    for (;;) {
+        qint64 read = reader.read(m_copyBuffer.data(), m_copyBuffer.size());
+        if (read == 0) {
+            break;
+        }
+        if (read < 0 || dest.write(m_copyBuffer.constData(), read) != read) {
+            dest.cancelWriting();
+            return false;
+        }
+        written += read;
+        
+        pumpEvents();
+        if (m_cancelRequested) {
+            dest.cancelWriting();
+            return false;
+        }
+    }
+    
+    if (!dest.commit()) {
+        return false;
+    }
+    
+    QFile::setPermissions(destPath, permissions);
+    m_metrics.recordCopiedFile(written);
+    return true;
+}
+
+QStringList GitManager::transportConfigArgs(TransportProfile profile) {
+    // Les surcharges -c sont propagees aux processus fils (pack-objects,
+    // git-remote-https), ce qui evite de modifier la configuration du depot.
+    QStringList settings;
+    
+    switch (profile) {
+        case TransportProfile::LanBulk:
+            // Reseau rapide: on privilegie le CPU plutot que la taille du pack
+            settings << "pack.threads=0"
+                     << "core.compression=0"
+                     << "pack.window=0"
+                     << "http.version=HTTP/1.1"
+                     << "http.postBuffer=524288000";
+            break;
+        case TransportProfile::WanLowBandwidth:
+            // Lien lent: compression et recherche de deltas maximales
+            settings << "pack.threads=0"
+                     << "core.compression=9"
+                     << "pack.window=50"
+                     << "http.version=HTTP/2"
+                     << "http.postBuffer=1048576";
+            break;
+        case TransportProfile::ManySmallFiles:
+            // Beaucoup de petits objets: compression legere, un seul POST
+            settings << "pack.threads=0"
+                     << "core.compression=1"
+                     << "pack.window=10"
+                     << "http.version=HTTP/2"
+                     << "http.postBuffer=157286400";
+            break;
+        case TransportProfile::Default:
+        default:
+            break;
+    }
+    
+    QStringList args;
+    for (const QString& setting : settings) {
+        args << "-c" << setting;
+    }
+    return args;
+}
+
+QString GitManager::transportProfileName(TransportProfile profile) {
+    switch (profile) {
+        case TransportProfile::LanBulk:
+            return "LAN (gros volumes)";
+        case TransportProfile::WanLowBandwidth:
+            return "WAN (faible debit)";
+        case TransportProfile::ManySmallFiles:
+            return "Nombreux petits fichiers";
+        case TransportProfile::Default:
+        default:
+            return "Par defaut";
+    }
+}
+
+QString GitManager::authenticatedUrl(const QString& remoteUrl, const QString& username,
+                                     const QString& token) {
+    if (username.isEmpty() || token.isEmpty() || !remoteUrl.startsWith("https://")) {
+        return remoteUrl;
+    }
+    
+    return QString("https://%1:%2@%3").arg(username, token, remoteUrl.mid(8));
+}
+
+QProcessEnvironment GitManager::credentialEnvironment(const QProcessEnvironment& base,
+                                                     const QString& remoteUrl,
+                                                     const QString& username, const QString& token) {
+    if (username.isEmpty() || token.isEmpty() || !remoteUrl.startsWith("https://")) {
+        return base;
+    }
+    
+    // Entrees de configuration deja passees par l'environnement conservees
+    QProcessEnvironment env = base;
+    bool ok = false;
+    int index = env.value("GIT_CONFIG_COUNT").toInt(&ok);
+    if (!ok || index < 0) {
+        index = 0;
+    }
+    const QByteArray basic = (username + ":" + token).toUtf8().toBase64();
+    env.insert(QString("GIT_CONFIG_KEY_%1").arg(index), "http." + remoteUrl + ".extraHeader");
+    env.insert(QString("GIT_CONFIG_VALUE_%1").arg(index), "Authorization: Basic " + QString::fromLatin1(basic));
+    env.insert("GIT_CONFIG_COUNT", QString::number(index + 1));
+    return env;
+}
+
 void GitManager::setError(GitError code, const QString& message) {
     m_lastErrorCode = code;
     m_lastError = message;
@@ -67,19 +529,31 @@ QString GitManager::getGitErrorMessage(const QString& gitOutput) {
 GitError GitManager::detectErrorType(const QString& errorOutput) {
     QString output = errorOutput.toLower();
     
+    // Statut HTTP rapporte par git ("the requested url returned error: 503"):
+    // un numero de port ou un hash contenant 403 ne doit pas etre interprete
+    static const QRegularExpression httpStatus("error:? (\\d{3})");
+    QRegularExpressionMatch statusMatch = httpStatus.match(output);
+    int status = statusMatch.hasMatch() ? statusMatch.captured(1).toInt() : 0;
+    
     if (output.contains("authentication failed") || 
         output.contains("could not authenticate") ||
         output.contains("invalid credentials") ||
-        output.contains("403")) {
+        status == 401 || status == 403) {
         return GitError::AuthenticationFailed;
     }
     
+    // Erreurs serveur et coupures: transitoires, donc rejouables
     if (output.contains("could not resolve host") ||
         output.contains("failed to connect") ||
         output.contains("connection refused") ||
         output.contains("network unreachable") ||
         output.contains("connection timed out") ||
-        output.contains("could not read from remote")) {
+        output.contains("connection reset") ||
+        output.contains("empty reply from server") ||
+        output.contains("recv failure") ||
+        output.contains("the remote end hung up unexpectedly") ||
+        output.contains("could not read from remote") ||
+        (status >= 500 && status < 600)) {
         return GitError::NetworkError;
     }
     
@@ -93,7 +567,7 @@ GitError GitManager::detectErrorType(const QString& errorOutput) {
     
     if (output.contains("remote not found") ||
         output.contains("repository not found") ||
-        output.contains("404")) {
+        status == 404) {
         return GitError::RemoteNotFound;
     }
     
@@ -125,24 +599,30 @@ bool GitManager::shouldRetry(GitError errorCode) {
 }
 
 void GitManager::waitBeforeRetry(int attemptNumber) {
-    int waitTime = qMin(2000 * (1 << attemptNumber), 10000);
+    double delay = m_retryPolicy.initialDelayMs * qPow(m_retryPolicy.multiplier, attemptNumber);
+    int waitTime = static_cast<int>(qMin(delay, static_cast<double>(m_retryPolicy.maxDelayMs)));
     qDebug() << "Attente de" << waitTime << "ms avant nouvelle tentative";
     QThread::msleep(waitTime);
 }
 
+void GitManager::setConnectivityEndpoints(const QStringList& internetProbeUrls,
+                                          const QString& githubProbeUrl) {
+    m_internetProbeUrls = internetProbeUrls;
+    m_githubProbeUrl = githubProbeUrl;
+}
+
 bool GitManager::checkInternetConnection() {
     emit connectionCheckStarted();
     
-    QStringList testUrls = {
-        "https://www.google.com",
-        "https://1.1.1.1",
-        "https://8.8.8.8"
-    };
-    
-    for (const QString& url : testUrls) {
+    for (const QString& url : m_internetProbeUrls) {
+        TraceSpan span("checkInternetConnection", "network");
+        span.setArg("url", url);
+        
         QNetworkRequest request(url);
         request.setTransferTimeout(3000);
         
+        QElapsedTimer probeTimer;
+        probeTimer.start();
         QNetworkReply* reply = m_networkManager->head(request);
         
         QEventLoop loop;
@@ -156,6 +636,8 @@ bool GitManager::checkInternetConnection() {
         loop.exec();
         
         bool success = (reply->error() == QNetworkReply::NoError);
+        span.setArg("success", success);
+        m_metrics.recordProbe(probeTimer.elapsed(), success);
         reply->deleteLater();
         
         if (success) {
@@ -169,12 +651,16 @@ bool GitManager::checkInternetConnection() {
 }
 
 bool GitManager::checkGitHubConnectivity(int timeout) {
+    TraceSpan span("checkGitHubConnectivity", "network");
+    span.setArg("url", m_githubProbeUrl);
     emit connectionCheckStarted();
     
-    QNetworkRequest request(QUrl("https://api.github.com"));
+    QNetworkRequest request(QUrl(m_githubProbeUrl));
     request.setTransferTimeout(timeout);
     request.setRawHeader("User-Agent", "RoguePublisher/1.0");
     
+    QElapsedTimer probeTimer;
+    probeTimer.start();
     QNetworkReply* reply = m_networkManager->get(request);
     
     QEventLoop loop;
@@ -188,13 +674,59 @@ bool GitManager::checkGitHubConnectivity(int timeout) {
     loop.exec();
     
     bool success = (reply->error() == QNetworkReply::NoError);
+    span.setArg("success", success);
+    m_metrics.recordProbe(probeTimer.elapsed(), success);
     reply->deleteLater();
     
     emit connectionCheckCompleted(success);
     return success;
 }
 
+bool GitManager::probeConnectivity(int timeout) {
+    TraceSpan span("GitManager::probeConnectivity", "network");
+    
+    // Gestionnaire propre au thread appelant: m_networkManager appartient au thread principal
+    QNetworkAccessManager manager;
+    auto probe = [this, &manager](const QString& url, bool fullRequest, int timeoutMs) {
+        QNetworkRequest request{QUrl(url)};
+        request.setTransferTimeout(timeoutMs);
+        request.setRawHeader("User-Agent", "RoguePublisher/1.0");
+        
+        QElapsedTimer probeTimer;
+        probeTimer.start();
+        QNetworkReply* reply = fullRequest ? manager.get(request) : manager.head(request);
+        
+        QEventLoop loop;
+        QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+        QTimer timer;
+        timer.setSingleShot(true);
+        QObject::connect(&timer, &QTimer::timeout, &loop, &QEventLoop::quit);
+        timer.start(timeoutMs);
+        loop.exec();
+        
+        bool success = (reply->error() == QNetworkReply::NoError);
+        m_metrics.recordProbe(probeTimer.elapsed(), success);
+        delete reply;
+        return success;
+    };
+    
+    bool online = false;
+    for (const QString& url : m_internetProbeUrls) {
+        if (probe(url, false, 3000)) {
+            online = true;
+            break;
+        }
+    }
+    
+    bool success = online && probe(m_githubProbeUrl, true, timeout);
+    span.setArg("success", success);
+    return success;
+}
+
 bool GitManager::isGitAvailable() {
+    TraceSpan span("GitManager::isGitAvailable", "git");
+    QElapsedTimer processTimer;
+    processTimer.start();
     QProcess process;
     process.start("git", QStringList() << "--version");
     
@@ -206,6 +738,7 @@ bool GitManager::isGitAvailable() {
     }
     
     process.waitForFinished(5000);
+    m_metrics.recordProcess(processTimer.elapsed());
     
     if (process.exitCode() == 0) {
         m_lastOutput = QString::fromUtf8(process.readAllStandardOutput()).trimmed();
@@ -217,7 +750,22 @@ bool GitManager::isGitAvailable() {
     return false;
 }
 
+bool GitManager::isValidBranchName(const QString& name) {
+    if (name.isEmpty() || name.startsWith('-')) {
+        return false;
+    }
+    QProcess process;
+    process.start("git", QStringList() << "check-ref-format" << "--branch" << name);
+    if (!process.waitForStarted(5000) || !process.waitForFinished(5000)) {
+        process.kill();
+        process.waitForFinished(1000);
+        return false;
+    }
+    return process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0;
+}
+
 bool GitManager::isGitRepository(const QString& repoPath) {
+    TraceSpan span("GitManager::isGitRepository", "git");
     if (repoPath.isEmpty()) {
         setError(GitError::InvalidRepository, "Chemin de depot vide.");
         return false;
@@ -229,7 +777,7 @@ bool GitManager::isGitRepository(const QString& repoPath) {
         return false;
     }
     
-    bool isRepo = QFileInfo(dir.absoluteFilePath(".git")).exists();
+    bool isRepo = m_repoState->state(repoPath).isRepository;
     if (!isRepo) {
         setError(GitError::InvalidRepository, "Ce n'est pas un depot Git: " + repoPath);
     }
@@ -238,6 +786,8 @@ bool GitManager::isGitRepository(const QString& repoPath) {
 }
 
 bool GitManager::initRepository(const QString& repoPath) {
+    TraceSpan span("GitManager::initRepository", "git");
+    GitMetrics::StageTimer stage(m_metrics, "init");
     if (repoPath.isEmpty()) {
         setError(GitError::InvalidRepository, "Chemin de depot vide.");
         emit operationFailed(m_lastError, m_lastErrorCode);
@@ -269,27 +819,198 @@ bool GitManager::initRepository(const QString& repoPath) {
     return true;
 }
 
-bool GitManager::setRemoteUrl(const QString& repoPath, const QString& remoteUrl) {
+bool GitManager::bootstrapRepository(const QString& repoPath, const QString& remoteUrl,
+                                     const QString& branch, const QString& username,
+                                     const QString& token, int depth, bool singleBranch) {
+    TraceSpan span("GitManager::bootstrapRepository", "git");
+    GitMetrics::StageTimer stage(m_metrics, "bootstrap");
     if (remoteUrl.isEmpty()) {
         setError(GitError::RemoteNotFound, "URL du depot distant vide.");
         emit operationFailed(m_lastError, m_lastErrorCode);
         return false;
     }
     
-    emit operationStarted("Configuration du depot distant...");
+    QDir repoDir(repoPath);
+    if (QFileInfo::exists(repoDir.filePath(".git"))) {
+        setError(GitError::InvalidRepository, "Le depot Git existe deja: " + repoPath);
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    
+    QFileInfo repoInfo(repoDir.absolutePath());
+    QDir parentDir = repoInfo.absoluteDir();
+    if (!parentDir.exists() && !parentDir.mkpath(".")) {
+        setError(GitError::InvalidRepository, "Impossible de creer le repertoire: " + parentDir.path());
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    
+    emit operationStarted("Clone partiel du depot distant...");
+    
+    // Le repertoire cible contient souvent deja les fichiers copies par
+    // l'utilisateur: on clone alors sans checkout a cote, puis on deplace .git.
+    bool targetIsEmpty = !repoDir.exists() ||
+        repoDir.isEmpty(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+    QString cloneDir = targetIsEmpty
+        ? repoInfo.absoluteFilePath()
+        : parentDir.filePath(QString(".%1.bootstrap").arg(repoInfo.fileName()));
+    
+    if (!targetIsEmpty) {
+        QDir(cloneDir).removeRecursively();
+    }
+    
+    // Identifiants en en-tete HTTP pour le clone et les blobs recuperes ensuite
+    // (reset, sparse-checkout, restauration): origin reste l'URL sans token
+    // dans .git/config, meme si une etape echoue
+    const QProcessEnvironment previousEnvironment = m_process->processEnvironment();
+    const QProcessEnvironment inherited = previousEnvironment.isEmpty()
+        ? QProcessEnvironment::systemEnvironment() : previousEnvironment;
+    m_process->setProcessEnvironment(credentialEnvironment(inherited, remoteUrl, username, token));
+    auto restoreEnvironment = qScopeGuard([this, previousEnvironment]() {
+        m_process->setProcessEnvironment(previousEnvironment);
+    });
+    
+    QStringList args = transportConfigArgs(m_transportProfile);
+    args << "clone" << "--filter=blob:none" << "--branch" << branch;
+    if (!targetIsEmpty) {
+        args << "--no-checkout";
+    }
+    if (singleBranch) {
+        args << "--single-branch";
+    }
+    if (!m_publishSubdirectory.isEmpty()) {
+        args << "--sparse"; // Racine seulement; le dossier publie est ajoute ensuite
+    }
+    if (depth > 0) {
+        args << "--depth" << QString::number(depth);
+    }
+    args << remoteUrl << cloneDir;
+    
+    if (!executeGitCommand(parentDir.absolutePath(), args, 600000)) {
+        if (!targetIsEmpty) {
+            QDir(cloneDir).removeRecursively();
+        }
+        
+        QString output = m_lastOutput + m_lastError;
+        if (output.contains("not found in upstream", Qt::CaseInsensitive) ||
+            output.contains("empty repository", Qt::CaseInsensitive)) {
+            setError(GitError::RemoteNotFound,
+                    QString("La branche %1 n'existe pas encore sur le depot distant.").arg(branch));
+            return false;
+        }
+        
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    
+    // Le clone s'execute depuis le dossier parent: l'etat du depot cible est perime
+    m_repoState->invalidate(repoPath);
     
-    if (executeGitCommand(repoPath, QStringList() << "remote" << "get-url" << "origin")) {
-        if (!executeGitCommand(repoPath, QStringList() << "remote" << "set-url" << "origin" << remoteUrl)) {
+    if (!targetIsEmpty) {
+        bool moved = QDir().rename(QDir(cloneDir).filePath(".git"), repoDir.filePath(".git"));
+        QDir(cloneDir).removeRecursively();
+        m_repoState->invalidate(repoPath);
+        
+        if (!moved) {
+            setError(GitError::ProcessFailed, "Impossible de deplacer le depot clone dans: " + repoPath);
             emit operationFailed(m_lastError, m_lastErrorCode);
             return false;
         }
-    } else {
-        if (!executeGitCommand(repoPath, QStringList() << "remote" << "add" << "origin" << remoteUrl)) {
+        
+        // Motifs poses avant reset: l'index marque d'emblee le reste du depot hors arbre
+        if (!ensureSparseCheckout(repoPath)) {
+            return false;
+        }
+        
+        // Index = HEAD sans toucher aux fichiers de l'utilisateur (les arbres
+        // sont disponibles localement, seuls les blobs sont differes)
+        if (!executeGitCommand(repoPath, QStringList() << "reset" << "-q")) {
+            emit operationFailed(m_lastError, m_lastErrorCode);
+            return false;
+        }
+        
+        // Restaurer uniquement les fichiers absents, sans ecraser les copies
+        if (!restoreMissingFiles(repoPath)) {
             emit operationFailed(m_lastError, m_lastErrorCode);
             return false;
         }
     }
     
+    if (targetIsEmpty && !ensureSparseCheckout(repoPath)) {
+        return false;
+    }
+    
+    if (m_cancelRequested) {
+        m_cancelRequested = false;
+        return false;
+    }
+    
+    emit operationSuccess(QString("Depot clone (partiel%1) depuis %2")
+                        .arg(depth > 0 ? QString(", profondeur %1").arg(depth) : QString())
+                        .arg(remoteUrl));
+    return true;
+}
+
+bool GitManager::restoreMissingFiles(const QString& repoPath) {
+    if (!executeGitCommand(repoPath, QStringList() << "ls-files" << "-d" << "-z")) {
+        return false;
+    }
+    
+    const QStringList missing = m_lastStandardOutput.split(QChar('\0'), Qt::SkipEmptyParts);
+    if (missing.isEmpty()) {
+        return true;
+    }
+    
+    return executeGitWithPathspec(repoPath, QStringList() << "checkout", missing, 600000);
+}
+
+bool GitManager::executeGitWithPathspec(const QString& repoPath, const QStringList& arguments,
+                                        const QStringList& paths, int timeoutMs) {
+    // La liste peut etre longue: elle passe par un fichier plutot que par argv
+    QTemporaryFile pathspecFile;
+    if (!pathspecFile.open()) {
+        setError(GitError::ProcessFailed, "Impossible de creer un fichier temporaire.");
+        return false;
+    }
+    
+    for (const QString& path : paths) {
+        pathspecFile.write(path.toUtf8());
+        pathspecFile.write("\0", 1);
+    }
+    pathspecFile.flush();
+    
+    return executeGitCommand(repoPath, QStringList(arguments)
+                             << "--pathspec-from-file=" + pathspecFile.fileName()
+                             << "--pathspec-file-nul", timeoutMs);
+}
+
+bool GitManager::setRemoteUrl(const QString& repoPath, const QString& remoteUrl) {
+    TraceSpan span("GitManager::setRemoteUrl", "git");
+    if (remoteUrl.isEmpty()) {
+        setError(GitError::RemoteNotFound, "URL du depot distant vide.");
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    
+    QString currentUrl = originUrl(repoPath);
+    if (currentUrl == remoteUrl) {
+        span.setArg("unchanged", true);
+        setError(GitError::None, QString());
+        return true;
+    }
+    
+    emit operationStarted("Configuration du depot distant...");
+    invalidateRemoteRefs(repoPath);
+    
+    GitBackend* backend = backendFor(repoPath);
+    bool configured = backend->setRemoteUrl(repoPath, "origin", remoteUrl, currentUrl.isEmpty());
+    m_repoState->invalidate(repoPath);
+    if (!configured) {
+        setError(backend->lastErrorCode(), backend->lastError());
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    
     if (m_cancelRequested) {
         m_cancelRequested = false;
         return false;
@@ -299,14 +1020,48 @@ bool GitManager::setRemoteUrl(const QString& repoPath, const QString& remoteUrl)
     return true;
 }
 
+QString GitManager::originUrl(const QString& repoPath) {
+    const RepoState& state = m_repoState->state(repoPath);
+    if (state.isRepository && state.originResolved) {
+        return state.originUrl;
+    }
+    
+    QString url;
+    if (executeGitCommand(repoPath, QStringList() << "config" << "--get" << "remote.origin.url")) {
+        url = m_lastStandardOutput.trimmed();
+    }
+    m_repoState->setOriginUrl(repoPath, url);
+    return url;
+}
+
+QString GitManager::headCommit(const QString& repoPath) {
+    const RepoState& state = m_repoState->state(repoPath);
+    if (state.isRepository && state.headResolved) {
+        return state.head;
+    }
+    
+    if (executeGitCommand(repoPath, QStringList() << "rev-parse" << "--verify" << "-q" << "HEAD")) {
+        return m_lastStandardOutput.trimmed();
+    }
+    return QString();
+}
+
 bool GitManager::copyAndAddFiles(const QString& repoPath, const QStringList& files, 
                                 const QString& subdir) {
+    TraceSpan span("GitManager::copyAndAddFiles", "git");
+    GitMetrics::StageTimer stage(m_metrics, "copy");
+    span.setArg("files", static_cast<int>(files.size()));
     if (files.isEmpty()) {
         setError(GitError::FileNotFound, "Aucun fichier a copier.");
         emit operationFailed(m_lastError, m_lastErrorCode);
         return false;
     }
     
+    if (!m_operationRunning) {
+        m_cancelRequested = false;
+    }
+    OperationScope scope(m_operationRunning);
+    
     emit operationStarted(QString("Copie et ajout de %1 fichier(s)...").arg(files.count()));
     
     QString targetDir = repoPath;
@@ -339,16 +1094,10 @@ bool GitManager::copyAndAddFiles(const QString& repoPath, const QStringList& fil
         QString fileName = sourceInfo.fileName();
         QString destPath = QDir(targetDir).filePath(fileName);
         
-        QFile destFile(destPath);
-        if (destFile.exists()) {
-            if (!destFile.remove()) {
-                qWarning() << "Impossible de supprimer le fichier existant:" << destPath;
-                continue;
+        if (!copyFileInterruptible(sourceFile, destPath)) {
+            if (!m_cancelRequested) {
+                qWarning() << "Echec de la copie:" << sourceFile << "vers" << destPath;
             }
-        }
-        
-        if (!QFile::copy(sourceFile, destPath)) {
-            qWarning() << "Echec de la copie:" << sourceFile << "vers" << destPath;
             continue;
         }
         
@@ -390,6 +1139,9 @@ bool GitManager::copyAndAddFiles(const QString& repoPath, const QStringList& fil
 }
 
 bool GitManager::addFiles(const QString& repoPath, const QStringList& files) {
+    TraceSpan span("GitManager::addFiles", "git");
+    GitMetrics::StageTimer stage(m_metrics, "add");
+    span.setArg("files", static_cast<int>(files.size()));
     if (files.isEmpty()) {
         setError(GitError::FileNotFound, "Aucun fichier a ajouter.");
         emit operationFailed(m_lastError, m_lastErrorCode);
@@ -436,7 +1188,9 @@ bool GitManager::addFiles(const QString& repoPath, const QStringList& files) {
     return true;
 }
 
-bool GitManager::commit(const QString& repoPath, const QString& message) {
+bool GitManager::commit(const QString& repoPath, const QString& message, qint64 stagedBytes) {
+    TraceSpan span("GitManager::commit", "git");
+    GitMetrics::StageTimer stage(m_metrics, "commit");
     if (message.isEmpty()) {
         setError(GitError::UnknownError, "Message de commit vide.");
         emit operationFailed(m_lastError, m_lastErrorCode);
@@ -445,10 +1199,27 @@ bool GitManager::commit(const QString& repoPath, const QString& message) {
     
     emit operationStarted("Creation du commit...");
     
-    if (!executeGitCommand(repoPath, QStringList() << "commit" << "-m" << message)) {
-        if (m_lastOutput.toLower().contains("nothing to commit")) {
-            setError(GitError::NothingToCommit, "Aucune modification a commiter.");
+    // Un premier commit geant produirait un pack trop gros pour un seul push.
+    // Taille deja connue sous le seuil, ou pas de seuil: aucun processus; sinon
+    // tailles des blobs indexes, sans lire l'arbre de travail
+    if (m_chunkThreshold > 0 && (stagedBytes < 0 || stagedBytes > m_chunkThreshold)) {
+        QVector<StagedEntry> entries;
+        if (readStagedEntries(repoPath, entries)) {
+            qint64 stagedSize = 0;
+            for (const StagedEntry& entry : std::as_const(entries)) {
+                stagedSize += entry.bytes;
+            }
+            if (stagedSize > m_chunkThreshold) {
+                return commitInChunks(repoPath, message, entries);
+            }
         }
+    }
+    
+    GitBackend* backend = backendFor(repoPath);
+    bool committed = backend->commit(repoPath, message);
+    m_repoState->invalidate(repoPath);
+    if (!committed) {
+        setError(backend->lastErrorCode(), backend->lastError());
         emit operationFailed(m_lastError, m_lastErrorCode);
         return false;
     }
@@ -462,14 +1233,525 @@ bool GitManager::commit(const QString& repoPath, const QString& message) {
     return true;
 }
 
+bool GitManager::commitToBranches(const QString& repoPath, const QStringList& branches, const QString& message,
+                                  QHash<QString, QString>* heads) {
+    TraceSpan span("GitManager::commitToBranches", "git");
+    GitMetrics::StageTimer stage(m_metrics, "commit");
+    span.setArg("branches", static_cast<int>(branches.size()));
+    if (message.isEmpty()) {
+        setError(GitError::UnknownError, "Message de commit vide.");
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    if (branches.contains(QString())) {
+        setError(GitError::UnknownError, "Nom de branche vide.");
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    
+    emit operationStarted(QString("Commit sur %1 branche(s)...").arg(branches.size()));
+    
+    // Un arbre pour toutes les branches, ecrit depuis l'index
+    if (!executeGitCommand(repoPath, QStringList() << "write-tree")) {
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    const QString tree = m_lastStandardOutput.trimmed();
+    
+    // Tetes locales et distantes de toutes les branches, avec leur arbre, en un processus
+    QStringList refs;
+    for (const QString& branch : branches) {
+        refs << "refs/heads/" + branch << "refs/remotes/origin/" + branch;
+    }
+    if (!executeGitCommand(repoPath, QStringList() << "for-each-ref"
+                           << "--format=%(refname)%09%(objectname)%09%(tree)" << refs)) {
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    QHash<QString, QPair<QString, QString>> tips; // refname -> (commit, arbre)
+    for (const QString& line : m_lastStandardOutput.split('\n', Qt::SkipEmptyParts)) {
+        const QString ref = line.section('\t', 0, 0);
+        if (refs.contains(ref)) {
+            tips.insert(ref, qMakePair(line.section('\t', 1, 1), line.section('\t', 2, 2).trimmed()));
+        }
+    }
+    
+    QByteArray transaction;
+    int created = 0;
+    for (const QString& branch : branches) {
+        const QString local = "refs/heads/" + branch;
+        const bool hasLocal = tips.contains(local);
+        const QString localHead = tips.value(local).first;
+        const QPair<QString, QString> remoteTip = tips.value("refs/remotes/origin/" + branch);
+        QPair<QString, QString> tip = hasLocal ? tips.value(local) : remoteTip;
+        
+        // Parent: la plus avancee des deux tetes, pour que le push reste une avance
+        // rapide; deux tetes divergentes font tout echouer avant update-ref
+        if (hasLocal && !remoteTip.first.isEmpty() && remoteTip.first != localHead) {
+            if (executeGitCommand(repoPath, QStringList() << "merge-base" << "--is-ancestor"
+                                  << localHead << remoteTip.first)) {
+                tip = remoteTip;
+            } else if (!executeGitCommand(repoPath, QStringList() << "merge-base" << "--is-ancestor"
+                                          << remoteTip.first << localHead)) {
+                setError(GitError::UnknownError, "La branche " + branch + " a diverge de origin/" + branch +
+                         ".\nSynchronisez-la avant de publier.");
+                emit operationFailed(m_lastError, m_lastErrorCode);
+                return false;
+            }
+        }
+        
+        QString head = tip.first;
+        if (tip.second != tree) {
+            QStringList args = { "commit-tree", tree };
+            if (!tip.first.isEmpty()) {
+                args << "-p" << tip.first;
+            }
+            args << "-F" << "-";
+            if (!executeGitCommand(repoPath, args, 30000, message.toUtf8())) {
+                emit operationFailed(m_lastError, m_lastErrorCode);
+                return false;
+            }
+            head = m_lastStandardOutput.trimmed();
+            ++created;
+        }
+        
+        // Valeur attendue verifiee par update-ref: une branche deplacee entre-temps fait tout echouer
+        if (hasLocal) {
+            if (head != localHead) {
+                transaction += QString("update %1 %2 %3\n").arg(local, head, localHead).toUtf8();
+            }
+        } else {
+            transaction += QString("create %1 %2\n").arg(local, head).toUtf8();
+        }
+        if (heads) {
+            heads->insert(branch, head);
+        }
+    }
+    
+    if (!transaction.isEmpty() &&
+        !executeGitCommand(repoPath, QStringList() << "update-ref" << "--stdin", 30000, transaction)) {
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    m_repoState->invalidate(repoPath);
+    
+    span.setArg("commits", created);
+    emit operationSuccess(QString("%1 commit(s) cree(s) sur %2 branche(s)").arg(created).arg(branches.size()));
+    return true;
+}
+
+bool GitManager::commitInChunks(const QString& repoPath, const QString& message,
+                                const QVector<StagedEntry>& entries) {
+    // Repartition gloutonne des entrees en lots sous le seuil; un fichier
+    // plus gros que le seuil forme un lot a lui seul. Les suppressions ne
+    // pesent rien et rejoignent le lot en cours.
+    QList<QVector<StagedEntry>> batches;
+    QVector<StagedEntry> currentBatch;
+    qint64 currentSize = 0;
+    
+    for (const StagedEntry& entry : entries) {
+        if (!currentBatch.isEmpty() && entry.bytes > 0 && currentSize + entry.bytes > m_chunkThreshold) {
+            batches << currentBatch;
+            currentBatch.clear();
+            currentSize = 0;
+        }
+        currentBatch << entry;
+        currentSize += entry.bytes;
+    }
+    if (!currentBatch.isEmpty()) {
+        batches << currentBatch;
+    }
+    
+    // Entrees au format de update-index -z --index-info: le contenu deja
+    // indexe est rejoue tel quel, l'arbre de travail n'est jamais relu
+    auto indexInfo = [](const QVector<StagedEntry>& batch) {
+        QByteArray info;
+        for (const StagedEntry& entry : batch) {
+            info += entry.mode.toLatin1() + ' ' + entry.blob.toLatin1() + '\t' + entry.path.toUtf8() + '\0';
+        }
+        return info;
+    };
+    
+    // En cas d'echec, l'index retrouve tout le contenu indexe au depart
+    auto fail = [this, &repoPath, &entries, &indexInfo]() {
+        const QString error = m_lastError;
+        const GitError code = m_lastErrorCode;
+        executeGitCommand(repoPath, QStringList() << "update-index" << "-z" << "--index-info",
+                          600000, indexInfo(entries));
+        setError(code, error);
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    };
+    
+    emit operationStarted(QString("Publication volumineuse: decoupage en %1 commit(s)...")
+                        .arg(batches.count()));
+    
+    // Index ramene a HEAD (vide avant le premier commit), arbre de travail intact
+    const bool hasHead = executeGitCommand(repoPath, QStringList() << "rev-parse" << "--verify" << "-q" << "HEAD");
+    if (!executeGitCommand(repoPath, hasHead ? QStringList() << "read-tree" << "HEAD"
+                                             : QStringList() << "read-tree" << "--empty")) {
+        return fail();
+    }
+    
+    for (int i = 0; i < batches.count(); ++i) {
+        if (m_cancelRequested) {
+            m_cancelRequested = false;
+            setError(GitError::UserCancelled, "Operation annulee par l'utilisateur.");
+            return fail();
+        }
+        
+        emit progressUpdate(i + 1, batches.count(), QString("Commit %1/%2").arg(i + 1).arg(batches.count()));
+        
+        if (!executeGitCommand(repoPath, QStringList() << "update-index" << "-z" << "--index-info",
+                               600000, indexInfo(batches.at(i)))) {
+            return fail();
+        }
+        
+        QString chunkMessage = QString("%1 (partie %2/%3)").arg(message).arg(i + 1).arg(batches.count());
+        if (!executeGitCommand(repoPath, QStringList() << "commit" << "-q" << "-m" << chunkMessage, 600000)) {
+            return fail();
+        }
+    }
+    
+    // --index-info n'enregistre pas les stat: les retrouver evite un re-hachage au prochain status
+    executeGitCommand(repoPath, QStringList() << "update-index" << "-q" << "--refresh", 600000);
+    m_repoState->invalidate(repoPath);
+    
+    emit operationSuccess(QString("%1 commit(s) crees").arg(batches.count()));
+    return true;
+}
+
+qint64 GitManager::estimatePushSize(const QString& repoPath, const QStringList& revisions) {
+    TraceSpan span("GitManager::estimatePushSize", "git");
+    // Taille sur disque des objets que le distant n'a pas encore (git >= 2.31)
+    QStringList args = { "rev-list", "--objects", "--disk-usage", "--missing=allow-promisor" };
+    args << (revisions.isEmpty() ? QStringList() << "HEAD" : revisions) << "--not" << "--remotes=origin";
+    if (executeGitCommand(repoPath, args)) {
+        bool ok = false;
+        qint64 size = m_lastStandardOutput.trimmed().toLongLong(&ok);
+        if (ok) {
+            return size;
+        }
+    }
+    
+    // Repli (git < 2.31): memes objets, tailles sur disque lues par cat-file
+    args.removeOne("--disk-usage");
+    if (!executeGitCommand(repoPath, args, 120000)) {
+        return -1;
+    }
+    
+    // Lignes: <objet> [chemin]; cat-file ne veut que l'objet
+    QByteArray objects;
+    const QStringList lines = m_lastStandardOutput.split('\n', Qt::SkipEmptyParts);
+    for (const QString& line : lines) {
+        objects += line.section(' ', 0, 0).toLatin1() + '\n';
+    }
+    if (objects.isEmpty()) {
+        return 0;
+    }
+    if (!executeGitCommand(repoPath, QStringList() << "cat-file" << "--batch-check=%(objectsize:disk)",
+                           120000, objects)) {
+        return -1;
+    }
+    
+    qint64 size = 0;
+    for (const QString& line : m_lastStandardOutput.split('\n', Qt::SkipEmptyParts)) {
+        size += line.toLongLong();
+    }
+    return size;
+}
+
+bool GitManager::readStagedEntries(const QString& repoPath, QVector<StagedEntry>& entries) {
+    entries.clear();
+    
+    // --raw: etat et identifiant du nouveau blob, sans lire aucun contenu
+    if (!executeGitCommand(repoPath, QStringList() << "diff" << "--cached" << "--raw" << "-z"
+                           << "--no-renames" << "--no-abbrev", 120000)) {
+        return false;
+    }
+    
+    // Enregistrements: ":modeA modeB shaA shaB X" NUL chemin NUL
+    const QStringList fields = m_lastStandardOutput.split(QChar('\0'), Qt::SkipEmptyParts);
+    QByteArray batch;
+    for (int i = 0; i + 1 < fields.size(); i += 2) {
+        const QString& meta = fields.at(i);
+        if (!meta.startsWith(':')) {
+            break;
+        }
+        const QStringList parts = meta.mid(1).split(' ');
+        if (parts.size() < 5) {
+            continue;
+        }
+        
+        StagedEntry entry { fields.at(i + 1), parts.at(1), parts.at(3), parts.at(4).at(0), 0 };
+        // Suppressions et sous-modules n'ont pas de blob a mesurer
+        if (entry.status != 'D' && entry.mode != "160000") {
+            batch.append(entry.blob.toLatin1());
+            batch.append('\n');
+            entry.bytes = -1;
+        }
+        entries.append(entry);
+    }
+    
+    if (batch.isEmpty()) {
+        return true;
+    }
+    if (!executeGitCommand(repoPath, QStringList() << "cat-file" << "--batch-check=%(objectsize)",
+                           120000, batch)) {
+        return false;
+    }
+    
+    // Une taille par ligne, dans l'ordre des blobs demandes
+    const QStringList sizes = m_lastStandardOutput.split('\n', Qt::SkipEmptyParts);
+    int next = 0;
+    for (StagedEntry& entry : entries) {
+        if (entry.bytes < 0) {
+            entry.bytes = sizes.value(next++).toLongLong();
+        }
+    }
+    return true;
+}
+
+bool GitManager::summarizeStagedChanges(const QString& repoPath, ChangeSummary& summary, int largestCount) {
+    TraceSpan span("GitManager::summarizeStagedChanges", "git");
+    GitMetrics::StageTimer stage(m_metrics, "status");
+    summary = ChangeSummary();
+    QElapsedTimer statusTimer;
+    statusTimer.start();
+    
+    QVector<StagedEntry> entries;
+    if (!readStagedEntries(repoPath, entries)) {
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    
+    QVector<ChangeSummary::FileChange> changes;
+    changes.reserve(entries.size());
+    for (const StagedEntry& entry : std::as_const(entries)) {
+        switch (entry.status.toLatin1()) {
+        case 'A': summary.added++; break;
+        case 'D': summary.deleted++; break;
+        default: summary.modified++; break;
+        }
+        summary.bytes += entry.bytes;
+        changes.append({ entry.path, entry.status, entry.bytes });
+    }
+    summary.files = changes.size();
+    
+    int keep = qMin(largestCount, static_cast<int>(changes.size()));
+    std::partial_sort(changes.begin(), changes.begin() + keep, changes.end(),
+                      [](const ChangeSummary::FileChange& a, const ChangeSummary::FileChange& b) {
+        return a.bytes > b.bytes;
+    });
+    summary.largest = changes.mid(0, keep);
+    
+    span.setArg("files", summary.files);
+    span.setArg("bytes", summary.bytes);
+    emit operationSuccess(QString("Etat de l'index lu: %1 fichier(s) a publier (%2 ms, %3)")
+                        .arg(summary.files).arg(statusTimer.elapsed()).arg(indexModeLabel(repoPath)));
+    return true;
+}
+
 bool GitManager::push(const QString& repoPath, const QString& branch,
                      const QString& username, const QString& token, int maxRetries) {
+    TraceSpan span("GitManager::push", "git");
+    GitMetrics::StageTimer stage(m_metrics, "push");
+    span.setArg("branch", branch);
     if (branch.isEmpty()) {
         setError(GitError::UnknownError, "Nom de branche vide.");
         emit operationFailed(m_lastError, m_lastErrorCode);
         return false;
     }
     
+    // Sondes deja faites par l'appelant (publication): valable pour ce push seulement
+    const bool connectivityVerified = m_connectivityVerified;
+    m_connectivityVerified = false;
+    
+    const QString target = pushTarget(repoPath, username, token);
+    
+    // Raccourci: le distant annonce deja notre commit, rien a envoyer
+    QString localHead;
+    const RepoState state = m_repoState->state(repoPath);
+    bool headKnown = state.headResolved && state.branch == branch;
+    if (headKnown || executeGitCommand(repoPath, QStringList() << "rev-parse" << "--verify" << "-q"
+                                       << "refs/heads/" + branch)) {
+        localHead = headKnown ? state.head : m_lastStandardOutput.trimmed();
+        QHash<QString, QString> heads;
+        if (!localHead.isEmpty() && remoteHeads(repoPath, target, heads, FastPathTimeoutMs) &&
+            heads.value(branch) == localHead) {
+            span.setArg("upToDate", true);
+            emit operationSuccess("Le depot distant est deja a jour (" + branch + ")");
+            return true;
+        }
+    }
+    
+    if (!connectivityVerified && !checkPushConnectivity()) {
+        return false;
+    }
+    
+    emit operationStarted("Push vers le depot distant...");
+    
+    bool success = false;
+    qint64 estimatedSize = (m_chunkThreshold > 0) ? estimatePushSize(repoPath) : -1;
+    
+    if (estimatedSize > m_chunkThreshold) {
+        success = pushInChunks(repoPath, target, branch, maxRetries);
+    } else {
+        QStringList args = transportConfigArgs(m_transportProfile);
+        args << "push" << target << branch;
+        success = pushWithRetry(repoPath, args, maxRetries);
+        
+        if (success) {
+            // Une URL authentifiee ne met pas a jour origin/<branche>: le faire ici
+            backendFor(repoPath)->updateRef(repoPath, "refs/remotes/origin/" + branch, "refs/heads/" + branch);
+        }
+    }
+    
+    if (!success) {
+        invalidateRemoteRefs(repoPath);
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    
+    // Le distant annonce desormais notre commit
+    auto cached = m_remoteRefCache.find(QDir(repoPath).absolutePath());
+    if (cached != m_remoteRefCache.end() && !localHead.isEmpty()) {
+        cached->heads.insert(branch, localHead);
+        cached->age.start();
+    }
+    
+    emit operationSuccess("Push effectue avec succes vers " + branch);
+    return true;
+}
+
+bool GitManager::pushBranches(const QString& repoPath, const QStringList& branches,
+                              const QString& username, const QString& token, int maxRetries) {
+    TraceSpan span("GitManager::pushBranches", "git");
+    GitMetrics::StageTimer stage(m_metrics, "push");
+    span.setArg("branches", static_cast<int>(branches.size()));
+    if (branches.isEmpty() || branches.contains(QString())) {
+        setError(GitError::UnknownError, "Nom de branche vide.");
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    
+    const bool connectivityVerified = m_connectivityVerified;
+    m_connectivityVerified = false;
+    
+    const QString target = pushTarget(repoPath, username, token);
+    
+    // Tetes locales en un processus (refnames exacts: le motif couvre aussi les sous-branches)
+    QStringList refs;
+    for (const QString& branch : branches) {
+        refs << "refs/heads/" + branch;
+    }
+    if (!executeGitCommand(repoPath, QStringList() << "for-each-ref" << "--format=%(refname)%09%(objectname)"
+                           << refs)) {
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    QHash<QString, QString> localHeads;
+    for (const QString& line : m_lastStandardOutput.split('\n', Qt::SkipEmptyParts)) {
+        const QString ref = line.section('\t', 0, 0);
+        if (refs.contains(ref)) {
+            localHeads.insert(ref.mid(QString("refs/heads/").size()), line.section('\t', 1, 1).trimmed());
+        }
+    }
+    
+    // Seules les branches que le distant n'annonce pas deja a la meme tete partent
+    QHash<QString, QString> remote;
+    const bool remoteKnown = remoteHeads(repoPath, target, remote, FastPathTimeoutMs);
+    QStringList outgoing;
+    for (const QString& branch : branches) {
+        if (!localHeads.contains(branch)) {
+            setError(GitError::UnknownError, "Branche locale introuvable: " + branch);
+            emit operationFailed(m_lastError, m_lastErrorCode);
+            return false;
+        }
+        if (!remoteKnown || remote.value(branch) != localHeads.value(branch)) {
+            outgoing << branch;
+        }
+    }
+    if (outgoing.isEmpty()) {
+        span.setArg("upToDate", true);
+        emit operationSuccess("Le depot distant est deja a jour (" + branches.join(", ") + ")");
+        return true;
+    }
+    
+    if (!connectivityVerified && !checkPushConnectivity()) {
+        return false;
+    }
+    
+    emit operationStarted(QString("Push de %1 branche(s) vers le depot distant...").arg(outgoing.size()));
+    
+    // Au-dela du seuil, meme decoupage que push(): branche par branche, lot par
+    // lot. Les objets communs partent avec la premiere branche; l'atomicite entre
+    // branches est perdue, mais chaque lot pousse reste acquis pour une reprise.
+    bool chunked = false;
+    if (m_chunkThreshold > 0) {
+        QStringList revisions;
+        for (const QString& branch : std::as_const(outgoing)) {
+            revisions << "refs/heads/" + branch;
+        }
+        chunked = estimatePushSize(repoPath, revisions) > m_chunkThreshold;
+    }
+    
+    if (chunked) {
+        // pushInChunks avance origin/<branche> apres chaque lot
+        for (const QString& branch : std::as_const(outgoing)) {
+            if (!pushInChunks(repoPath, target, branch, maxRetries)) {
+                invalidateRemoteRefs(repoPath);
+                emit operationFailed(m_lastError, m_lastErrorCode);
+                return false;
+            }
+        }
+    } else {
+        // Un seul push: les objets communs ne sont envoyes qu'une fois, et
+        // --atomic publie toutes les branches ou aucune
+        QStringList args = transportConfigArgs(m_transportProfile);
+        args << "push" << "--atomic" << target;
+        for (const QString& branch : std::as_const(outgoing)) {
+            args << QString("refs/heads/%1:refs/heads/%1").arg(branch);
+        }
+        if (!pushWithRetry(repoPath, args, maxRetries)) {
+            invalidateRemoteRefs(repoPath);
+            emit operationFailed(m_lastError, m_lastErrorCode);
+            return false;
+        }
+        
+        // Une URL authentifiee ne met pas a jour origin/*: une transaction pour toutes les branches
+        QByteArray updates;
+        for (const QString& branch : std::as_const(outgoing)) {
+            updates += QString("update refs/remotes/origin/%1 %2\n").arg(branch, localHeads.value(branch)).toUtf8();
+        }
+        if (!executeGitCommand(repoPath, QStringList() << "update-ref" << "--stdin", 30000, updates)) {
+            qWarning() << "Mise a jour de origin/* apres le push:" << m_lastError;
+        }
+    }
+    
+    auto cached = m_remoteRefCache.find(QDir(repoPath).absolutePath());
+    if (cached != m_remoteRefCache.end()) {
+        for (const QString& branch : std::as_const(outgoing)) {
+            cached->heads.insert(branch, localHeads.value(branch));
+        }
+        cached->age.start();
+    }
+    
+    emit operationSuccess("Push effectue avec succes vers " + outgoing.join(", "));
+    return true;
+}
+
+QString GitManager::pushTarget(const QString& repoPath, const QString& username, const QString& token) {
+    if (!username.isEmpty() && !token.isEmpty()) {
+        QString url = originUrl(repoPath);
+        if (!url.isEmpty()) {
+            return authenticatedUrl(url, username, token);
+        }
+    }
+    return "origin";
+}
+
+bool GitManager::checkPushConnectivity() {
     emit operationStarted("Verification de la connexion internet...");
     if (!checkInternetConnection()) {
         setError(GitError::NetworkError, 
@@ -487,37 +1769,86 @@ bool GitManager::push(const QString& repoPath, const QString& branch,
         emit operationFailed(m_lastError, m_lastErrorCode);
         return false;
     }
+    return true;
+}
+
+bool GitManager::pushInChunks(const QString& repoPath, const QString& target,
+                              const QString& branch, int maxRetries) {
+    // Commits non encore presents sur le distant, du plus ancien au plus recent.
+    // origin/<branche> avance apres chaque lot: une reprise repart du dernier lot pousse.
+    if (!executeGitCommand(repoPath, QStringList() << "rev-list" << "--reverse" << "--first-parent"
+                           << "refs/heads/" + branch << "--not" << "--remotes=origin")) {
+        return false;
+    }
     
-    emit operationStarted("Push vers le depot distant...");
+    const QStringList commits = m_lastStandardOutput.split('\n', Qt::SkipEmptyParts);
+    if (commits.isEmpty()) {
+        // Commits deja connus du distant sous une autre branche: seule la reference part
+        QStringList args = transportConfigArgs(m_transportProfile);
+        args << "push" << target << QString("refs/heads/%1:refs/heads/%1").arg(branch);
+        if (!pushWithRetry(repoPath, args, maxRetries)) {
+            return false;
+        }
+        backendFor(repoPath)->updateRef(repoPath, "refs/remotes/origin/" + branch, "refs/heads/" + branch);
+        return true;
+    }
     
-    QStringList args;
-    args << "push";
+    // Regroupement des commits consecutifs tant que le lot reste sous le seuil
+    QStringList chunkHeads;
+    QString previous;
+    qint64 chunkSize = 0;
     
-    if (!username.isEmpty() && !token.isEmpty()) {
-        if (executeGitCommand(repoPath, QStringList() << "remote" << "get-url" << "origin")) {
-            QString remoteUrl = m_lastOutput.trimmed();
-            
-            if (remoteUrl.startsWith("https://")) {
-                remoteUrl.remove(0, 8);
-                QString authenticatedUrl = QString("https://%1:%2@%3")
-                    .arg(username, token, remoteUrl);
-                args << authenticatedUrl << branch;
-            } else {
-                args << "origin" << branch;
-            }
+    for (const QString& commit : commits) {
+        QStringList args;
+        args << "rev-list" << "--objects" << "--disk-usage" << "--missing=allow-promisor" << commit;
+        if (!previous.isEmpty()) {
+            args << "^" + previous;
+        }
+        args << "--not" << "--remotes=origin";
+        
+        qint64 commitSize = executeGitCommand(repoPath, args) ? m_lastStandardOutput.trimmed().toLongLong() : 0;
+        if (!previous.isEmpty() && chunkSize > 0 && chunkSize + commitSize > m_chunkThreshold) {
+            chunkHeads << previous;
+            chunkSize = 0;
+        }
+        if (commitSize > m_chunkThreshold) {
+            qWarning() << "Le commit" << commit << "depasse a lui seul le seuil de decoupage";
+        }
+        chunkSize += commitSize;
+        previous = commit;
+    }
+    chunkHeads << previous;
+    
+    for (int i = 0; i < chunkHeads.count(); ++i) {
+        const QString& head = chunkHeads.at(i);
+        
+        emit operationStarted(QString("Push du lot %1/%2...").arg(i + 1).arg(chunkHeads.count()));
+        emit progressUpdate(i + 1, chunkHeads.count(), head.left(8));
+        
+        QStringList args = transportConfigArgs(m_transportProfile);
+        args << "push" << target << QString("%1:refs/heads/%2").arg(head, branch);
+        
+        if (!pushWithRetry(repoPath, args, maxRetries)) {
+            return false;
+        }
+        
+        GitBackend* backend = backendFor(repoPath);
+        if (!backend->updateRef(repoPath, "refs/remotes/origin/" + branch, head)) {
+            setError(backend->lastErrorCode(), backend->lastError());
+            return false;
         }
-    } else {
-        args << "origin" << branch;
     }
     
+    return true;
+}
+
+bool GitManager::pushWithRetry(const QString& repoPath, const QStringList& args, int maxRetries) {
     int attempt = 0;
-    bool success = false;
     
-    while (attempt < maxRetries && !success) {
+    while (attempt < maxRetries) {
         if (m_cancelRequested) {
             m_cancelRequested = false;
             setError(GitError::UserCancelled, "Operation annulee par l'utilisateur.");
-            emit operationFailed(m_lastError, m_lastErrorCode);
             return false;
         }
         
@@ -529,18 +1860,20 @@ bool GitManager::push(const QString& repoPath, const QString& branch,
             
             if (!checkInternetConnection()) {
                 qWarning() << "Connexion perdue, attente avant retry...";
+                m_metrics.recordRetry(GitError::NetworkError);
                 waitBeforeRetry(attempt);
                 attempt++;
                 continue;
             }
         }
         
-        if (executeGitCommand(repoPath, args, 120000)) {
-            success = true;
-            break;
+        if (executeGitCommand(repoPath, args, m_pushTimeoutMs)) {
+            return true;
         }
         
-        GitError errorType = detectErrorType(m_lastError);
+        // Classement sur la sortie brute: m_lastError est deja traduite. Sans
+        // sortie (timeout, annulation), le code pose par executeGitCommand suffit
+        GitError errorType = m_lastRawError.isEmpty() ? m_lastErrorCode : detectErrorType(m_lastRawError);
         
         if (!shouldRetry(errorType)) {
             if (errorType == GitError::AuthenticationFailed) {
@@ -559,49 +1892,44 @@ bool GitManager::push(const QString& repoPath, const QString& branch,
                         "- Vos permissions d'acces au depot");
             }
             
-            emit operationFailed(m_lastError, m_lastErrorCode);
             return false;
         }
         
         if (attempt < maxRetries - 1) {
+            m_metrics.recordRetry(errorType);
             waitBeforeRetry(attempt);
         }
         
         attempt++;
     }
     
-    if (!success) {
-        setError(GitError::NetworkError,
-                QString("Echec apres %1 tentatives.\n\n"
-                       "Erreur: %2\n\n"
-                       "Suggestions:\n"
-                       "- Verifiez votre connexion internet\n"
-                       "- Verifiez vos parametres proxy\n"
-                       "- Reessayez plus tard")
-                    .arg(maxRetries)
-                    .arg(m_lastError));
-        emit operationFailed(m_lastError, m_lastErrorCode);
-        return false;
-    }
-    
-    emit operationSuccess("Push effectue avec succes vers " + branch);
-    return true;
+    setError(GitError::NetworkError,
+            QString("Echec apres %1 tentatives.\n\n"
+                   "Erreur: %2\n\n"
+                   "Suggestions:\n"
+                   "- Verifiez votre connexion internet\n"
+                   "- Verifiez vos parametres proxy\n"
+                   "- Reessayez plus tard")
+                .arg(maxRetries)
+                .arg(m_lastError));
+    return false;
 }
 
 bool GitManager::pull(const QString& repoPath, const QString& branch,
                       const QString& username, const QString& token) {
+    TraceSpan span("GitManager::pull", "git");
+    GitMetrics::StageTimer stage(m_metrics, "pull");
+    span.setArg("branch", branch);
     emit operationStarted("Recuperation des modifications distantes...");
     
     // Récupérer l'URL du remote
-    QString remoteUrl;
-    if (executeGitCommand(repoPath, QStringList() << "remote" << "get-url" << "origin")) {
-        remoteUrl = m_lastOutput.trimmed();
-    } else {
+    QString remoteUrl = originUrl(repoPath);
+    if (remoteUrl.isEmpty()) {
         emit operationFailed("Impossible de recuperer l'URL du depot distant", GitError::RemoteNotFound);
         return false;
     }
     
-    QStringList args;
+    QStringList args = transportConfigArgs(m_transportProfile);
     args << "pull";
     
     // Construire l'URL avec authentification si nécessaire
@@ -627,9 +1955,12 @@ bool GitManager::pull(const QString& repoPath, const QString& branch,
 
 bool GitManager::pullRebase(const QString& repoPath, const QString& branch,
                             const QString& username, const QString& token) {
+    TraceSpan span("GitManager::pullRebase", "git");
+    GitMetrics::StageTimer stage(m_metrics, "pull");
+    span.setArg("branch", branch);
     emit operationStarted("Recuperation et rebase des modifications...");
     
-    QStringList args;
+    QStringList args = transportConfigArgs(m_transportProfile);
     args << "pull" << "--rebase" << "origin" << branch;
     
     bool success = executeGitCommand(repoPath, args);
@@ -644,69 +1975,187 @@ bool GitManager::pullRebase(const QString& repoPath, const QString& branch,
 }
 
 bool GitManager::checkRemoteStatus(const QString& repoPath, const QString& branch) {
-    // Fetch pour voir les changements distants
-    QStringList fetchArgs;
-    fetchArgs << "fetch" << "origin" << branch;
+    TraceSpan span("GitManager::checkRemoteStatus", "git");
+    GitMetrics::StageTimer stage(m_metrics, "fetch");
+    span.setArg("branch", branch);
     
-    if (!executeGitCommand(repoPath, fetchArgs)) {
+    // Annonce des references seulement: aucun objet n'est telecharge
+    QHash<QString, QString> heads;
+    if (!remoteHeads(repoPath, "origin", heads)) {
         return false;
     }
     
-    // Comparer local vs distant
-    QStringList statusArgs;
-    statusArgs << "rev-list" << "--count" 
-               << QString("HEAD..origin/%1").arg(branch);
+    QString remoteHead = heads.value(branch);
+    if (remoteHead.isEmpty()) {
+        return true; // Branche absente du distant: rien a recuperer
+    }
     
-    if (executeGitCommand(repoPath, statusArgs)) {
-        int commitsAhead = m_lastOutput.trimmed().toInt();
-        return commitsAhead == 0; // Retourne true si à jour
+    const RepoState state = m_repoState->state(repoPath);
+    if (state.headResolved && state.head == remoteHead) {
+        return true; // Meme commit: a jour sans lancer git
     }
     
-    return false;
+    // Commit distant inconnu localement ou hors de l'historique de HEAD: en retard
+    return executeGitCommand(repoPath, QStringList() << "merge-base" << "--is-ancestor"
+                             << remoteHead << "HEAD");
 }
 
-bool GitManager::executeGitCommand(const QString& workingDir, const QStringList& arguments, int timeoutMs) {
-    m_lastError.clear();
-    m_lastOutput.clear();
-    m_lastErrorCode = GitError::None;
-    m_operationRunning = true;
-    m_cancelRequested = false;
+bool GitManager::remoteHeads(const QString& repoPath, const QString& target, QHash<QString, QString>& heads,
+                             int timeoutMs) {
+    const QString key = QDir(repoPath).absolutePath();
+    auto cached = m_remoteRefCache.constFind(key);
+    if (cached != m_remoteRefCache.constEnd() && m_remoteRefCacheTtlMs > 0 &&
+        cached->age.isValid() && cached->age.elapsed() < m_remoteRefCacheTtlMs) {
+        heads = cached->heads;
+        return true;
+    }
     
-    if (!QDir(workingDir).exists()) {
-        setError(GitError::InvalidRepository, "Repertoire inexistant: " + workingDir);
-        m_operationRunning = false;
+    QStringList args = transportConfigArgs(m_transportProfile);
+    args << "ls-remote" << "--heads" << target;
+    if (!executeGitCommand(repoPath, args, timeoutMs)) {
         return false;
     }
     
-    m_process->setWorkingDirectory(workingDir);
+    // Lignes: <sha> TAB refs/heads/<branche>
+    heads.clear();
+    const QStringList lines = m_lastStandardOutput.split('\n', Qt::SkipEmptyParts);
+    for (const QString& line : lines) {
+        int tab = line.indexOf('\t');
+        if (tab > 0 && line.mid(tab + 1).startsWith("refs/heads/")) {
+            heads.insert(line.mid(tab + 1 + QString("refs/heads/").size()).trimmed(), line.left(tab));
+        }
+    }
+    
+    RemoteRefSnapshot& snapshot = m_remoteRefCache[key];
+    snapshot.heads = heads;
+    snapshot.age.start();
+    return true;
+}
+
+void GitManager::invalidateRemoteRefs(const QString& repoPath) {
+    if (repoPath.isEmpty()) {
+        m_remoteRefCache.clear();
+    } else {
+        m_remoteRefCache.remove(QDir(repoPath).absolutePath());
+    }
+}
+
+bool GitManager::executeGitCommand(const QString& workingDir, const QStringList& arguments, int timeoutMs,
+                                   const QByteArray& standardInput) {
+    TraceSpan span("git", "process");
+    if (span.isActive()) {
+        span.setArg("args", Tracer::redactCredentials(arguments.join(' ')));
+        span.setArg("cwd", workingDir);
+    }
+    
+    // Une annulation ne vaut que pour l'operation en cours
+    if (!m_operationRunning) {
+        m_cancelRequested = false;
+    }
+    OperationScope scope(m_operationRunning);
+    
+    m_lastError.clear();
+    m_lastOutput.clear();
+    m_lastStandardOutput.clear();
+    m_lastRawError.clear();
+    m_lastErrorCode = GitError::None;
+    
+    if (m_cancelRequested) {
+        setError(GitError::UserCancelled, "Operation annulee par l'utilisateur.");
+        return false;
+    }
+    
+    if (!QDir(workingDir).exists()) {
+        setError(GitError::InvalidRepository, "Repertoire inexistant: " + workingDir);
+        return false;
+    }
+    
+    // Appel arrive pendant l'attente d'une autre commande (clic traite par la
+    // boucle d'evenements): le processus unique est deja occupe
+    if (m_processBusy) {
+        setError(GitError::ProcessFailed, "Une autre commande Git est deja en cours.");
+        return false;
+    }
+    m_processBusy = true;
+    emit busyChanged(true);
+    auto releaseProcess = qScopeGuard([this]() {
+        m_processBusy = false;
+        emit busyChanged(false);
+    });
+    
+    // Verrous deja presents: jamais supprimes apres une interruption
+    const QStringList locksBefore = existingLocks(workingDir);
+    QDateTime startedAt = QDateTime::currentDateTime();
+    QElapsedTimer processTimer;
+    processTimer.start();
+    m_process->setWorkingDirectory(workingDir);
     m_process->start("git", arguments);
     
     if (!m_process->waitForStarted(5000)) {
         setError(GitError::ProcessFailed, "Impossible de demarrer Git. Verifiez qu'il est installe.");
-        m_operationRunning = false;
         return false;
     }
     
-    if (!m_process->waitForFinished(timeoutMs)) {
-        if (m_cancelRequested) {
-            m_process->kill();
-            setError(GitError::UserCancelled, "Operation annulee par l'utilisateur.");
-        } else {
-            m_process->kill();
-            setError(GitError::Timeout, QString("Timeout apres %1 secondes.").arg(timeoutMs / 1000));
+    attachToProcessTree();
+    
+    // Entree fournie: ecrite par la boucle d'evenements, puis fermee
+    if (!standardInput.isEmpty()) {
+        m_process->write(standardInput);
+        m_process->closeWriteChannel();
+    }
+    
+    // Attente dans une boucle d'evenements: l'interface reste reactive et
+    // cancelOperation() peut tuer le processus pendant l'attente.
+    if (m_process->state() != QProcess::NotRunning) {
+        QEventLoop loop;
+        connect(m_process, &QProcess::finished, &loop, &QEventLoop::quit);
+        
+        QTimer timer;
+        timer.setSingleShot(true);
+        connect(&timer, &QTimer::timeout, &loop, &QEventLoop::quit);
+        if (timeoutMs > 0) {
+            timer.start(timeoutMs);
         }
-        m_operationRunning = false;
+        
+        loop.exec();
+        
+        // Un appel refuse pendant l'attente a pu ecrire son erreur
+        m_lastError.clear();
+        m_lastErrorCode = GitError::None;
+    }
+    
+    m_metrics.recordProcess(processTimer.elapsed());
+    
+    // Les notifications du cache arrivent plus tard: ne pas relire un etat perime
+    if (!isReadOnlyCommand(arguments)) {
+        m_repoState->invalidate(workingDir);
+    }
+    
+    if (m_process->state() != QProcess::NotRunning) {
+        killProcessTree();
+        // Arbre encore vivant: ses verrous sont peut-etre encore utilises
+        if (m_process->waitForFinished(1000)) {
+            cleanupStaleLocks(workingDir, locksBefore, startedAt);
+        }
+        setError(GitError::Timeout, QString("Timeout apres %1 secondes.").arg(timeoutMs / 1000));
         return false;
     }
     
-    m_lastOutput = QString::fromUtf8(m_process->readAllStandardOutput());
-    QString errorOutput = QString::fromUtf8(m_process->readAllStandardError());
+    if (m_cancelRequested) {
+        recordCancelLatency();
+        cleanupStaleLocks(workingDir, locksBefore, startedAt);
+        setError(GitError::UserCancelled, "Operation annulee par l'utilisateur.");
+        return false;
+    }
     
-    m_operationRunning = false;
+    m_lastStandardOutput = QString::fromUtf8(m_process->readAllStandardOutput());
+    m_lastOutput = m_lastStandardOutput;
+    QString errorOutput = QString::fromUtf8(m_process->readAllStandardError());
+    span.setArg("exitCode", m_process->exitCode());
     
-    if (m_process->exitCode() != 0) {
-        QString errorMsg = errorOutput.isEmpty() ? m_lastOutput : errorOutput;
-        errorMsg = getGitErrorMessage(errorMsg);
+    if (m_process->exitStatus() != QProcess::NormalExit || m_process->exitCode() != 0) {
+        m_lastRawError = errorOutput.isEmpty() ? m_lastOutput : errorOutput;
+        QString errorMsg = getGitErrorMessage(m_lastRawError);
         
         if (errorMsg.contains("authentication", Qt::CaseInsensitive)) {
             setError(GitError::AuthenticationFailed, errorMsg);
@@ -732,9 +2181,9 @@ bool GitManager::executeGitCommand(const QString& workingDir, const QStringList&
 }
 
 int GitManager::copyDirectoryRecursively(const QString& sourcePath, const QString& destPath, 
-                                         QStringList& copiedFiles) {
-    QDir sourceDir(sourcePath);
-    if (!sourceDir.exists()) {
+                                         CompactPathList& copiedFiles) {
+    DirWalker walker(sourcePath, m_symlinkPolicy, m_includeHidden);
+    if (!walker.isValid()) {
         return 0;
     }
     
@@ -743,66 +2192,469 @@ int GitManager::copyDirectoryRecursively(const QString& sourcePath, const QStrin
         destDir.mkpath(destPath);
     }
     
+    // Dossier de destination relatif a la racine de la liste
+    QString destRoot = copiedFiles.root().isEmpty()
+        ? destDir.absolutePath()
+        : QDir(copiedFiles.root()).relativeFilePath(destDir.absolutePath());
+    if (destRoot == ".") {
+        destRoot.clear();
+    }
+    
     int count = 0;
+    DirWalker::Entry entry;
+    QString currentDir;
+    QString listDir = destRoot;
+    
+    // Indexation au fil de l'eau: les fichiers d'un dossier qui contient un
+    // .gitignore ou un .gitattributes attendent que ces regles soient copiees
+    bool firstFile = true;
+    int pendingRules = 0;
+    qsizetype deferredFrom = -1;
+    auto flushDeferred = [this, &copiedFiles, &deferredFrom]() {
+        if (deferredFrom >= 0) {
+            for (qsizetype i = deferredFrom; i < copiedFiles.size(); ++i) {
+                m_stagingPipeline->submit(copiedFiles.relativePathUtf8(i));
+            }
+            deferredFrom = -1;
+        }
+    };
     
-    // Copier tous les fichiers du dossier actuel
-    QFileInfoList files = sourceDir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
-    for (const QFileInfo& fileInfo : files) {
+    while (walker.next(entry)) {
         if (m_cancelRequested) {
             return count;
         }
         
-        QString destFile = destDir.filePath(fileInfo.fileName());
+        if (entry.isDirectory) {
+            destDir.mkpath(entry.relativePath());
+            continue;
+        }
         
-        // Supprimer si existe déjà
-        if (QFile::exists(destFile)) {
-            QFile::remove(destFile);
+        // Les fichiers d'un dossier arrivent ensemble: chemin relatif recalcule au changement
+        if (firstFile || entry.relativeDir != currentDir) {
+            firstFile = false;
+            currentDir = entry.relativeDir;
+            listDir = destRoot.isEmpty() ? currentDir
+                    : currentDir.isEmpty() ? destRoot : destRoot + '/' + currentDir;
+            
+            if (m_stagingPipeline) {
+                flushDeferred();
+                // Regles attendues seulement si le parcours les renvoie (entrees cachees)
+                QString sourceDir = currentDir.isEmpty() ? sourcePath : sourcePath + '/' + currentDir;
+                pendingRules = walker.includesHidden()
+                    ? int(QFile::exists(sourceDir + "/.gitignore")) + int(QFile::exists(sourceDir + "/.gitattributes"))
+                    : 0;
+                deferredFrom = pendingRules > 0 ? copiedFiles.size() : -1;
+            }
         }
         
-        if (QFile::copy(fileInfo.filePath(), destFile)) {
-            copiedFiles << destFile;
+        QString destFile = destDir.filePath(entry.relativePath());
+        
+        // Copie par blocs: l'annulation interrompt aussi les gros fichiers
+        if (copyFileInterruptible(walker.absolutePath(entry), destFile)) {
+            copiedFiles.append(listDir, entry.name);
             count++;
-            emit progressUpdate(count, -1, fileInfo.fileName());
-        } else {
-            qWarning() << "Echec de copie:" << fileInfo.filePath() << "vers" << destFile;
+            emit progressUpdate(++m_progressDone, m_progressTotal, entry.name);
+            
+            if (m_stagingPipeline) {
+                if (entry.name == ".gitignore" || entry.name == ".gitattributes") {
+                    --pendingRules;
+                }
+                if (deferredFrom < 0) {
+                    m_stagingPipeline->submit(copiedFiles.relativePathUtf8(copiedFiles.size() - 1));
+                } else if (pendingRules == 0) {
+                    flushDeferred();
+                }
+            }
+        } else if (!m_cancelRequested) {
+            qWarning() << "Echec de copie:" << walker.absolutePath(entry) << "vers" << destFile;
         }
     }
     
-    // Copier recursivement tous les sous-dossiers
-    QFileInfoList dirs = sourceDir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
-    for (const QFileInfo& dirInfo : dirs) {
-        if (m_cancelRequested) {
-            return count;
+    if (m_stagingPipeline && !m_cancelRequested) {
+        flushDeferred();
+    }
+    
+    for (const QString& error : walker.errors()) {
+        qWarning() << "Parcours de" << sourcePath << ":" << error;
+    }
+    
+    return count;
+}
+
+int GitManager::mirrorDirectory(const QString& sourcePath, const QString& destPath,
+                                CompactPathList& copiedFiles, CompactPathList& removedFiles,
+                                MirrorSummary& summary) {
+    QDir destDir(destPath);
+    if (!QFileInfo(sourcePath).isDir() || (!destDir.exists() && !destDir.mkpath("."))) {
+        return 0;
+    }
+    
+    // Dossier de destination relatif a la racine des listes
+    QString destRoot = copiedFiles.root().isEmpty()
+        ? destDir.absolutePath()
+        : QDir(copiedFiles.root()).relativeFilePath(destDir.absolutePath());
+    if (destRoot == ".") {
+        destRoot.clear();
+    }
+    
+    int count = 0;
+    QSet<QString> visited; // Liens de dossiers suivis: chaque dossier une seule fois
+    
+    // Profondeur d'abord, pile explicite: seules les listes du dossier courant
+    // sont en memoire, quelle que soit la taille de l'arborescence
+    QStringList pending = { QString() };
+    while (!pending.isEmpty() && !m_cancelRequested) {
+        const QString relativeDir = pending.takeLast();
+        const QString sourceDir = relativeDir.isEmpty() ? sourcePath : sourcePath + '/' + relativeDir;
+        const QString targetDir = relativeDir.isEmpty() ? destDir.absolutePath()
+                                                        : destDir.absolutePath() + '/' + relativeDir;
+        const QString listDir = destRoot.isEmpty() ? relativeDir
+                              : relativeDir.isEmpty() ? destRoot : destRoot + '/' + relativeDir;
+        
+        if (m_symlinkPolicy == DirWalker::SymlinkPolicy::FollowAll) {
+            const QString canonical = QFileInfo(sourceDir).canonicalFilePath();
+            if (visited.contains(canonical)) {
+                qWarning() << "Cycle de liens ignore:" << sourceDir;
+                continue;
+            }
+            visited.insert(canonical);
+        }
+        
+        // Depot imbrique cote destination: ses fichiers ne sont pas ceux du
+        // depot publie, rien n'y est copie ni supprime
+        bool nested = false;
+        const QVector<MirrorEntry> dest = listMirrorDirectory(targetDir, m_symlinkPolicy, false, m_includeHidden,
+                                                              &nested);
+        if (nested) {
+            qWarning() << "Depot imbrique laisse intact:" << targetDir;
+            ++summary.failed;
+            continue;
+        }
+        const QVector<MirrorEntry> source = listMirrorDirectory(sourceDir, m_symlinkPolicy, true, m_includeHidden);
+        
+        // Fusion des deux listes triees. Les suppressions passent avant les
+        // copies: un renommage de casse ne supprime pas le fichier qui vient
+        // d'etre copie sur un systeme de fichiers insensible a la casse
+        const qsizetype removedFrom = removedFiles.size();
+        QVector<QPair<qsizetype, bool>> toCopy; // Index dans source, fichier deja present
+        QStringList subdirs;
+        qsizetype s = 0;
+        qsizetype d = 0;
+        while ((s < source.size() || d < dest.size()) && !m_cancelRequested) {
+            const int order = s == source.size() ? 1
+                            : d == dest.size() ? -1
+                            : source.at(s).name.compare(dest.at(d).name);
+            
+            if (order > 0) {
+                // Absent de la source: supprime
+                const MirrorEntry& gone = dest.at(d++);
+                count += removeMirroredEntry(targetDir, listDir, gone.name, gone.isDirectory, removedFiles,
+                                             summary);
+                continue;
+            }
+            
+            const MirrorEntry& entry = source.at(s);
+            bool present = false;
+            if (order == 0) {
+                const MirrorEntry& existing = dest.at(d++);
+                if (existing.isDirectory != entry.isDirectory) {
+                    count += removeMirroredEntry(targetDir, listDir, existing.name, existing.isDirectory,
+                                                 removedFiles, summary);
+                } else if (!entry.isDirectory && existing.size == entry.size &&
+                           existing.modified.toSecsSinceEpoch() == entry.modified.toSecsSinceEpoch()) {
+                    ++summary.unchanged;
+                    emit progressUpdate(++m_progressDone, m_progressTotal, entry.name);
+                    pumpEvents();
+                    ++s;
+                    continue;
+                } else {
+                    present = !entry.isDirectory;
+                }
+            }
+            
+            if (entry.isDirectory) {
+                subdirs << entry.name;
+            } else {
+                toCopy.append(qMakePair(s, present));
+            }
+            ++s;
         }
         
-        QString subDestPath = destDir.filePath(dirInfo.fileName());
-        count += copyDirectoryRecursively(dirInfo.filePath(), subDestPath, copiedFiles);
+        // .gitignore et .gitattributes d'abord: l'indexation lit les regles du
+        // dossier au premier chemin qui s'y trouve
+        std::stable_partition(toCopy.begin(), toCopy.end(), [&source](const QPair<qsizetype, bool>& copy) {
+            const QString& name = source.at(copy.first).name;
+            return name == ".gitignore" || name == ".gitattributes";
+        });
+        
+        for (const QPair<qsizetype, bool>& copy : std::as_const(toCopy)) {
+            if (m_cancelRequested) {
+                break;
+            }
+            
+            const MirrorEntry& entry = source.at(copy.first);
+            const QString destFile = targetDir + '/' + entry.name;
+            if (!copyFileInterruptible(sourceDir + '/' + entry.name, destFile)) {
+                if (!m_cancelRequested) {
+                    qWarning() << "Echec de copie:" << sourceDir + '/' + entry.name << "vers" << destFile;
+                }
+                continue;
+            }
+            
+            // Date de la source reportee: la prochaine comparaison retrouve l'egalite
+            // (une copie en lecture seule est rouverte en ecriture le temps de la dater)
+            QFile copied(destFile);
+            const QFile::Permissions permissions = copied.permissions();
+            if (!(permissions & QFile::WriteOwner)) {
+                copied.setPermissions(permissions | QFile::WriteOwner);
+            }
+            if (!copied.open(QIODevice::Append) ||
+                !copied.setFileTime(entry.modified, QFileDevice::FileModificationTime)) {
+                qWarning() << "Date non reportee, le fichier sera recopie:" << destFile;
+            }
+            copied.close();
+            if (!(permissions & QFile::WriteOwner)) {
+                copied.setPermissions(permissions);
+            }
+            
+            copiedFiles.append(listDir, entry.name);
+            ++(copy.second ? summary.changed : summary.added);
+            ++count;
+            emit progressUpdate(++m_progressDone, m_progressTotal, entry.name);
+            
+            if (m_stagingPipeline) {
+                m_stagingPipeline->submit(copiedFiles.relativePathUtf8(copiedFiles.size() - 1));
+            }
+        }
+        
+        // Suppressions transmises apres les regles du dossier (update-index --remove)
+        if (m_stagingPipeline && !m_cancelRequested) {
+            for (qsizetype i = removedFrom; i < removedFiles.size(); ++i) {
+                m_stagingPipeline->submit(removedFiles.relativePathUtf8(i));
+            }
+        }
+        summary.removed += removedFiles.size() - removedFrom;
+        
+        for (auto it = subdirs.crbegin(); it != subdirs.crend(); ++it) {
+            pending << (relativeDir.isEmpty() ? *it : relativeDir + '/' + *it);
+        }
     }
     
     return count;
 }
 
+int GitManager::removeMirroredEntry(const QString& dirPath, const QString& listDir, const QString& name,
+                                    bool isDirectory, CompactPathList& removedFiles, MirrorSummary& summary) {
+    const QString path = dirPath + '/' + name;
+    const QString listPath = listDir.isEmpty() ? name : listDir + '/' + name;
+    
+    if (!isDirectory) {
+        if (!QFile::remove(path)) {
+            qWarning() << "Suppression impossible:" << path;
+            ++summary.failed;
+            return 0;
+        }
+        removedFiles.append(listDir, name);
+        return 1;
+    }
+    
+    // Fichiers releves avant la suppression: l'index doit les oublier un par un
+    const qsizetype removedFrom = removedFiles.size();
+    DirWalker walker(path, DirWalker::SymlinkPolicy::FollowFiles, true);
+    DirWalker::Entry entry;
+    while (walker.next(entry)) {
+        if (!entry.isDirectory) {
+            removedFiles.append(entry.relativeDir.isEmpty() ? listPath : listPath + '/' + entry.relativeDir,
+                                entry.name);
+        }
+    }
+    
+    // Un depot imbrique (clone, sous-module) n'est jamais supprime avec son historique
+    if (walker.foundGitDir()) {
+        qWarning() << "Dossier contenant un depot Git conserve:" << path;
+        removedFiles.truncate(removedFrom);
+        ++summary.failed;
+        return 0;
+    }
+    
+    // Fichiers restants: update-index --remove les garde dans l'index
+    if (!QDir(path).removeRecursively()) {
+        qWarning() << "Suppression incomplete:" << path;
+        ++summary.failed;
+    }
+    return static_cast<int>(removedFiles.size() - removedFrom);
+}
+
+bool GitManager::extractArchive(const QString& archivePath, const QString& destPath,
+                                CompactPathList& copiedFiles, int& count) {
+    count = 0;
+    ArchiveReader reader(archivePath);
+    if (!reader.open()) {
+        setError(GitError::FileNotFound,
+                 QString("Archive illisible: %1 (%2)").arg(archivePath, reader.errorString()));
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    
+    QDir destDir(destPath);
+    if (!destDir.exists()) {
+        destDir.mkpath(destPath);
+    }
+    
+    QString destRoot = copiedFiles.root().isEmpty()
+        ? destDir.absolutePath()
+        : QDir(copiedFiles.root()).relativeFilePath(destDir.absolutePath());
+    if (destRoot == ".") {
+        destRoot.clear();
+    }
+    
+    // L'ordre des entrees d'une archive est quelconque: un .gitignore peut
+    // arriver apres les fichiers qu'il exclut. L'indexation attend donc la fin
+    // de l'archive (la liste ne garde que des indices, la memoire reste bornee).
+    const qsizetype submitFrom = copiedFiles.size();
+    
+    ArchiveReader::Entry entry;
+    QString createdDir;
+    while (reader.next(entry)) {
+        if (m_cancelRequested) {
+            return false;
+        }
+        
+        if (entry.isDirectory) {
+            destDir.mkpath(entry.path);
+            continue;
+        }
+        
+        int slash = entry.path.lastIndexOf('/');
+        QString relativeDir = slash < 0 ? QString() : entry.path.left(slash);
+        QString name = entry.path.mid(slash + 1);
+        
+        // Les dossiers parents ne sont pas toujours decrits par l'archive
+        if (relativeDir != createdDir) {
+            destDir.mkpath(relativeDir.isEmpty() ? QString(".") : relativeDir);
+            createdDir = relativeDir;
+        }
+        
+        QString destFile = destDir.filePath(entry.path);
+        if (extractEntryInterruptible(reader, destFile, entry.permissions)) {
+            QString listDir = destRoot.isEmpty() ? relativeDir
+                            : relativeDir.isEmpty() ? destRoot : destRoot + '/' + relativeDir;
+            copiedFiles.append(listDir, name);
+            count++;
+            emit progressUpdate(++m_progressDone, m_progressTotal, name);
+        } else if (m_cancelRequested) {
+            return false;
+        } else if (!reader.errorString().isEmpty()) {
+            break; // Archive tronquee ou somme de controle fausse: fin de l'extraction
+        } else {
+            qWarning() << "Echec d'extraction:" << entry.path << "vers" << destFile;
+        }
+    }
+    
+    for (const QString& error : reader.errors()) {
+        qWarning() << "Archive" << archivePath << ":" << error;
+    }
+    
+    // Contenu incomplet: rien n'est indexe et la publication s'arrete
+    if (!reader.errorString().isEmpty()) {
+        setError(GitError::UnknownError,
+                 QString("Archive %1 corrompue apres %2 fichier(s): %3")
+                 .arg(QFileInfo(archivePath).fileName()).arg(count).arg(reader.errorString()));
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    
+    if (m_stagingPipeline) {
+        for (qsizetype i = submitFrom; i < copiedFiles.size(); ++i) {
+            m_stagingPipeline->submit(copiedFiles.relativePathUtf8(i));
+        }
+    }
+    
+    return true;
+}
+
 bool GitManager::copyProjectRecursively(const QString& repoPath, const QStringList& paths, 
                                         bool preserveStructure) {
+    TraceSpan span("GitManager::copyProjectRecursively", "git");
+    GitMetrics::StageTimer stage(m_metrics, "copy");
+    span.setArg("paths", static_cast<int>(paths.size()));
+    // Rien d'une copie precedente ne survit a un echec ou une annulation
+    m_copiedFiles = CompactPathList();
+    m_removedFiles = CompactPathList();
+    // Change set exact seulement pour un miroir seul depuis le dernier ajout
+    const bool firstSinceAdd = !m_copyPendingAdd;
+    m_copyPendingAdd = true;
+    m_exactChangeSet = false;
+    m_changeSetStaged = false;
     if (paths.isEmpty()) {
         setError(GitError::FileNotFound, "Aucun fichier ou dossier a copier.");
         emit operationFailed(m_lastError, m_lastErrorCode);
         return false;
     }
     
-    QStringList allCopiedFiles;
+    if (!m_operationRunning) {
+        m_cancelRequested = false;
+    }
+    OperationScope scope(m_operationRunning);
+    
+    CompactPathList allCopiedFiles(QDir(repoPath).absolutePath());
+    CompactPathList allRemovedFiles(QDir(repoPath).absolutePath());
+    m_mirrorSummary = MirrorSummary();
+    bool mirrored = false;
+    bool onlyMirrored = true;
     int totalCount = 0;
     
-    emit operationStarted(QString("Copie de %1 element(s)...").arg(paths.count()));
+    // Pre-parcours sans stat: donne un total a la progression
+    emit operationStarted(QString("Analyse de %1 element(s)...").arg(paths.count()));
+    m_progressDone = 0;
+    m_progressTotal = 0;
+    bool totalKnown = true;
+    QSet<QString> archives;
+    for (const QString& path : paths) {
+        if (m_archiveExtraction && QFileInfo(path).isFile() && ArchiveReader::isArchive(path)) {
+            // Zip: repertoire central; tar: total inconnu sans tout decompresser
+            archives.insert(path);
+            ArchiveReader reader(path);
+            qint64 files = reader.open() ? reader.fileCount() : -1;
+            totalKnown = totalKnown && files >= 0;
+            m_progressTotal += static_cast<int>(qMax<qint64>(files, 0));
+            continue;
+        }
+        m_progressTotal += static_cast<int>(DirWalker::countFiles(path, m_symlinkPolicy, m_includeHidden));
+    }
+    if (!totalKnown) {
+        m_progressTotal = 0;
+    }
+    
+    emit operationStarted(QString("Copie de %1 fichier(s)...").arg(m_progressTotal));
     
     QDir repoDir(repoPath);
+    QDir targetDir(m_publishSubdirectory.isEmpty() ? repoPath : repoDir.filePath(m_publishSubdirectory));
+    if (!targetDir.exists() && !targetDir.mkpath(".")) {
+        setError(GitError::InvalidRepository, "Impossible de creer le repertoire: " + targetDir.path());
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    
+    // Depot existant: hachage et indexation en parallele de la copie
+    QDateTime startedAt = QDateTime::currentDateTime();
+    const QStringList locksBefore = existingLocks(repoPath);
+    QScopedPointer<StagingPipeline> pipeline;
+    if (m_pipelinedStaging && QFileInfo::exists(repoDir.filePath(".git"))) {
+        pipeline.reset(new StagingPipeline(repoDir.absolutePath()));
+        if (pipeline->start()) {
+            m_stagingPipeline = pipeline.data();
+        } else {
+            emit operationWarning("Indexation au fil de la copie indisponible (" + pipeline->errorString() +
+                                  "), les fichiers seront indexes apres la copie");
+            pipeline.reset();
+        }
+    }
+    auto detachPipeline = qScopeGuard([this]() { m_stagingPipeline = nullptr; });
     
     for (const QString& path : paths) {
         if (m_cancelRequested) {
-            m_cancelRequested = false;
-            setError(GitError::UserCancelled, "Operation annulee par l'utilisateur.");
-            emit operationFailed(m_lastError, m_lastErrorCode);
-            return false;
+            break;
         }
         
         QFileInfo pathInfo(path);
@@ -812,66 +2664,450 @@ bool GitManager::copyProjectRecursively(const QString& repoPath, const QStringLi
             continue;
         }
         
-        if (pathInfo.isFile()) {
-            // Copier un fichier unique
-            QString destFile = repoDir.filePath(pathInfo.fileName());
+        if (archives.contains(path)) {
+            // Archive lue en flux, entrees ecrites directement dans le depot
+            QString folderName = ArchiveReader::baseName(path);
+            onlyMirrored = false;
+            
+            emit operationStarted(QString("Extraction de l'archive: %1...").arg(pathInfo.fileName()));
             
-            if (QFile::exists(destFile)) {
-                QFile::remove(destFile);
+            int archiveCount = 0;
+            bool extracted = extractArchive(path, targetDir.filePath(folderName), allCopiedFiles, archiveCount);
+            totalCount += archiveCount;
+            
+            if (m_cancelRequested) {
+                break;
+            }
+            if (!extracted) {
+                // Erreur deja signalee; l'indexation en cours est abandonnee
+                m_progressTotal = -1;
+                if (pipeline) {
+                    pipeline->abort();
+                    cleanupStaleLocks(repoPath, locksBefore, startedAt);
+                }
+                return false;
             }
             
-            if (QFile::copy(path, destFile)) {
-                allCopiedFiles << destFile;
+            emit operationSuccess(QString("Archive %1: %2 fichier(s) extrait(s) dans %3")
+                                .arg(pathInfo.fileName())
+                                .arg(archiveCount)
+                                .arg(folderName));
+            
+        } else if (pathInfo.isFile()) {
+            // Copier un fichier unique
+            QString destFile = targetDir.filePath(pathInfo.fileName());
+            onlyMirrored = false;
+            
+            if (copyFileInterruptible(path, destFile)) {
+                allCopiedFiles.append(m_publishSubdirectory, pathInfo.fileName());
                 totalCount++;
+                emit progressUpdate(++m_progressDone, m_progressTotal, pathInfo.fileName());
+                if (m_stagingPipeline) {
+                    m_stagingPipeline->submit(allCopiedFiles.relativePathUtf8(allCopiedFiles.size() - 1));
+                }
                 emit operationStarted(QString("Copie: %1").arg(pathInfo.fileName()));
-            } else {
+            } else if (!m_cancelRequested) {
                 qWarning() << "Echec de copie:" << path;
             }
             
+        } else if (pathInfo.isDir() && m_mirrorMode) {
+            // Miroir: seules les differences sont appliquees, suppressions comprises
+            QString folderName = pathInfo.fileName();
+            
+            emit operationStarted(QString("Synchronisation miroir du dossier: %1...").arg(folderName));
+            
+            MirrorSummary summary;
+            totalCount += mirrorDirectory(path, targetDir.filePath(folderName), allCopiedFiles,
+                                          allRemovedFiles, summary);
+            mirrored = true;
+            m_mirrorSummary.added += summary.added;
+            m_mirrorSummary.changed += summary.changed;
+            m_mirrorSummary.removed += summary.removed;
+            m_mirrorSummary.unchanged += summary.unchanged;
+            m_mirrorSummary.failed += summary.failed;
+            
+            if (m_cancelRequested) {
+                break;
+            }
+            
+            // Les echecs de suppression ne stoppent pas la copie: ils sont comptes
+            // dans lastMirrorSummary() et signales ici
+            emit operationSuccess(QString("Dossier %1 (miroir): %2 ajoute(s), %3 modifie(s), %4 supprime(s), %5 inchange(s), %6 echec(s)")
+                                .arg(folderName)
+                                .arg(summary.added)
+                                .arg(summary.changed)
+                                .arg(summary.removed)
+                                .arg(summary.unchanged)
+                                .arg(summary.failed));
+            
         } else if (pathInfo.isDir()) {
             // Copier un dossier recursivement
             QString folderName = pathInfo.fileName();
-            QString destFolder = repoDir.filePath(folderName);
+            QString destFolder = targetDir.filePath(folderName);
+            onlyMirrored = false;
             
             emit operationStarted(QString("Copie du dossier: %1...").arg(folderName));
             
-            QStringList dirFiles;
-            int dirCount = copyDirectoryRecursively(path, destFolder, dirFiles);
-            
-            allCopiedFiles.append(dirFiles);
+            int dirCount = copyDirectoryRecursively(path, destFolder, allCopiedFiles);
             totalCount += dirCount;
             
+            if (m_cancelRequested) {
+                break;
+            }
+            
             emit operationSuccess(QString("Dossier %1: %2 fichier(s) copie(s)")
                                 .arg(folderName)
                                 .arg(dirCount));
         }
     }
     
-    if (totalCount == 0) {
+    m_progressTotal = -1;
+    
+    if (m_cancelRequested) {
+        if (pipeline) {
+            pipeline->abort();
+            cleanupStaleLocks(repoPath, locksBefore, startedAt);
+        }
+        m_cancelRequested = false;
+        recordCancelLatency();
+        setError(GitError::UserCancelled, "Operation annulee par l'utilisateur.");
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    
+    // Un miroir deja a jour n'a rien a copier: ce n'est pas un echec
+    if (totalCount == 0 && !mirrored) {
         setError(GitError::FileNotFound, "Aucun fichier n'a pu etre copie.");
         emit operationFailed(m_lastError, m_lastErrorCode);
         return false;
     }
     
+    bool stagedDuringCopy = false;
+    if (pipeline) {
+        // L'indexation a suivi la copie: il ne reste que la fin de la file
+        TraceSpan stageSpan("GitManager::stagingPipeline", "git");
+        QElapsedTimer drainTimer;
+        drainTimer.start();
+        const bool staged = pipeline->finish();
+        stagedDuringCopy = staged;
+        m_metrics.recordProcess(drainTimer.elapsed());
+        stageSpan.setArg("staged", pipeline->staged());
+        stageSpan.setArg("ignored", pipeline->ignored());
+        if (staged) {
+            emit operationSuccess(QString("%1 fichier(s) indexe(s) pendant la copie, %2 ignore(s)")
+                                .arg(pipeline->staged()).arg(pipeline->ignored()));
+        } else {
+            // Non bloquant: addAllFiles indexera ce qui manque
+            cleanupStaleLocks(repoPath, locksBefore, startedAt);
+            emit operationWarning("Indexation au fil de la copie interrompue (" + pipeline->errorString() +
+                                  "), les fichiers restants seront indexes par l'ajout");
+        }
+    }
+    
+    allCopiedFiles.squeeze();
+    m_copiedFiles = std::move(allCopiedFiles);
+    allRemovedFiles.squeeze();
+    m_removedFiles = std::move(allRemovedFiles);
+    m_exactChangeSet = firstSinceAdd && mirrored && onlyMirrored;
+    m_changeSetStaged = m_exactChangeSet && stagedDuringCopy;
+    
     emit operationSuccess(QString("Total: %1 fichier(s) copie(s)").arg(totalCount));
     return true;
 }
 
 bool GitManager::addAllFiles(const QString& repoPath) {
+    TraceSpan span("GitManager::addAllFiles", "git");
+    GitMetrics::StageTimer stage(m_metrics, "add");
+    // Simple optimisation: l'ajout se fait aussi sans
+    m_largeRepoJustEnabled = false;
+    if (!ensureLargeRepoMode(repoPath)) {
+        qWarning() << "Mode grand depot non active:" << m_lastError;
+    }
+    
     emit operationStarted("Ajout de tous les fichiers au depot Git...");
     
-    // Utiliser "git add -A" pour ajouter tous les fichiers
-    if (!executeGitCommand(repoPath, QStringList() << "add" << "-A")) {
-        emit operationFailed(m_lastError, m_lastErrorCode);
-        return false;
+    QElapsedTimer addTimer;
+    addTimer.start();
+    
+    // Miroir seul depuis le dernier ajout: ses ajouts, modifications et
+    // suppressions sont exactement ce qui change, sans parcourir l'arbre
+    bool added = false;
+    if (m_exactChangeSet) {
+        added = stageChangeSet(repoPath);
+        if (!added && !m_cancelRequested) {
+            emit operationWarning("Indexation des changements du miroir impossible (" + m_lastError +
+                                  "), ajout de tout le depot");
+        }
     }
     
+    // Equivalent de "git add -A"; avec un sous-dossier publie, seul dossier
+    // materialise, inutile de parcourir le reste
+    if (!added && !m_cancelRequested) {
+        GitBackend* backend = backendFor(repoPath);
+        if (!backend->addAll(repoPath, m_publishSubdirectory)) {
+            setError(backend->lastErrorCode(), backend->lastError());
+            emit operationFailed(m_lastError, m_lastErrorCode);
+            return false;
+        }
+    }
+    
+    // Fichiers copies desormais dans l'index: les listes ont servi. Apres une
+    // annulation, le prochain ajout reprend tout le depot
+    m_copiedFiles = CompactPathList();
+    m_removedFiles = CompactPathList();
+    m_copyPendingAdd = m_cancelRequested;
+    m_exactChangeSet = false;
+    m_changeSetStaged = false;
+    
     if (m_cancelRequested) {
         m_cancelRequested = false;
         setError(GitError::UserCancelled, "Operation annulee par l'utilisateur.");
         return false;
     }
     
-    emit operationSuccess("Tous les fichiers ont ete ajoutes a l'index Git");
+    emit operationSuccess(QString("Tous les fichiers ont ete ajoutes a l'index Git (%1 ms, %2)")
+                        .arg(addTimer.elapsed()).arg(indexModeLabel(repoPath)));
+    return true;
+}
+
+QString GitManager::indexModeLabel(const QString& repoPath) const {
+    if (m_largeRepoJustEnabled) {
+        return "mode grand depot, premier appel apres activation";
+    }
+    int version = 0;
+    qint64 entries = 0;
+    readIndexHeader(repoPath, version, entries);
+    return version >= 4 ? "mode grand depot" : "index standard";
+}
+
+bool GitManager::stageChangeSet(const QString& repoPath) {
+    if (m_changeSetStaged) {
+        emit operationSuccess("Changements du miroir deja indexes pendant la copie");
+        return true;
+    }
+    
+    TraceSpan span("GitManager::stageChangeSet", "git");
+    span.setArg("copied", static_cast<qint64>(m_copiedFiles.size()));
+    span.setArg("removed", static_cast<qint64>(m_removedFiles.size()));
+    
+    // Meme filtre .gitignore et meme update-index --add --remove que pendant la copie
+    const QStringList locksBefore = existingLocks(repoPath);
+    const QDateTime startedAt = QDateTime::currentDateTime();
+    StagingPipeline pipeline(QDir(repoPath).absolutePath());
+    if (!pipeline.start()) {
+        setError(GitError::ProcessFailed, pipeline.errorString());
+        return false;
+    }
+    for (const CompactPathList* list : { &m_copiedFiles, &m_removedFiles }) {
+        for (qsizetype i = 0; i < list->size() && !m_cancelRequested; ++i) {
+            pipeline.submit(list->relativePathUtf8(i));
+        }
+    }
+    
+    const bool staged = !m_cancelRequested && pipeline.finish();
+    m_repoState->invalidate(repoPath);
+    if (!staged) {
+        pipeline.abort();
+        cleanupStaleLocks(repoPath, locksBefore, startedAt);
+        setError(GitError::ProcessFailed, pipeline.errorString());
+        return false;
+    }
+    
+    emit operationSuccess(QString("Changements du miroir indexes: %1 fichier(s), %2 ignore(s)")
+                        .arg(pipeline.staged()).arg(pipeline.ignored()));
+    return true;
+}
+
+QList<GitBackend::Kind> GitManager::availableBackends() {
+    QList<GitBackend::Kind> kinds = { GitBackend::Kind::Process };
+#if defined(ROGUE_HAVE_LIBGIT2)
+    kinds << GitBackend::Kind::Libgit2;
+#endif
+    return kinds;
+}
+
+bool GitManager::setBackend(GitBackend::Kind kind) {
+    if (kind == GitBackend::Kind::Process) {
+        m_backend = m_processBackend.get();
+        return true;
+    }
+    if (kind != GitBackend::Kind::Libgit2) {
+        // Valeur hors de l'enumeration (reglage altere): moteur processus
+        m_backend = m_processBackend.get();
+        setError(GitError::UnknownError, QString("Moteur inconnu: %1").arg(static_cast<int>(kind)));
+        return false;
+    }
+    
+#if defined(ROGUE_HAVE_LIBGIT2)
+    if (!m_inProcessBackend) {
+        m_inProcessBackend.reset(new Libgit2Backend());
+    }
+    m_backend = m_inProcessBackend.get();
+    return true;
+#else
+    setError(GitError::UnknownError, "Moteur " + GitBackend::kindName(kind) + " non disponible dans cette version.");
+    return false;
+#endif
+}
+
+GitBackend* GitManager::backendFor(const QString& repoPath) {
+    if (m_backend != m_processBackend.get() && !m_backend->supports(repoPath)) {
+        return m_processBackend.get();
+    }
+    return m_backend;
+}
+
+QString GitManager::cleanSubdirectory(const QString& subdirectory, bool* valid) {
+    // Separateurs Windows acceptes sur toutes les plateformes (reglage partage)
+    const QString path = QString(subdirectory.trimmed()).replace('\\', '/');
+    
+    // Segments verifies avant cleanPath, qui absorberait "a/../.."
+    bool accepted = !path.startsWith('/') && !QDir::isAbsolutePath(path) &&
+                    !(path.size() >= 2 && path.at(1) == ':');
+    for (const QString& segment : path.split('/', Qt::SkipEmptyParts)) {
+        if (segment == ".." || DirWalker::isGitDirName(segment)) {
+            accepted = false;
+        }
+    }
+    if (valid) {
+        *valid = accepted;
+    }
+    if (!accepted) {
+        return QString();
+    }
+    
+    const QString cleaned = QDir::cleanPath(path);
+    return (cleaned == "." || cleaned.isEmpty()) ? QString() : cleaned;
+}
+
+bool GitManager::setPublishSubdirectory(const QString& subdirectory) {
+    bool valid = false;
+    const QString cleaned = cleanSubdirectory(subdirectory, &valid);
+    if (!valid) {
+        qWarning() << "Sous-dossier de publication refuse:" << subdirectory;
+        return false;
+    }
+    m_publishSubdirectory = cleaned;
+    return true;
+}
+
+bool GitManager::isSparseCheckoutCurrent(const QString& repoPath) {
+    if (m_publishSubdirectory.isEmpty()) {
+        return true; // Un depot deja clairseme n'est pas elargi automatiquement
+    }
+    if (!m_repoState->state(repoPath).sparseCheckout) {
+        return false;
+    }
+    
+    // Mode cone: un dossier par ligne. Un cone plus large (dossier ajoute a
+    // la main) ou different doit etre remis a ce seul dossier
+    if (!executeGitCommand(repoPath, QStringList() << "sparse-checkout" << "list")) {
+        return false;
+    }
+    const QStringList cone = m_lastStandardOutput.split('\n', Qt::SkipEmptyParts);
+    return cone == QStringList { m_publishSubdirectory };
+}
+
+bool GitManager::ensureSparseCheckout(const QString& repoPath) {
+    if (isSparseCheckoutCurrent(repoPath)) {
+        return true;
+    }
+    
+    TraceSpan span("GitManager::ensureSparseCheckout", "git");
+    span.setArg("subdirectory", m_publishSubdirectory);
+    emit operationStarted("Limitation de l'arbre de travail a " + m_publishSubdirectory + "...");
+    
+    // Les fichiers hors du dossier quittent l'arbre de travail (sauf modifications locales)
+    if (!executeGitCommand(repoPath, QStringList() << "sparse-checkout" << "set" << "--cone"
+                           << m_publishSubdirectory, 600000)) {
+        emit operationFailed(m_lastError, m_lastErrorCode);
+        return false;
+    }
+    
+    emit operationSuccess("Arbre de travail limite a " + m_publishSubdirectory);
+    return true;
+}
+
+bool GitManager::readIndexHeader(const QString& repoPath, int& version, qint64& entries) {
+    // En-tete: "DIRC", version (4 octets), nombre d'entrees (4 octets), gros-boutiste
+    QFile index(QDir(repoPath).filePath(".git/index"));
+    if (!index.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    
+    const QByteArray header = index.read(12);
+    if (header.size() != 12 || !header.startsWith("DIRC")) {
+        return false;
+    }
+    
+    auto readBigEndian = [&header](int offset) {
+        return (quint32(quint8(header[offset])) << 24) | (quint32(quint8(header[offset + 1])) << 16) |
+               (quint32(quint8(header[offset + 2])) << 8) | quint32(quint8(header[offset + 3]));
+    };
+    version = int(readBigEndian(4));
+    entries = qint64(readBigEndian(8));
+    return true;
+}
+
+bool GitManager::ensureLargeRepoMode(const QString& repoPath) {
+    if (m_largeRepoThreshold <= 0) {
+        return true;
+    }
+    
+    int version = 0;
+    qint64 entries = 0;
+    const bool hasIndex = readIndexHeader(repoPath, version, entries);
+    
+    // Index v4 = mode deja actif (avec split-index, l'en-tete ne compte plus tous les fichiers)
+    if (version >= 4) {
+        return true;
+    }
+    
+    // Premiere publication: les fichiers copies ne sont pas encore dans l'index
+    qint64 files = qMax(entries, qint64(m_copiedFiles.size()));
+    if (!hasIndex && files < m_largeRepoThreshold) {
+        files = DirWalker::countFiles(repoPath, m_symlinkPolicy, true, m_largeRepoThreshold);
+    }
+    if (files < m_largeRepoThreshold) {
+        return true;
+    }
+    
+    TraceSpan span("GitManager::ensureLargeRepoMode", "git");
+    span.setArg("files", files);
+    emit operationStarted(QString("Depot volumineux (%1 fichiers): activation du mode grand depot...").arg(files));
+    
+    QList<QStringList> settings = {
+        { "feature.manyFiles", "true" },
+        { "index.version", "4" },
+        { "core.untrackedCache", "true" },
+        { "core.splitIndex", "true" },
+        { "index.threads", "true" }
+    };
+#if defined(Q_OS_WIN) || defined(Q_OS_MACOS)
+    // Demon integre: git 2.37 et plus, uniquement sur ces plateformes
+    if (executeGitCommand(repoPath, QStringList() << "version")) {
+        QRegularExpressionMatch match = QRegularExpression("(\\d+)\\.(\\d+)").match(m_lastOutput);
+        if (match.hasMatch() && match.captured(1).toInt() * 100 + match.captured(2).toInt() >= 237) {
+            settings.append({ "core.fsmonitor", "true" });
+        }
+    }
+#endif
+    
+    for (const QStringList& setting : settings) {
+        if (!executeGitCommand(repoPath, QStringList() << "config" << setting)) {
+            return false;
+        }
+    }
+    
+    // Reecriture immediate d'un index existant; sinon l'ajout qui suit le cree en v4
+    if (hasIndex && !executeGitCommand(repoPath, QStringList() << "update-index" << "--index-version" << "4"
+                                       << "--split-index" << "--untracked-cache", 600000)) {
+        return false;
+    }
+    
+    // Pas de mesure ici (elle parcourrait tout l'arbre de travail): l'ajout et
+    // la lecture de l'index qui suivent journalisent leur duree
+    m_largeRepoJustEnabled = true;
+    emit operationSuccess(QString("Mode grand depot actif (%1 fichiers)").arg(files));
     return true;
 }
\ No newline at end of file
@@ -0,0 +1,287 @@
+﻿#include "include/gitmetrics.h"
+#include "include/gitmanager.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QTextStream>
+
+namespace {
+
+void writePrometheusHistogram(QTextStream& out, const QString& name, const QString& labels,
+                              const LatencyHistogram& histogram) {
+    const QVector<qint64>& bounds = LatencyHistogram::bounds();
+    const QString prefix = labels.isEmpty() ? QString() : labels + ",";
+    qint64 cumulative = 0;
+
+    for (int i = 0; i < bounds.size(); ++i) {
+        cumulative += histogram.bucketCounts().at(i);
+        out << name << "_bucket{" << prefix << "le=\"" << bounds.at(i) << "\"} " << cumulative << "\n";
+    }
+    cumulative += histogram.bucketCounts().last();
+    out << name << "_bucket{" << prefix << "le=\"+Inf\"} " << cumulative << "\n";
+
+    QString suffix = labels.isEmpty() ? QString() : "{" + labels + "}";
+    out << name << "_sum" << suffix << " " << histogram.sum() << "\n";
+    out << name << "_count" << suffix << " " << histogram.count() << "\n";
+}
+
+bool writeFile(const QString& filePath, const QByteArray& content) {
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(content);
+    return file.commit();
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram()
+    : m_buckets(bounds().size() + 1, 0)
+    , m_count(0)
+    , m_sum(0)
+    , m_max(0) {
+}
+
+const QVector<qint64>& LatencyHistogram::bounds() {
+    static const QVector<qint64> values = {
+        1, 2, 5, 10, 25, 50, 100, 250, 500,
+        1000, 2500, 5000, 10000, 30000, 60000, 120000, 300000
+    };
+    return values;
+}
+
+void LatencyHistogram::record(qint64 ms) {
+    const QVector<qint64>& limits = bounds();
+    int index = 0;
+    while (index < limits.size() && ms > limits.at(index)) {
+        ++index;
+    }
+
+    ++m_buckets[index];
+    ++m_count;
+    m_sum += ms;
+    m_max = qMax(m_max, ms);
+}
+
+qint64 LatencyHistogram::percentile(double p) const {
+    if (m_count == 0) {
+        return 0;
+    }
+
+    qint64 rank = qMax<qint64>(1, static_cast<qint64>(p * m_count + 0.999999));
+    qint64 seen = 0;
+    for (int i = 0; i < m_buckets.size(); ++i) {
+        seen += m_buckets.at(i);
+        if (seen >= rank) {
+            // Le seau +Inf n'a pas de borne: on rend le maximum observe
+            return i < bounds().size() ? qMin(bounds().at(i), m_max) : m_max;
+        }
+    }
+    return m_max;
+}
+
+QJsonObject LatencyHistogram::toJson() const {
+    QJsonArray buckets;
+    for (int i = 0; i < m_buckets.size(); ++i) {
+        QJsonObject bucket;
+        bucket.insert("le", i < bounds().size() ? QJsonValue(bounds().at(i)) : QJsonValue("+Inf"));
+        bucket.insert("count", m_buckets.at(i));
+        buckets.append(bucket);
+    }
+
+    QJsonObject json;
+    json.insert("count", m_count);
+    json.insert("sumMs", m_sum);
+    json.insert("maxMs", m_max);
+    json.insert("p50Ms", percentile(0.50));
+    json.insert("p95Ms", percentile(0.95));
+    json.insert("p99Ms", percentile(0.99));
+    json.insert("buckets", buckets);
+    return json;
+}
+
+void GitMetrics::recordProcess(qint64 ms) {
+    QMutexLocker locker(&m_mutex);
+    ++m_processSpawns;
+    m_processLatency.record(ms);
+}
+
+void GitMetrics::recordCopiedFile(qint64 bytes) {
+    QMutexLocker locker(&m_mutex);
+    ++m_filesCopied;
+    m_bytesCopied += bytes;
+}
+
+void GitMetrics::recordRetry(GitError error) {
+    QMutexLocker locker(&m_mutex);
+    ++m_retriesByError[static_cast<int>(error)];
+}
+
+void GitMetrics::recordProbe(qint64 ms, bool success) {
+    QMutexLocker locker(&m_mutex);
+    m_probeLatency.record(ms);
+    if (!success) {
+        ++m_probeFailures;
+    }
+}
+
+void GitMetrics::recordStage(const QString& stage, qint64 ms) {
+    QMutexLocker locker(&m_mutex);
+    m_stageDurations[stage].record(ms);
+}
+
+qint64 GitMetrics::processSpawns() const {
+    QMutexLocker locker(&m_mutex);
+    return m_processSpawns;
+}
+
+qint64 GitMetrics::bytesCopied() const {
+    QMutexLocker locker(&m_mutex);
+    return m_bytesCopied;
+}
+
+qint64 GitMetrics::filesCopied() const {
+    QMutexLocker locker(&m_mutex);
+    return m_filesCopied;
+}
+
+qint64 GitMetrics::totalRetries() const {
+    QMutexLocker locker(&m_mutex);
+    qint64 total = 0;
+    for (qint64 count : m_retriesByError) {
+        total += count;
+    }
+    return total;
+}
+
+void GitMetrics::reset() {
+    QMutexLocker locker(&m_mutex);
+    m_processSpawns = 0;
+    m_bytesCopied = 0;
+    m_filesCopied = 0;
+    m_probeFailures = 0;
+    m_retriesByError.clear();
+    m_processLatency = LatencyHistogram();
+    m_probeLatency = LatencyHistogram();
+    m_stageDurations.clear();
+}
+
+QString GitMetrics::summary() const {
+    QMutexLocker locker(&m_mutex);
+    QString text;
+    QTextStream out(&text);
+
+    out << "Processus Git lances: " << m_processSpawns
+        << " (p50 " << m_processLatency.percentile(0.50) << " ms, p95 "
+        << m_processLatency.percentile(0.95) << " ms)\n";
+    out << "Fichiers copies: " << m_filesCopied << " ("
+        << QString::number(m_bytesCopied / (1024.0 * 1024.0), 'f', 1) << " Mo)\n";
+    out << "Sondes reseau: " << m_probeLatency.count() << " dont " << m_probeFailures
+        << " en echec (p95 " << m_probeLatency.percentile(0.95) << " ms)\n";
+
+    out << "\nNouvelles tentatives:\n";
+    if (m_retriesByError.isEmpty()) {
+        out << "  aucune\n";
+    }
+    for (auto it = m_retriesByError.constBegin(); it != m_retriesByError.constEnd(); ++it) {
+        out << "  " << errorName(static_cast<GitError>(it.key())) << ": " << it.value() << "\n";
+    }
+
+    out << "\nDuree par etape (nombre / p50 / p95 / max):\n";
+    for (auto it = m_stageDurations.constBegin(); it != m_stageDurations.constEnd(); ++it) {
+        out << "  " << it.key() << ": " << it.value().count() << " / "
+            << it.value().percentile(0.50) << " ms / " << it.value().percentile(0.95)
+            << " ms / " << it.value().max() << " ms\n";
+    }
+
+    return text;
+}
+
+QJsonObject GitMetrics::toJson() const {
+    QMutexLocker locker(&m_mutex);
+
+    QJsonObject retries;
+    for (auto it = m_retriesByError.constBegin(); it != m_retriesByError.constEnd(); ++it) {
+        retries.insert(errorName(static_cast<GitError>(it.key())), it.value());
+    }
+
+    QJsonObject stages;
+    for (auto it = m_stageDurations.constBegin(); it != m_stageDurations.constEnd(); ++it) {
+        stages.insert(it.key(), it.value().toJson());
+    }
+
+    QJsonObject json;
+    json.insert("processSpawns", m_processSpawns);
+    json.insert("bytesCopied", m_bytesCopied);
+    json.insert("filesCopied", m_filesCopied);
+    json.insert("probeFailures", m_probeFailures);
+    json.insert("retriesByError", retries);
+    json.insert("processLatency", m_processLatency.toJson());
+    json.insert("probeLatency", m_probeLatency.toJson());
+    json.insert("stageDurations", stages);
+    return json;
+}
+
+QString GitMetrics::toPrometheus() const {
+    QMutexLocker locker(&m_mutex);
+    QString text;
+    QTextStream out(&text);
+
+    out << "# TYPE rogue_git_process_spawns_total counter\n"
+        << "rogue_git_process_spawns_total " << m_processSpawns << "\n";
+    out << "# TYPE rogue_copied_bytes_total counter\n"
+        << "rogue_copied_bytes_total " << m_bytesCopied << "\n";
+    out << "# TYPE rogue_copied_files_total counter\n"
+        << "rogue_copied_files_total " << m_filesCopied << "\n";
+    out << "# TYPE rogue_probe_failures_total counter\n"
+        << "rogue_probe_failures_total " << m_probeFailures << "\n";
+
+    out << "# TYPE rogue_retries_total counter\n";
+    for (auto it = m_retriesByError.constBegin(); it != m_retriesByError.constEnd(); ++it) {
+        out << "rogue_retries_total{error=\"" << errorName(static_cast<GitError>(it.key()))
+            << "\"} " << it.value() << "\n";
+    }
+
+    out << "# TYPE rogue_git_process_duration_ms histogram\n";
+    writePrometheusHistogram(out, "rogue_git_process_duration_ms", QString(), m_processLatency);
+    out << "# TYPE rogue_probe_duration_ms histogram\n";
+    writePrometheusHistogram(out, "rogue_probe_duration_ms", QString(), m_probeLatency);
+
+    out << "# TYPE rogue_stage_duration_ms histogram\n";
+    for (auto it = m_stageDurations.constBegin(); it != m_stageDurations.constEnd(); ++it) {
+        writePrometheusHistogram(out, "rogue_stage_duration_ms",
+                                 QString("stage=\"%1\"").arg(it.key()), it.value());
+    }
+
+    return text;
+}
+
+bool GitMetrics::saveJson(const QString& filePath) const {
+    return writeFile(filePath, QJsonDocument(toJson()).toJson(QJsonDocument::Indented));
+}
+
+bool GitMetrics::savePrometheus(const QString& filePath) const {
+    return writeFile(filePath, toPrometheus().toUtf8());
+}
+
+QString GitMetrics::errorName(GitError error) {
+    switch (error) {
+        case GitError::None: return "None";
+        case GitError::GitNotInstalled: return "GitNotInstalled";
+        case GitError::InvalidRepository: return "InvalidRepository";
+        case GitError::RemoteNotFound: return "RemoteNotFound";
+        case GitError::AuthenticationFailed: return "AuthenticationFailed";
+        case GitError::NetworkError: return "NetworkError";
+        case GitError::FileNotFound: return "FileNotFound";
+        case GitError::NothingToCommit: return "NothingToCommit";
+        case GitError::Timeout: return "Timeout";
+        case GitError::ProcessFailed: return "ProcessFailed";
+        case GitError::UserCancelled: return "UserCancelled";
+        case GitError::ConnectionRefused: return "ConnectionRefused";
+        case GitError::SSLError: return "SSLError";
+        case GitError::ProxyError: return "ProxyError";
+        case GitError::UnknownError: return "UnknownError";
+    }
+    return "UnknownError";
+}
@@ -0,0 +1,381 @@
+﻿#include "include/libgit2backend.h"
+#include "include/gitmanager.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QByteArray>
+#include <git2.h>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+namespace {
+
+// Liberation automatique des objets libgit2
+template <typename T, void (*Free)(T*)>
+struct Deleter {
+    void operator()(T* object) const { Free(object); }
+};
+template <typename T, void (*Free)(T*)>
+using Handle = std::unique_ptr<T, Deleter<T, Free>>;
+
+using IndexHandle = Handle<git_index, git_index_free>;
+using TreeHandle = Handle<git_tree, git_tree_free>;
+using CommitHandle = Handle<git_commit, git_commit_free>;
+using ObjectHandle = Handle<git_object, git_object_free>;
+using ReferenceHandle = Handle<git_reference, git_reference_free>;
+using RemoteHandle = Handle<git_remote, git_remote_free>;
+using SignatureHandle = Handle<git_signature, git_signature_free>;
+using StatusListHandle = Handle<git_status_list, git_status_list_free>;
+using ConfigHandle = Handle<git_config, git_config_free>;
+
+bool configFlag(git_config* config, const char* name) {
+    int value = 0;
+    return git_config_get_bool(&value, config, name) == 0 && value != 0;
+}
+
+/**
+ * @brief Filtre clean ou process configure (git-lfs, git-crypt...): libgit2 ne les execute pas
+ */
+bool hasCleanFilter(git_config* config) {
+    bool found = false;
+    git_config_foreach_match(config, "^filter\\..+\\.(clean|process)$",
+                             [](const git_config_entry*, void* payload) {
+        *static_cast<bool*>(payload) = true;
+        return 1;
+    }, &found);
+    return found;
+}
+
+/**
+ * @brief Chemin situe dans le sous-dossier (payload), compare octet par octet
+ * @return 0 pour traiter le chemin, 1 pour l'ignorer (convention de git_index_matched_path_cb)
+ */
+int matchSubdirectory(const char* path, const char* matchedPathspec, void* payload) {
+    Q_UNUSED(matchedPathspec);
+    const QByteArray& prefix = *static_cast<const QByteArray*>(payload);
+    const size_t length = size_t(prefix.size());
+    return (std::strncmp(path, prefix.constData(), length) == 0 &&
+            (path[length] == '/' || path[length] == '\0')) ? 0 : 1;
+}
+
+/**
+ * @brief Crochet qu'un ajout, un commit ou une mise a jour de reference declencherait
+ *
+ * core.hooksPath relatif s'entend depuis l'arbre de travail, comme pour git.
+ */
+bool hasLocalHook(git_repository* repository, git_config* config) {
+    QString hooksDir;
+    git_buf path = GIT_BUF_INIT;
+    if (git_config_get_path(&path, config, "core.hooksPath") == 0) {
+        hooksDir = QString::fromUtf8(path.ptr);
+        git_buf_dispose(&path);
+        const char* workdir = git_repository_workdir(repository);
+        if (QDir::isRelativePath(hooksDir) && workdir) {
+            hooksDir = QDir(QString::fromUtf8(workdir)).filePath(hooksDir);
+        }
+    } else {
+        hooksDir = QDir(QString::fromUtf8(git_repository_commondir(repository))).filePath("hooks");
+    }
+
+    static const char* const hooks[] = {
+        "pre-commit", "prepare-commit-msg", "commit-msg", "post-commit",
+        "reference-transaction", "post-index-change"
+    };
+    for (const char* hook : hooks) {
+        if (QFileInfo(QDir(hooksDir).filePath(QLatin1String(hook))).isFile()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+Libgit2Backend::Libgit2Backend() {
+    git_libgit2_init();
+}
+
+Libgit2Backend::~Libgit2Backend() {
+    for (git_repository* repository : std::as_const(m_repositories)) {
+        git_repository_free(repository);
+    }
+    git_libgit2_shutdown();
+}
+
+bool Libgit2Backend::fail(int code, const QString& context) {
+    const git_error* error = git_error_last();
+    QString message = context;
+    if (error && error->message) {
+        message += ": " + QString::fromUtf8(error->message);
+    }
+
+    GitError mapped = GitError::UnknownError;
+    switch (code) {
+    case GIT_ENOTFOUND: mapped = GitError::InvalidRepository; break;
+    case GIT_EAUTH: mapped = GitError::AuthenticationFailed; break;
+    case GIT_ELOCKED:
+    case GIT_ECONFLICT: mapped = GitError::ProcessFailed; break;
+    case GIT_EUNBORNBRANCH: mapped = GitError::NothingToCommit; break;
+    default: break;
+    }
+    if (error && error->klass == GIT_ERROR_NET) {
+        mapped = GitError::NetworkError;
+    }
+
+    setError(mapped, message);
+    return false;
+}
+
+git_repository* Libgit2Backend::open(const QString& repoPath) {
+    const QString key = QDir(repoPath).absolutePath();
+    git_repository* repository = m_repositories.value(key);
+    if (repository) {
+        return repository;
+    }
+
+    // Ouverture sans remonter l'arborescence: le chemin est celui du depot
+    const QByteArray path = QDir::toNativeSeparators(key).toUtf8();
+    int code = git_repository_open_ext(&repository, path.constData(), GIT_REPOSITORY_OPEN_NO_SEARCH, nullptr);
+    if (code < 0) {
+        fail(code, "Ouverture du depot " + repoPath);
+        return nullptr;
+    }
+    m_repositories.insert(key, repository);
+    return repository;
+}
+
+bool Libgit2Backend::supports(const QString& repoPath) {
+    git_repository* repository = open(repoPath);
+    if (!repository) {
+        return false;
+    }
+
+    git_config* raw = nullptr;
+    if (git_repository_config_snapshot(&raw, repository) < 0) {
+        return false;
+    }
+    ConfigHandle config(raw);
+    if (configFlag(config.get(), "core.splitIndex") || configFlag(config.get(), "core.sparseCheckout") ||
+        configFlag(config.get(), "core.fsmonitor")) {
+        return false;
+    }
+
+    // Comportements que git applique et que libgit2 ignorerait sans erreur:
+    // filtres d'entree, crochets, signature des commits
+    return !hasCleanFilter(config.get()) && !hasLocalHook(repository, config.get()) &&
+           !configFlag(config.get(), "commit.gpgsign");
+}
+
+bool Libgit2Backend::status(const QString& repoPath, QVector<GitStatusEntry>& entries) {
+    entries.clear();
+    git_repository* repository = open(repoPath);
+    if (!repository) {
+        return false;
+    }
+
+    git_status_options options = GIT_STATUS_OPTIONS_INIT;
+    options.show = GIT_STATUS_SHOW_INDEX_AND_WORKDIR;
+    options.flags = GIT_STATUS_OPT_INCLUDE_UNTRACKED | GIT_STATUS_OPT_RECURSE_UNTRACKED_DIRS;
+
+    git_status_list* raw = nullptr;
+    int code = git_status_list_new(&raw, repository, &options);
+    if (code < 0) {
+        return fail(code, "Lecture du status");
+    }
+    StatusListHandle list(raw);
+
+    // Memes codes que git status --porcelain
+    const size_t count = git_status_list_entrycount(list.get());
+    entries.reserve(static_cast<int>(count));
+    for (size_t i = 0; i < count; ++i) {
+        const git_status_entry* status = git_status_byindex(list.get(), i);
+        const unsigned flags = status->status;
+        GitStatusEntry entry;
+
+        if (flags & GIT_STATUS_WT_NEW && !(flags & GIT_STATUS_INDEX_NEW)) {
+            entry.index = '?';
+            entry.worktree = '?';
+        } else {
+            if (flags & GIT_STATUS_INDEX_NEW) entry.index = 'A';
+            else if (flags & GIT_STATUS_INDEX_MODIFIED) entry.index = 'M';
+            else if (flags & GIT_STATUS_INDEX_DELETED) entry.index = 'D';
+            else if (flags & GIT_STATUS_INDEX_TYPECHANGE) entry.index = 'T';
+
+            if (flags & GIT_STATUS_WT_MODIFIED) entry.worktree = 'M';
+            else if (flags & GIT_STATUS_WT_DELETED) entry.worktree = 'D';
+            else if (flags & GIT_STATUS_WT_TYPECHANGE) entry.worktree = 'T';
+        }
+        if (entry.index == ' ' && entry.worktree == ' ') {
+            continue; // Ignore ou inchange
+        }
+
+        const git_diff_delta* delta = status->head_to_index ? status->head_to_index : status->index_to_workdir;
+        entry.path = QString::fromUtf8(delta->new_file.path ? delta->new_file.path : delta->old_file.path);
+        entries.append(entry);
+    }
+
+    setError(GitError::None, QString());
+    return true;
+}
+
+bool Libgit2Backend::addAll(const QString& repoPath, const QString& pathspec) {
+    git_repository* repository = open(repoPath);
+    if (!repository) {
+        return false;
+    }
+
+    git_index* raw = nullptr;
+    int code = git_repository_index(&raw, repository);
+    if (code < 0) {
+        return fail(code, "Lecture de l'index");
+    }
+    IndexHandle index(raw);
+
+    // Relecture seulement si l'index a change sur le disque
+    if ((code = git_index_read(index.get(), 0)) < 0) {
+        return fail(code, "Lecture de l'index");
+    }
+
+    // Sous-dossier pris a la lettre, comme :(literal) du moteur processus.
+    // update_all interprete toujours les motifs et un caractere special prive
+    // add_all de la correspondance par dossier: le motif ne sert alors qu'a
+    // restreindre le parcours s'il n'en contient aucun, le filtre decide
+    QByteArray prefix = pathspec.toUtf8();
+    while (prefix.endsWith('/')) {
+        prefix.chop(1);
+    }
+    const bool narrow = !prefix.isEmpty() && std::strpbrk(prefix.constData(), "*?[\\") == nullptr;
+    char* patterns[] = { prefix.data() };
+    git_strarray paths = { patterns, narrow ? size_t(1) : size_t(0) };
+    git_index_matched_path_cb filter = prefix.isEmpty() ? nullptr : matchSubdirectory;
+
+    // add -A: nouveaux et modifies, puis suppressions
+    if ((code = git_index_add_all(index.get(), &paths, GIT_INDEX_ADD_DISABLE_PATHSPEC_MATCH,
+                                  filter, &prefix)) < 0 ||
+        (code = git_index_update_all(index.get(), &paths, filter, &prefix)) < 0) {
+        return fail(code, "Ajout a l'index");
+    }
+    if ((code = git_index_write(index.get())) < 0) {
+        return fail(code, "Ecriture de l'index");
+    }
+
+    setError(GitError::None, QString());
+    return true;
+}
+
+bool Libgit2Backend::commit(const QString& repoPath, const QString& message) {
+    git_repository* repository = open(repoPath);
+    if (!repository) {
+        return false;
+    }
+
+    git_index* rawIndex = nullptr;
+    int code = git_repository_index(&rawIndex, repository);
+    if (code < 0) {
+        return fail(code, "Lecture de l'index");
+    }
+    IndexHandle index(rawIndex);
+    if ((code = git_index_read(index.get(), 0)) < 0) {
+        return fail(code, "Lecture de l'index");
+    }
+
+    git_oid treeId;
+    if ((code = git_index_write_tree(&treeId, index.get())) < 0) {
+        return fail(code, "Ecriture de l'arbre");
+    }
+
+    // Parent: HEAD, sauf sur une branche encore sans commit
+    CommitHandle parent;
+    git_oid headId;
+    code = git_reference_name_to_id(&headId, repository, "HEAD");
+    if (code == 0) {
+        git_commit* rawParent = nullptr;
+        if ((code = git_commit_lookup(&rawParent, repository, &headId)) < 0) {
+            return fail(code, "Lecture de HEAD");
+        }
+        parent.reset(rawParent);
+        if (git_oid_equal(git_commit_tree_id(parent.get()), &treeId)) {
+            setError(GitError::NothingToCommit, "Aucune modification a commiter.");
+            return false;
+        }
+    } else if (code != GIT_ENOTFOUND && code != GIT_EUNBORNBRANCH) {
+        return fail(code, "Lecture de HEAD");
+    }
+
+    git_tree* rawTree = nullptr;
+    if ((code = git_tree_lookup(&rawTree, repository, &treeId)) < 0) {
+        return fail(code, "Lecture de l'arbre");
+    }
+    TreeHandle tree(rawTree);
+
+    // Identite de user.name / user.email, comme git commit
+    git_signature* rawSignature = nullptr;
+    if ((code = git_signature_default(&rawSignature, repository)) < 0) {
+        return fail(code, "Identite Git (user.name / user.email) non configuree");
+    }
+    SignatureHandle signature(rawSignature);
+
+    git_oid commitId;
+    const QByteArray text = message.toUtf8();
+    code = parent
+        ? git_commit_create_v(&commitId, repository, "HEAD", signature.get(), signature.get(), nullptr,
+                              text.constData(), tree.get(), 1, parent.get())
+        : git_commit_create_v(&commitId, repository, "HEAD", signature.get(), signature.get(), nullptr,
+                              text.constData(), tree.get(), 0);
+    if (code < 0) {
+        return fail(code, "Creation du commit");
+    }
+
+    setError(GitError::None, QString());
+    return true;
+}
+
+bool Libgit2Backend::updateRef(const QString& repoPath, const QString& ref, const QString& target) {
+    git_repository* repository = open(repoPath);
+    if (!repository) {
+        return false;
+    }
+
+    git_object* rawObject = nullptr;
+    int code = git_revparse_single(&rawObject, repository, target.toUtf8().constData());
+    if (code < 0) {
+        return fail(code, "Resolution de " + target);
+    }
+    ObjectHandle object(rawObject);
+
+    git_reference* rawReference = nullptr;
+    code = git_reference_create(&rawReference, repository, ref.toUtf8().constData(), git_object_id(object.get()),
+                                1, "rogue-publisher: update-ref");
+    if (code < 0) {
+        return fail(code, "Mise a jour de " + ref);
+    }
+    ReferenceHandle reference(rawReference);
+
+    setError(GitError::None, QString());
+    return true;
+}
+
+bool Libgit2Backend::setRemoteUrl(const QString& repoPath, const QString& name, const QString& url,
+                                  bool create) {
+    git_repository* repository = open(repoPath);
+    if (!repository) {
+        return false;
+    }
+
+    const QByteArray remoteName = name.toUtf8();
+    const QByteArray remoteUrl = url.toUtf8();
+    int code = 0;
+    if (create) {
+        git_remote* rawRemote = nullptr;
+        code = git_remote_create(&rawRemote, repository, remoteName.constData(), remoteUrl.constData());
+        RemoteHandle remote(rawRemote);
+    } else {
+        code = git_remote_set_url(repository, remoteName.constData(), remoteUrl.constData());
+    }
+    if (code < 0) {
+        return fail(code, "Configuration du remote " + name);
+    }
+
+    setError(GitError::None, QString());
+    return true;
+}
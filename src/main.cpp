@@ -1,4 +1,5 @@
 ﻿#include "include/mainwindow.h"
+#include "include/tracer.h"
 #include <QApplication>
 #include <QStyleFactory>
 #include <QCommandLineParser>
@@ -39,6 +40,10 @@ int main(int argc, char* argv[]) {
         "Desactive le theme Fusion");
     parser.addOption(noStyleOption);
 
+    QCommandLineOption traceOption("trace",
+        "Enregistre une trace Chrome (chrome://tracing) dans <fichier>", "fichier");
+    parser.addOption(traceOption);
+
     parser.process(app);
 
     // Appliquer le style moderne (sauf si desactive)
@@ -53,10 +58,21 @@ int main(int argc, char* argv[]) {
         qDebug() << "Styles disponibles:" << QStyleFactory::keys();
     }
 
+    // Trace des operations: --trace <fichier> ou variable ROGUE_TRACE
+    QString tracePath = parser.value(traceOption);
+    if (tracePath.isEmpty()) {
+        tracePath = qEnvironmentVariable("ROGUE_TRACE");
+    }
+    if (!tracePath.isEmpty() && !Tracer::instance().start(tracePath)) {
+        qWarning() << "Impossible d'ouvrir le fichier de trace:" << tracePath;
+    }
+
     // Cree et affiche la fenetre principale
     MainWindow mainWindow;
     mainWindow.show();
 
     // Lance la boucle d'evenements de l'application
-    return app.exec();
+    int result = app.exec();
+    Tracer::instance().stop();
+    return result;
 }
\ No newline at end of file
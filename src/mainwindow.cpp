@@ -10,13 +10,32 @@
 #include <QCloseEvent>
 #include <QProgressDialog>
 #include <QTimer>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QFontDatabase>
+#include <QHeaderView>
+#include <atomic>
+#include "include/prepushdialog.h"
+#include "include/publishdag.h"
+#include "include/repostatecache.h"
 
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
     , m_gitManager(new GitManager(this))
     , m_progressDialog(nullptr)
+    , m_fetchScheduler(new FetchScheduler(this))
+    , m_pushQueue(new PushQueue(this))
+    , m_syncStatusLabel(new QLabel(this))
+    , m_pushQueueLabel(new QLabel(this))
+    , m_statusModel(new StatusTreeModel(this))
     , m_branch("main")
+    , m_transportProfile(TransportProfile::Default)
+    , m_cloneDepth(0)
+    , m_localFirst(false)
     , m_operationInProgress(false) {
 
     ui->setupUi(this);
@@ -32,6 +51,10 @@ MainWindow::MainWindow(QWidget* parent)
         this, &MainWindow::onGitOperationFailed);
     connect(m_gitManager, &GitManager::operationCancelled,
         this, &MainWindow::onGitOperationCancelled);
+    connect(m_gitManager, &GitManager::operationWarning,
+        this, &MainWindow::onGitOperationWarning);
+    connect(m_gitManager, &GitManager::busyChanged,
+        this, &MainWindow::updateActionsEnabled);
 
     // Connecter les signaux de retry et de connexion
     connect(m_gitManager, &GitManager::retryAttempt,
@@ -41,6 +64,51 @@ MainWindow::MainWindow(QWidget* parent)
     connect(m_gitManager, &GitManager::connectionCheckCompleted,
         this, &MainWindow::onConnectionCheckCompleted);
     
+    // Les fichiers copies sont indexes pendant la copie, pas apres
+    m_gitManager->setPipelinedStaging(true);
+    
+    // Synchronisation en arriere-plan et indicateur de la barre d'etat
+    connect(m_fetchScheduler, &FetchScheduler::remoteStatusChanged,
+        this, &MainWindow::onRemoteStatusChanged);
+    connect(m_fetchScheduler, &FetchScheduler::fastForwarded,
+        this, &MainWindow::onFastForwarded);
+    connect(m_fetchScheduler, &FetchScheduler::fetchFailed,
+        this, &MainWindow::onBackgroundFetchFailed);
+    ui->statusbar->addPermanentWidget(m_syncStatusLabel);
+    
+    // File de push en arriere-plan (publication locale d'abord)
+    connect(m_pushQueue, &PushQueue::queueChanged,
+        this, &MainWindow::onPushQueueChanged);
+    connect(m_pushQueue, &PushQueue::pushed,
+        this, &MainWindow::onBackgroundPushed);
+    connect(m_pushQueue, &PushQueue::pushFailed,
+        this, &MainWindow::onBackgroundPushFailed);
+    m_pushQueueLabel->hide();
+    ui->statusbar->addPermanentWidget(m_pushQueueLabel);
+    
+    // Panneau des modifications: les dossiers sont charges a leur deploiement
+    ui->statusTreeView->setModel(m_statusModel);
+    ui->statusTreeView->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    ui->statusTreeView->header()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+    ui->statusTreeView->header()->setStretchLastSection(false);
+    connect(m_statusModel, &StatusTreeModel::loadingFinished, this, [this](qsizetype files) {
+        ui->statusLabel->setText(QString("Modifications a publier (%1 fichier(s)) :").arg(files));
+        
+        // Duree du status reel, a comparer avant et apres le mode grand depot
+        if (m_statusModel->lastLoadMs() >= 0) {
+            int version = 0;
+            qint64 entries = 0;
+            GitManager::readIndexHeader(m_repositoryPath, version, entries);
+            logMessage(QString("git status: %1 fichier(s) en %2 ms (%3)")
+                       .arg(files).arg(m_statusModel->lastLoadMs())
+                       .arg(version >= 4 ? "mode grand depot" : "index standard"));
+        }
+    });
+    connect(m_statusModel, &StatusTreeModel::loadingFailed, this, [this](const QString& error) {
+        ui->statusLabel->setText("Modifications a publier : indisponible");
+        ui->statusLabel->setToolTip(error);
+    });
+    
     // Charger la configuration
     loadSettings();
     
@@ -60,16 +128,9 @@ MainWindow::MainWindow(QWidget* parent)
         if (!m_repositoryPath.isEmpty()) {
             logMessage("Configuration chargee: " + m_repositoryPath);
             
-            // Pull automatique au démarrage si le dépôt est configuré
+            // Synchronisation en arriere-plan (fetch + fast-forward si l'arbre est propre)
             if (m_gitManager->isGitRepository(m_repositoryPath) && !m_remoteUrl.isEmpty()) {
-                logMessage("Synchronisation avec le depot distant au demarrage...");
-                
-                // MODIFIÉ: Utiliser le token sauvegardé pour le pull
-                if (m_gitManager->pull(m_repositoryPath, m_branch, m_githubUsername, m_githubToken)) {
-                    logSuccess("Synchronisation initiale terminee");
-                } else {
-                    logMessage("Synchronisation initiale ignoree (depot peut-etre vide ou prive)");
-                }
+                logMessage("Synchronisation avec le depot distant en arriere-plan...");
             }
         } else {
             logMessage("Configurez votre depot via: Actions > Configurer Git");
@@ -83,9 +144,14 @@ MainWindow::MainWindow(QWidget* parent)
     
     // Message d'aide dans les logs
     logMessage("Workflow: 1) Ajouter fichiers → 2) Push sur GitHub");
+    
+    configureFetchScheduler();
+    m_fetchScheduler->start();
+    refreshStatusView();
 }
 
 MainWindow::~MainWindow() {
+    m_fetchScheduler->stop();
     saveSettings();
     delete ui;
 }
@@ -137,7 +203,33 @@ void MainWindow::loadSettings() {
     m_repositoryPath = settings.value("git/repositoryPath", "").toString();
     m_remoteUrl = settings.value("git/remoteUrl", "").toString();
     m_branch = settings.value("git/branch", "main").toString();
+    m_extraBranches = settings.value("git/extraBranches").toStringList();
     m_githubUsername = settings.value("github/username", "").toString();
+    bool profileOk = false;
+    const int profile = settings.value("git/transportProfile",
+                                       static_cast<int>(TransportProfile::Default)).toInt(&profileOk);
+    // Valeur alteree ou hors enumeration: profil par defaut
+    m_transportProfile = (profileOk && profile >= static_cast<int>(TransportProfile::Default)
+                          && profile <= static_cast<int>(TransportProfile::ManySmallFiles))
+        ? static_cast<TransportProfile>(profile) : TransportProfile::Default;
+    m_gitManager->setTransportProfile(m_transportProfile);
+    m_cloneDepth = settings.value("git/cloneDepth", 0).toInt();
+    if (!m_gitManager->setPublishSubdirectory(settings.value("git/subdirectory", "").toString())) {
+        m_gitManager->setPublishSubdirectory(QString()); // Reglage altere: racine du depot
+    }
+    
+    // Moteur des operations locales; retour au processus git s'il n'est pas compile
+    // ou si le reglage ne designe aucun moteur connu
+    const auto backend = static_cast<GitBackend::Kind>(
+        settings.value("git/backend", static_cast<int>(GitBackend::Kind::Process)).toInt());
+    m_gitManager->setBackend(GitManager::availableBackends().contains(backend) ? backend
+                                                                              : GitBackend::Kind::Process);
+    m_fetchScheduler->setInterval(settings.value("sync/fetchIntervalSec", 300).toInt() * 1000);
+    m_localFirst = settings.value("push/localFirst", false).toBool();
+    
+    // Publications volumineuses: decoupage en lots sous la limite de pack GitHub
+    m_gitManager->setChunkThreshold(settings.value("push/chunkThresholdMiB", 1024).toLongLong() * 1024 * 1024);
+    m_gitManager->setPushTimeout(settings.value("push/timeoutSec", 120).toInt() * 1000);
     
     // NOUVEAU: Charger le token (crypté pour plus de sécurité)
     QString encryptedToken = settings.value("github/token", "").toString();
@@ -157,7 +249,13 @@ void MainWindow::saveSettings() {
     settings.setValue("git/repositoryPath", m_repositoryPath);
     settings.setValue("git/remoteUrl", m_remoteUrl);
     settings.setValue("git/branch", m_branch);
+    settings.setValue("git/extraBranches", m_extraBranches);
     settings.setValue("github/username", m_githubUsername);
+    settings.setValue("git/transportProfile", static_cast<int>(m_transportProfile));
+    settings.setValue("git/cloneDepth", m_cloneDepth);
+    settings.setValue("git/subdirectory", m_gitManager->publishSubdirectory());
+    settings.setValue("git/backend", static_cast<int>(m_gitManager->backendKind()));
+    settings.setValue("push/localFirst", m_localFirst);
     
     // NOUVEAU: Sauvegarder le token (crypté)
     if (!m_githubToken.isEmpty()) {
@@ -225,6 +323,15 @@ void MainWindow::showProgressDialog(const QString& message) {
     m_progressDialog->show();
 }
 
+void MainWindow::updateActionsEnabled() {
+    // Une commande Git a la fois: un clic pendant l'attente serait refuse
+    const bool idle = !m_operationInProgress && !m_gitManager->isBusy();
+    ui->addFilesButton->setEnabled(idle);
+    ui->pushToGitHubButton->setEnabled(idle);
+    ui->actionOuvrir->setEnabled(idle);
+    ui->actionConfigurer->setEnabled(idle);
+}
+
 void MainWindow::hideProgressDialog() {
     if (m_progressDialog) {
         m_progressDialog->hide();
@@ -330,6 +437,7 @@ void MainWindow::on_addFilesButton_clicked() {
     
     QPushButton* filesBtn = choiceBox.addButton("Fichier(s)", QMessageBox::ActionRole);
     QPushButton* folderBtn = choiceBox.addButton("Dossier/Projet", QMessageBox::ActionRole);
+    QPushButton* archiveBtn = choiceBox.addButton("Archive(s)", QMessageBox::ActionRole);
     QPushButton* cancelBtn = choiceBox.addButton("Annuler", QMessageBox::RejectRole);
     
     choiceBox.setDefaultButton(folderBtn);
@@ -359,6 +467,15 @@ void MainWindow::on_addFilesButton_clicked() {
             paths << folder;
         }
     } 
+    else if (choiceBox.clickedButton() == archiveBtn) {
+        // Archives lues en flux: pas d'extraction prealable sur le disque
+        paths = QFileDialog::getOpenFileNames(
+            this,
+            "Selectionner des archives",
+            QDir::homePath(),
+            "Archives (*.zip *.tar *.tar.gz *.tgz)"
+        );
+    }
     else {
         logMessage("Selection annulee.");
         return;
@@ -369,17 +486,54 @@ void MainWindow::on_addFilesButton_clicked() {
         return;
     }
     
+    const bool extractArchives = (choiceBox.clickedButton() == archiveBtn);
+    m_gitManager->setArchiveExtraction(extractArchives);
+    
+    // Dossier deja publie: proposer le miroir pour propager les suppressions
+    bool mirror = false;
+    if (choiceBox.clickedButton() == folderBtn) {
+        QDir targetDir(m_repositoryPath);
+        if (!m_gitManager->publishSubdirectory().isEmpty()) {
+            targetDir.setPath(targetDir.filePath(m_gitManager->publishSubdirectory()));
+        }
+        // Le miroir s'applique a tous les dossiers selectionnes: tous ceux deja
+        // presents sont nommes, pas seulement le premier
+        QStringList present;
+        for (const QString& path : paths) {
+            const QString folderName = QFileInfo(path).fileName();
+            if (targetDir.exists(folderName)) {
+                present << folderName;
+            }
+        }
+        if (!present.isEmpty()) {
+            mirror = QMessageBox::question(this, "Dossier deja present",
+                "Deja present(s) dans le depot: " + present.join(", ") + "\n\n"
+                "Synchroniser en miroir ? Pour chaque dossier selectionne, seuls les fichiers "
+                "modifies sont copies, et les fichiers supprimes de la source sont aussi "
+                "supprimes du depot.",
+                QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes) == QMessageBox::Yes;
+        }
+    }
+    m_gitManager->setMirrorMode(mirror);
+    
     // Connecter le signal de progression
     connect(m_gitManager, &GitManager::progressUpdate, this, [this](int current, int total, const QString& item) {
-        Q_UNUSED(total);
         if (m_progressDialog) {
-            m_progressDialog->setLabelText(QString("Copie en cours: %1\n(%2 fichiers traites)")
-                                          .arg(item)
-                                          .arg(current));
+            if (total > 0) {
+                m_progressDialog->setLabelText(QString("Copie en cours: %1\n(%2 / %3 fichiers)")
+                                              .arg(item)
+                                              .arg(current)
+                                              .arg(total));
+            } else {
+                m_progressDialog->setLabelText(QString("Copie en cours: %1\n(%2 fichiers traites)")
+                                              .arg(item)
+                                              .arg(current));
+            }
         }
     });
     
     // Copier les fichiers/dossiers dans le depot avec structure
+    FetchScheduler::PauseGuard syncPause(m_fetchScheduler);
     showProgressDialog("Copie des fichiers en cours...");
     
     if (!m_gitManager->copyProjectRecursively(m_repositoryPath, paths)) {
@@ -398,6 +552,8 @@ void MainWindow::on_addFilesButton_clicked() {
         
         if (info.isDir()) {
             displayName += " (dossier)";
+        } else if (extractArchives) {
+            displayName += " (archive)";
         }
         
         QListWidgetItem* item = new QListWidgetItem(displayName);
@@ -415,7 +571,18 @@ void MainWindow::on_addFilesButton_clicked() {
         ui->fileListWidget->addItem(item);
     }
     
-    logSuccess(QString("%1 element(s) copie(s) dans le depot").arg(paths.count()));
+    if (mirror) {
+        const MirrorSummary summary = m_gitManager->lastMirrorSummary();
+        logSuccess(QString("Miroir: %1 ajoute(s), %2 modifie(s), %3 supprime(s), %4 inchange(s)")
+                   .arg(summary.added).arg(summary.changed).arg(summary.removed).arg(summary.unchanged));
+        if (summary.failed > 0) {
+            logError(QString("Miroir: %1 element(s) non supprime(s), voir le journal").arg(summary.failed));
+        }
+    } else {
+        logSuccess(QString("%1 element(s) copie(s) dans le depot (%2 fichier(s))")
+                   .arg(paths.count()).arg(m_gitManager->copiedFileCount()));
+    }
+    refreshStatusView();
 }
 
 void MainWindow::on_pushToGitHubButton_clicked() {
@@ -437,17 +604,6 @@ void MainWindow::on_pushToGitHubButton_clicked() {
         return;
     }
     
-    // Confirmation avant push
-    if (!confirmAction("Confirmer le push",
-                      QString("Vous allez pousser %1 fichier(s) sur:\n"
-                             "%2\n\n"
-                             "Voulez-vous continuer ?")
-                      .arg(ui->fileListWidget->count())
-                      .arg(m_remoteUrl))) {
-        logMessage("Push annule par l'utilisateur.");
-        return;
-    }
-    
     // Utiliser le token sauvegardé ou demander un nouveau
     QString token = m_githubToken;
     
@@ -484,6 +640,7 @@ void MainWindow::on_pushToGitHubButton_clicked() {
         if (saveToken == QMessageBox::Yes) {
             m_githubToken = token;
             saveSettings();
+            configureFetchScheduler();
             logSuccess("Token sauvegarde pour les prochaines utilisations");
         }
     } else {
@@ -508,59 +665,187 @@ void MainWindow::on_pushToGitHubButton_clicked() {
         commitMessage = "Commit depuis Rogue Publisher";
     }
     
+    // Pas de fetch ni de push en arriere-plan pendant la publication
+    FetchScheduler::PauseGuard syncPause(m_fetchScheduler);
+    PushQueue::PauseGuard queuePause(m_pushQueue);
+    
     m_operationInProgress = true;
+    updateActionsEnabled();
     logMessage("=== DEBUT DES OPERATIONS GIT ===");
     
-    // 1. Verifier/Initialiser le depot
-    if (!m_gitManager->isGitRepository(m_repositoryPath)) {
-        if (!confirmAction("Initialiser le depot",
-                          "Le repertoire n'est pas un depot Git.\n"
-                          "Voulez-vous l'initialiser maintenant ?")) {
-            logMessage("Initialisation annulee.");
-            m_operationInProgress = false;
-            return;
-        }
-        
-        if (!m_gitManager->initRepository(m_repositoryPath)) {
-            m_operationInProgress = false;
-            return;
-        }
-    }
+    // Etapes dependantes: chacune est sautee si sa condition est deja remplie
+    // (verification sans processus git), les sondes reseau tournent en parallele
+    const QString repoPath = m_repositoryPath;
+    const qint64 processesBefore = m_gitManager->metrics().processSpawns();
+    ChangeSummary summary;
+    bool cancelled = false;
+    std::atomic<bool> online(false);
+    QStringList extraBranches = m_extraBranches;
+    extraBranches.removeAll(m_branch);
+    QHash<QString, QString> branchHeads;
     
-    // 2. Configurer le remote
-    if (!m_gitManager->setRemoteUrl(m_repositoryPath, m_remoteUrl)) {
-        m_operationInProgress = false;
-        return;
+    PublishDag dag;
+    dag.addStep({ "ensure-repo", {},
+        [this, repoPath]() { return m_gitManager->repoState()->state(repoPath).isRepository; },
+        [this, repoPath, token, &cancelled]() {
+            if (!confirmAction("Initialiser le depot",
+                              "Le repertoire n'est pas un depot Git.\n"
+                              "Voulez-vous l'initialiser maintenant ?")) {
+                logMessage("Initialisation annulee.");
+                cancelled = true;
+                return false;
+            }
+            
+            // Clone partiel du distant: l'historique et les blobs sont recuperes a la demande
+            if (m_gitManager->bootstrapRepository(repoPath, m_remoteUrl, m_branch,
+                                                  m_githubUsername, token, m_cloneDepth)) {
+                return true;
+            }
+            if (m_gitManager->lastErrorCode() != GitError::RemoteNotFound) {
+                return false;
+            }
+            logMessage("Depot distant vide: initialisation d'un nouveau depot local.");
+            return m_gitManager->initRepository(repoPath);
+        } });
+    
+    // Les sondes ne bloquent pas les etapes locales: seul le push en depend
+    // (publication locale d'abord: le reseau ne concerne que la file de push)
+    if (!m_localFirst) {
+        dag.addStep({ "connectivity", { "ensure-repo" }, nullptr,
+            [this, &online]() {
+                online = m_gitManager->probeConnectivity();
+                return true;
+            }, true });
     }
     
-    // 3. Ajouter TOUS les fichiers (récursif avec git add -A)
-    if (!m_gitManager->addAllFiles(m_repositoryPath)) {
-        m_operationInProgress = false;
-        return;
+    dag.addStep({ "ensure-remote", { "ensure-repo" },
+        [this, repoPath]() { return m_gitManager->originUrl(repoPath) == m_remoteUrl; },
+        [this, repoPath]() { return m_gitManager->setRemoteUrl(repoPath, m_remoteUrl); } });
+    
+    dag.addStep({ "ensure-sparse", { "ensure-repo" },
+        [this, repoPath]() { return m_gitManager->isSparseCheckoutCurrent(repoPath); },
+        [this, repoPath]() { return m_gitManager->ensureSparseCheckout(repoPath); } });
+    
+    // git add -A, puis confirmation sur le resume reel de ce qui sera publie
+    dag.addStep({ "stage", { "ensure-sparse" }, nullptr,
+        [this, repoPath, &summary, &cancelled]() {
+            if (!m_gitManager->addAllFiles(repoPath) ||
+                !m_gitManager->summarizeStagedChanges(repoPath, summary)) {
+                return false;
+            }
+            if (summary.files == 0) {
+                return true;
+            }
+            PrePushDialog confirmation(repoPath, m_remoteUrl, m_branch, summary, this);
+            if (confirmation.exec() != QDialog::Accepted) {
+                logMessage("Push annule par l'utilisateur (les fichiers restent indexes).");
+                cancelled = true;
+                return false;
+            }
+            return true;
+        } });
+    
+    dag.addStep({ "commit", { "stage" },
+        [&summary]() { return summary.files == 0; },
+        [this, repoPath, commitMessage, &summary]() {
+            return m_gitManager->commit(repoPath, commitMessage, summary.bytes);
+        } });
+    
+    // Meme arbre sur les autres branches, sans toucher a l'arbre de travail
+    // (une branche deja a jour ne recoit pas de commit)
+    dag.addStep({ "branches", { "commit" },
+        [&extraBranches]() { return extraBranches.isEmpty(); },
+        [this, repoPath, commitMessage, &extraBranches, &branchHeads]() {
+            return m_gitManager->commitToBranches(repoPath, extraBranches, commitMessage, &branchHeads);
+        } });
+    
+    if (m_localFirst) {
+        // Le commit est mis en file: le push part a la fin de la publication,
+        // ou des que le reseau revient
+        dag.addStep({ "enqueue", { "ensure-remote", "commit", "branches" }, nullptr,
+            [this, repoPath, commitMessage, &summary, &extraBranches, &branchHeads]() {
+                bool saved = true;
+                if (summary.files > 0) {
+                    const QString head = m_gitManager->headCommit(repoPath);
+                    if (head.isEmpty()) {
+                        logError("Commit de HEAD introuvable: rien a mettre en file.");
+                        return false;
+                    }
+                    saved = m_pushQueue->enqueue(m_branch, head, commitMessage);
+                }
+                for (const QString& branch : extraBranches) {
+                    saved = m_pushQueue->enqueue(branch, branchHeads.value(branch), commitMessage) && saved;
+                }
+                if (!saved) {
+                    logError("File de push non enregistree: elle sera perdue a la fermeture.");
+                }
+                // Nouvelle publication: une file bloquee est retentee
+                m_pushQueue->pushNow();
+                return true;
+            } });
+    } else {
+        dag.addStep({ "push", { "ensure-remote", "commit", "branches", "connectivity" }, nullptr,
+            [this, repoPath, token, &online, &extraBranches]() {
+                // Sondes en echec: push refait ses propres verifications et rapporte l'erreur
+                m_gitManager->setConnectivityVerified(online);
+                if (!extraBranches.isEmpty()) {
+                    // Toutes les branches en un seul push
+                    return m_gitManager->pushBranches(repoPath, QStringList() << m_branch << extraBranches,
+                                                      m_githubUsername, token);
+                }
+                return m_gitManager->push(repoPath, m_branch, m_githubUsername, token);
+            } });
     }
     
-    // 4. Commit
-    if (!m_gitManager->commit(m_repositoryPath, commitMessage)) {
+    connect(&dag, &PublishDag::stepSkipped, this, [this](const QString& id) {
+        logMessage("Etape deja satisfaite, ignoree: " + id);
+    });
+    
+    bool published = dag.run();
+    logMessage(QString("Publication: %1 processus git")
+               .arg(m_gitManager->metrics().processSpawns() - processesBefore));
+    
+    if (!published) {
         m_operationInProgress = false;
+        updateActionsEnabled();
+        if (cancelled) {
+            refreshStatusView();
+        }
         return;
     }
     
-    // 5. Push
-    if (!m_gitManager->push(m_repositoryPath, m_branch, m_githubUsername, token)) {
-        m_operationInProgress = false;
+    m_operationInProgress = false;
+    updateActionsEnabled();
+    
+    if (m_localFirst) {
+        // Pas d'attente du reseau: la file rend compte du push dans la barre d'etat
+        logSuccess(QString("=== COMMIT LOCAL ENREGISTRE: %1 commit(s) en file de push ===")
+                   .arg(m_pushQueue->pending()));
+        ui->statusbar->showMessage("Commit enregistre localement, push en arriere-plan", 5000);
+        ui->fileListWidget->clear();
+        refreshStatusView();
         return;
     }
     
-    m_operationInProgress = false;
     logSuccess("=== OPERATIONS GIT TERMINEES AVEC SUCCES ===");
     
+    // Les branches poussees emportent les commits qui attendaient dans la file
+    m_pushQueue->discard(m_branch);
+    for (const QString& branch : std::as_const(extraBranches)) {
+        m_pushQueue->discard(branch);
+    }
+    
+    // Rafraichir l'indicateur d'avance/retard des la reprise de la synchronisation
+    m_fetchScheduler->fetchNow();
+    
     QMessageBox::information(this, "Succes",
         "Le projet a ete pousse sur GitHub avec succes !\n\n"
         "Depot: " + m_remoteUrl + "\n"
-        "Branche: " + m_branch);
+        "Branche: " + (QStringList() << m_branch << extraBranches).join(", "));
     
     // Nettoyer la liste
     ui->fileListWidget->clear();
+    refreshStatusView();
 }
 
 void MainWindow::on_actionConfigurer_triggered() {
@@ -616,7 +901,152 @@ void MainWindow::on_actionConfigurer_triggered() {
         &ok);
     
     if (ok && !branch.isEmpty() && branch != m_branch) {
-        m_branch = branch;
+        if (!m_gitManager->isValidBranchName(branch)) {
+            QMessageBox::warning(this, "Branche invalide",
+                               "Nom de branche refuse par Git: " + branch);
+        } else {
+            m_branch = branch;
+            modified = true;
+        }
+    }
+    
+    // Branches recevant le meme contenu (release, docs...): commits sans checkout
+    QString extraBranches = QInputDialog::getText(this,
+        "Branches supplementaires",
+        "Branches publiees avec le meme contenu, separees par des virgules\n"
+        "(vide pour publier uniquement " + m_branch + "):",
+        QLineEdit::Normal,
+        m_extraBranches.join(", "),
+        &ok);
+    
+    if (ok) {
+        QStringList branches;
+        QStringList rejected;
+        for (const QString& name : extraBranches.split(',', Qt::SkipEmptyParts)) {
+            const QString trimmed = name.trimmed();
+            if (trimmed.isEmpty() || trimmed == m_branch || branches.contains(trimmed)) {
+                continue;
+            }
+            if (m_gitManager->isValidBranchName(trimmed)) {
+                branches << trimmed;
+            } else {
+                rejected << trimmed;
+            }
+        }
+        if (!rejected.isEmpty()) {
+            QMessageBox::warning(this, "Branches invalides",
+                               "Noms de branche refuses par Git, ignores: " + rejected.join(", "));
+        }
+        if (branches != m_extraBranches) {
+            m_extraBranches = branches;
+            modified = true;
+        }
+    }
+    
+    // Configuration du profil de transport
+    const QList<TransportProfile> profiles = {
+        TransportProfile::Default,
+        TransportProfile::LanBulk,
+        TransportProfile::WanLowBandwidth,
+        TransportProfile::ManySmallFiles
+    };
+    QStringList profileNames;
+    for (TransportProfile profile : profiles) {
+        profileNames << GitManager::transportProfileName(profile);
+    }
+    
+    QString profileName = QInputDialog::getItem(this,
+        "Profil de transport",
+        "Choisissez le profil reseau utilise pour push/pull:",
+        profileNames,
+        static_cast<int>(profiles.indexOf(m_transportProfile)),
+        false,
+        &ok);
+    
+    if (ok) {
+        TransportProfile profile = profiles.value(profileNames.indexOf(profileName));
+        if (profile != m_transportProfile) {
+            m_transportProfile = profile;
+            m_gitManager->setTransportProfile(profile);
+            modified = true;
+        }
+    }
+    
+    // Profondeur du clone initial
+    int cloneDepth = QInputDialog::getInt(this,
+        "Clone initial",
+        "Profondeur d'historique lors du premier clone\n"
+        "(0 = historique complet, les fichiers sont toujours telecharges a la demande):",
+        m_cloneDepth,
+        0,
+        100000,
+        1,
+        &ok);
+    
+    if (ok && cloneDepth != m_cloneDepth) {
+        m_cloneDepth = cloneDepth;
+        modified = true;
+    }
+    
+    // Moteur des operations locales, si plusieurs sont compiles
+    const QList<GitBackend::Kind> backends = GitManager::availableBackends();
+    if (backends.size() > 1) {
+        QStringList backendNames;
+        for (GitBackend::Kind kind : backends) {
+            backendNames << GitBackend::kindName(kind);
+        }
+        
+        QString backendName = QInputDialog::getItem(this,
+            "Moteur Git",
+            "Moteur utilise pour status, ajout, commit et references\n"
+            "(le reseau passe toujours par git):",
+            backendNames,
+            static_cast<int>(backends.indexOf(m_gitManager->backendKind())),
+            false,
+            &ok);
+        
+        GitBackend::Kind kind = backends.value(backendNames.indexOf(backendName), GitBackend::Kind::Process);
+        if (ok && kind != m_gitManager->backendKind() && m_gitManager->setBackend(kind)) {
+            modified = true;
+        }
+    }
+    
+    // Mode de publication: attendre le push, ou commit local et push en arriere-plan
+    const QStringList publishModes = {
+        "Push immediat (attend le depot distant)",
+        "Commit local, push en arriere-plan (hors ligne possible)"
+    };
+    QString publishMode = QInputDialog::getItem(this,
+        "Mode de publication",
+        "Choisissez le comportement du bouton de publication:",
+        publishModes,
+        m_localFirst ? 1 : 0,
+        false,
+        &ok);
+    
+    if (ok && (publishModes.indexOf(publishMode) == 1) != m_localFirst) {
+        m_localFirst = !m_localFirst;
+        modified = true;
+    }
+    
+    // Sous-dossier cible: seul ce dossier du depot est present localement
+    QString subdirectory = QInputDialog::getText(this,
+        "Sous-dossier de publication",
+        "Dossier du depot dans lequel publier (vide = racine du depot).\n"
+        "Pour un gros monorepo, seul ce dossier est recupere et extrait localement:",
+        QLineEdit::Normal,
+        m_gitManager->publishSubdirectory(),
+        &ok);
+    
+    // Comparaison sur la forme normalisee: "cible/" ne modifie pas "cible"
+    bool subdirectoryValid = false;
+    const QString cleanedSubdirectory = GitManager::cleanSubdirectory(subdirectory, &subdirectoryValid);
+    if (ok && !subdirectoryValid) {
+        QMessageBox::warning(this, "Sous-dossier refuse",
+                           "Le sous-dossier doit etre un chemin relatif a l'interieur du depot "
+                           "(sans \"..\" ni \".git\"). Valeur precedente conservee.");
+    } else if (ok && cleanedSubdirectory != m_gitManager->publishSubdirectory()) {
+        m_gitManager->setPublishSubdirectory(cleanedSubdirectory);
         modified = true;
     }
     
@@ -685,6 +1115,9 @@ void MainWindow::on_actionConfigurer_triggered() {
     
     if (modified) {
         saveSettings();
+        configureFetchScheduler();
+        m_fetchScheduler->fetchNow();
+        refreshStatusView();
         logSuccess("Configuration mise a jour");
         
         QString tokenStatus = m_githubToken.isEmpty() ? "Non configure" : "Configure (********)";
@@ -695,8 +1128,10 @@ void MainWindow::on_actionConfigurer_triggered() {
                     "Depot distant: %2\n"
                     "Branche: %3\n"
                     "Utilisateur: %4\n"
-                    "Token: %5")
-                .arg(m_repositoryPath, m_remoteUrl, m_branch, m_githubUsername, tokenStatus));
+                    "Token: %5\n"
+                    "Profil de transport: %6")
+                .arg(m_repositoryPath, m_remoteUrl, m_branch, m_githubUsername, tokenStatus,
+                     GitManager::transportProfileName(m_transportProfile)));
     } else {
         logMessage("Configuration annulee - Aucune modification.");
     }
@@ -710,6 +1145,62 @@ void MainWindow::on_actionQuitter_triggered() {
     close();
 }
 
+void MainWindow::on_actionStatistiques_triggered() {
+    GitMetrics& metrics = m_gitManager->metrics();
+
+    QDialog dialog(this);
+    dialog.setWindowTitle("Statistiques");
+    dialog.resize(560, 420);
+
+    QPlainTextEdit* view = new QPlainTextEdit(&dialog);
+    view->setReadOnly(true);
+    view->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    view->setPlainText(metrics.summary());
+
+    QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Close, &dialog);
+    QPushButton* jsonButton = buttons->addButton("Exporter JSON...", QDialogButtonBox::ActionRole);
+    QPushButton* prometheusButton = buttons->addButton("Exporter Prometheus...", QDialogButtonBox::ActionRole);
+    QPushButton* resetButton = buttons->addButton("Reinitialiser", QDialogButtonBox::ResetRole);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+
+    connect(jsonButton, &QPushButton::clicked, &dialog, [this, &dialog, &metrics]() {
+        QString path = QFileDialog::getSaveFileName(&dialog, "Exporter les statistiques",
+                                                    "rogue-metrics.json", "JSON (*.json)");
+        if (path.isEmpty()) {
+            return;
+        }
+        if (metrics.saveJson(path)) {
+            logSuccess("Statistiques exportees: " + path);
+        } else {
+            logError("Impossible d'ecrire: " + path);
+        }
+    });
+
+    connect(prometheusButton, &QPushButton::clicked, &dialog, [this, &dialog, &metrics]() {
+        QString path = QFileDialog::getSaveFileName(&dialog, "Exporter les statistiques",
+                                                    "rogue-metrics.prom", "Prometheus (*.prom *.txt)");
+        if (path.isEmpty()) {
+            return;
+        }
+        if (metrics.savePrometheus(path)) {
+            logSuccess("Statistiques exportees: " + path);
+        } else {
+            logError("Impossible d'ecrire: " + path);
+        }
+    });
+
+    connect(resetButton, &QPushButton::clicked, &dialog, [view, &metrics]() {
+        metrics.reset();
+        view->setPlainText(metrics.summary());
+    });
+
+    QVBoxLayout* layout = new QVBoxLayout(&dialog);
+    layout->addWidget(view);
+    layout->addWidget(buttons);
+
+    dialog.exec();
+}
+
 void MainWindow::onGitOperationStarted(const QString& message) {
     logMessage("[GIT] " + message);
     showProgressDialog(message);
@@ -721,11 +1212,24 @@ void MainWindow::onGitOperationSuccess(const QString& message) {
 }
 
 void MainWindow::onGitOperationFailed(const QString& error, GitError errorCode) {
+    // L'annulation a deja ete signalee par onGitOperationCancelled
+    if (errorCode == GitError::UserCancelled) {
+        hideProgressDialog();
+        m_operationInProgress = false;
+        updateActionsEnabled();
+        if (m_gitManager->lastCancelLatencyMs() >= 0) {
+            logMessage(QString("[GIT] Annulation effective en %1 ms")
+                      .arg(m_gitManager->lastCancelLatencyMs()));
+        }
+        return;
+    }
+    
     QString fullMessage = getErrorMessage(errorCode, error);
     logError("[GIT] " + fullMessage);
     hideProgressDialog();
     
     m_operationInProgress = false;
+    updateActionsEnabled();
     
     // Afficher un message d'erreur detaille
     QMessageBox::critical(this, "Erreur Git", fullMessage);
@@ -735,11 +1239,16 @@ void MainWindow::onGitOperationCancelled() {
     logMessage("[GIT] Operation annulee par l'utilisateur");
     hideProgressDialog();
     m_operationInProgress = false;
+    updateActionsEnabled();
     
     QMessageBox::information(this, "Operation annulee",
                            "L'operation Git a ete annulee.");
 }
 
+void MainWindow::onGitOperationWarning(const QString& message) {
+    logMessage("[GIT] Avertissement: " + message);
+}
+
 void MainWindow::onRetryAttempt(int attempt, int maxAttempts) {
     QString message = QString("Nouvelle tentative %1/%2...").arg(attempt).arg(maxAttempts);
     logMessage("[GIT] " + message);
@@ -759,4 +1268,86 @@ void MainWindow::onConnectionCheckCompleted(bool success) {
     } else {
         logError("[RESEAU] Aucune connexion detectee");
     }
-}
\ No newline at end of file
+}
+
+void MainWindow::configureFetchScheduler() {
+    m_fetchScheduler->setRepository(m_repositoryPath, m_remoteUrl, m_branch);
+    m_fetchScheduler->setCredentials(m_githubUsername, m_githubToken);
+    m_fetchScheduler->setTransportProfile(m_transportProfile);
+    
+    m_pushQueue->setRepository(m_repositoryPath, m_remoteUrl);
+    m_pushQueue->setCredentials(m_githubUsername, m_githubToken);
+    m_pushQueue->setTransportProfile(m_transportProfile);
+    m_pushQueue->setPushLimits(m_gitManager->chunkThreshold(), m_gitManager->pushTimeout());
+}
+
+void MainWindow::refreshStatusView() {
+    ui->statusLabel->setText("Modifications a publier : chargement...");
+    ui->statusLabel->setToolTip(QString());
+    m_statusModel->refresh(m_repositoryPath);
+}
+
+void MainWindow::onRemoteStatusChanged(int ahead, int behind) {
+    if (ahead == 0 && behind == 0) {
+        m_syncStatusLabel->setText(QString("%1: a jour").arg(m_branch));
+    } else {
+        m_syncStatusLabel->setText(QString("%1: ↑%2 ↓%3").arg(m_branch).arg(ahead).arg(behind));
+    }
+    m_syncStatusLabel->setToolTip(QString("%1 commit(s) a pousser, %2 commit(s) a recuperer")
+                                  .arg(ahead).arg(behind));
+}
+
+void MainWindow::onFastForwarded(int commits) {
+    logSuccess(QString("[SYNC] %1 commit(s) distant(s) recupere(s) en fast-forward").arg(commits));
+    refreshStatusView();
+}
+
+void MainWindow::onBackgroundFetchFailed(const QString& error) {
+    m_syncStatusLabel->setText(QString("%1: synchronisation impossible").arg(m_branch));
+    m_syncStatusLabel->setToolTip(error);
+}
+
+void MainWindow::onPushQueueChanged(int pending, PushQueue::State state) {
+    if (pending == 0 && state != PushQueue::State::Pushing) {
+        m_pushQueueLabel->hide();
+        return;
+    }
+    
+    switch (state) {
+        case PushQueue::State::Pushing:
+            m_pushQueueLabel->setText(QString("Push: envoi de %1 commit(s)...").arg(pending));
+            break;
+        case PushQueue::State::Waiting:
+            m_pushQueueLabel->setText(QString("Push: %1 en attente (hors ligne)").arg(pending));
+            break;
+        case PushQueue::State::Blocked:
+            m_pushQueueLabel->setText(QString("Push: %1 en attente, refuse").arg(pending));
+            break;
+        case PushQueue::State::Idle:
+            m_pushQueueLabel->setText(QString("Push: %1 en attente").arg(pending));
+            break;
+    }
+    
+    QStringList lines;
+    for (const PushQueue::Entry& entry : m_pushQueue->entries()) {
+        lines << QString("%1 %2 (%3)").arg(entry.commit.left(8), entry.message, entry.branch);
+    }
+    if (!m_pushQueue->lastError().isEmpty()) {
+        lines << QString() << m_pushQueue->lastError();
+    }
+    m_pushQueueLabel->setToolTip(lines.join('\n'));
+    m_pushQueueLabel->show();
+}
+
+void MainWindow::onBackgroundPushed(int commits) {
+    logSuccess(QString("[PUSH] %1 commit(s) pousse(s) en arriere-plan").arg(commits));
+    m_fetchScheduler->fetchNow();
+}
+
+void MainWindow::onBackgroundPushFailed(const QString& error, bool willRetry) {
+    if (willRetry) {
+        logMessage("[PUSH] Depot distant injoignable, nouvel essai automatique: " + error);
+    } else {
+        logError("[PUSH] Push refuse, la file attend la prochaine publication: " + error);
+    }
+}
@@ -0,0 +1,228 @@
+﻿#include "include/prepushdialog.h"
+#include <QLabel>
+#include <QTreeWidget>
+#include <QTreeWidgetItem>
+#include <QHeaderView>
+#include <QPlainTextEdit>
+#include <QDialogButtonBox>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QFontDatabase>
+#include <QLocale>
+#include <QSharedPointer>
+
+namespace {
+
+// Au-dela, le resume est mis en evidence
+const qint64 kLargeChangeFiles = 10000;
+const qint64 kLargeChangeBytes = 100LL * 1024 * 1024;
+
+QString stateLabel(QChar status) {
+    switch (status.toLatin1()) {
+    case 'A': return "Ajoute";
+    case 'D': return "Supprime";
+    case 'T': return "Type modifie";
+    default: return "Modifie";
+    }
+}
+
+} // namespace
+
+PrePushDialog::PrePushDialog(const QString& repoPath, const QString& remoteUrl, const QString& branch,
+                             const ChangeSummary& summary, QWidget* parent)
+    : QDialog(parent)
+    , m_repoPath(repoPath)
+    , m_totalFiles(summary.files)
+    , m_linesLabel(new QLabel(this))
+    , m_largestTree(new QTreeWidget(this))
+    , m_numstat(new QProcess(this))
+    , m_numstatFiles(0)
+    , m_linesAdded(0)
+    , m_linesRemoved(0)
+    , m_binaryFiles(0) {
+    setWindowTitle("Confirmer le push");
+    resize(720, 520);
+
+    QLocale locale;
+    QLabel* targetLabel = new QLabel(QString("Publication sur %1 (branche %2)").arg(remoteUrl, branch), this);
+    targetLabel->setWordWrap(true);
+
+    QLabel* summaryLabel = new QLabel(
+        QString("%1 fichier(s): %2 ajoute(s), %3 modifie(s), %4 supprime(s) - %5")
+            .arg(summary.files).arg(summary.added).arg(summary.modified).arg(summary.deleted)
+            .arg(locale.formattedDataSize(summary.bytes)), this);
+    QFont bold = summaryLabel->font();
+    bold.setBold(true);
+    summaryLabel->setFont(bold);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addWidget(targetLabel);
+    layout->addWidget(summaryLabel);
+    layout->addWidget(m_linesLabel);
+
+    if (summary.files >= kLargeChangeFiles || summary.bytes >= kLargeChangeBytes) {
+        QLabel* warning = new QLabel("Attention: publication volumineuse. Verifiez qu'aucun dossier "
+                                     "inattendu (build, dependances...) n'a ete ajoute.", this);
+        warning->setWordWrap(true);
+        warning->setStyleSheet("color: #c00000;");
+        layout->addWidget(warning);
+    }
+
+    // Plus gros fichiers; le diff n'est charge qu'au deploiement
+    layout->addWidget(new QLabel("Plus gros fichiers (deployer pour voir le diff) :", this));
+    m_largestTree->setColumnCount(3);
+    m_largestTree->setHeaderLabels(QStringList() << "Fichier" << "Etat" << "Taille");
+    m_largestTree->setUniformRowHeights(false);
+    m_largestTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_largestTree->header()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+    m_largestTree->header()->setSectionResizeMode(2, QHeaderView::ResizeToContents);
+    m_largestTree->header()->setStretchLastSection(false);
+    for (const ChangeSummary::FileChange& change : summary.largest) {
+        QTreeWidgetItem* item = new QTreeWidgetItem(m_largestTree);
+        item->setText(0, change.path);
+        item->setText(1, stateLabel(change.status));
+        item->setText(2, locale.formattedDataSize(change.bytes));
+        item->setToolTip(0, change.path);
+        item->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+    }
+    connect(m_largestTree, &QTreeWidget::itemExpanded, this, &PrePushDialog::onItemExpanded);
+    layout->addWidget(m_largestTree, 1);
+
+    QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Cancel, this);
+    QPushButton* pushButton = buttons->addButton("Publier", QDialogButtonBox::AcceptRole);
+    pushButton->setDefault(true);
+    connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    layout->addWidget(buttons);
+
+    // Lignes ajoutees/supprimees: lecture du contenu, donc en arriere-plan
+    updateLinesLabel(false);
+    connect(m_numstat, &QProcess::readyReadStandardOutput, this, &PrePushDialog::onNumstatReadyRead);
+    connect(m_numstat, &QProcess::finished, this, &PrePushDialog::onNumstatFinished);
+    m_numstat->setWorkingDirectory(m_repoPath);
+    m_numstat->start("git", QStringList() << "diff" << "--cached" << "--numstat" << "-z" << "--no-renames");
+}
+
+PrePushDialog::~PrePushDialog() {
+    stopProcess(m_numstat);
+    const QList<QProcess*> pending = m_diffRequests.keys();
+    for (QProcess* process : pending) {
+        stopProcess(process);
+    }
+}
+
+void PrePushDialog::stopProcess(QProcess* process) {
+    process->disconnect(this);
+    if (process->state() != QProcess::NotRunning) {
+        process->kill();
+        process->waitForFinished(1000);
+    }
+}
+
+void PrePushDialog::onNumstatReadyRead() {
+    m_numstatBuffer.append(m_numstat->readAllStandardOutput());
+    parseNumstat();
+    updateLinesLabel(false);
+}
+
+void PrePushDialog::onNumstatFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    if (exitStatus != QProcess::NormalExit || exitCode != 0) {
+        m_linesLabel->setText("Lignes: calcul impossible");
+        return;
+    }
+    m_numstatBuffer.append(m_numstat->readAllStandardOutput());
+    parseNumstat();
+    updateLinesLabel(true);
+}
+
+void PrePushDialog::parseNumstat() {
+    // Enregistrement: ajoutees TAB supprimees TAB chemin NUL ("-" pour un binaire)
+    qsizetype position = 0;
+    while (true) {
+        qsizetype end = m_numstatBuffer.indexOf('\0', position);
+        if (end < 0) {
+            break;
+        }
+
+        QByteArray record = m_numstatBuffer.mid(position, end - position);
+        position = end + 1;
+
+        qsizetype firstTab = record.indexOf('\t');
+        qsizetype secondTab = record.indexOf('\t', firstTab + 1);
+        if (firstTab < 0 || secondTab < 0) {
+            continue;
+        }
+
+        QByteArray added = record.left(firstTab);
+        if (added == "-") {
+            m_binaryFiles++;
+        } else {
+            m_linesAdded += added.toLongLong();
+            m_linesRemoved += record.mid(firstTab + 1, secondTab - firstTab - 1).toLongLong();
+        }
+        m_numstatFiles++;
+    }
+    m_numstatBuffer.remove(0, position);
+}
+
+void PrePushDialog::updateLinesLabel(bool finished) {
+    QString text = QString("Lignes: +%1 / -%2").arg(m_linesAdded).arg(m_linesRemoved);
+    if (m_binaryFiles > 0) {
+        text += QString(", %1 fichier(s) binaire(s)").arg(m_binaryFiles);
+    }
+    if (!finished) {
+        text += QString(" (calcul en cours: %1 / %2 fichiers)").arg(m_numstatFiles).arg(m_totalFiles);
+    }
+    m_linesLabel->setText(text);
+}
+
+void PrePushDialog::onItemExpanded(QTreeWidgetItem* item) {
+    if (item->parent() || item->childCount() > 0) {
+        return; // Diff deja charge ou en cours
+    }
+
+    QTreeWidgetItem* placeholder = new QTreeWidgetItem(item);
+    placeholder->setText(0, "Chargement du diff...");
+    placeholder->setFirstColumnSpanned(true);
+
+    QProcess* process = new QProcess(this);
+    auto output = QSharedPointer<QByteArray>::create();
+    m_diffRequests.insert(process, item);
+
+    // Lecture bornee: un diff geant est tronque sans etre entierement charge
+    connect(process, &QProcess::readyReadStandardOutput, this, [this, process, output]() {
+        output->append(process->readAllStandardOutput());
+        if (output->size() > maxDiffBytes()) {
+            process->kill();
+        }
+    });
+    connect(process, &QProcess::finished, this, [this, process, output, placeholder]() {
+        QTreeWidgetItem* entry = m_diffRequests.take(process);
+        process->deleteLater();
+        if (!entry) {
+            return;
+        }
+
+        output->append(process->readAllStandardOutput());
+        bool truncated = output->size() > maxDiffBytes();
+        QString text = QString::fromUtf8(output->left(maxDiffBytes()));
+        if (truncated) {
+            text += QString("\n[... diff tronque a %1 ...]").arg(QLocale().formattedDataSize(maxDiffBytes()));
+        } else if (text.isEmpty()) {
+            text = "(aucune difference textuelle)";
+        }
+
+        QPlainTextEdit* view = new QPlainTextEdit();
+        view->setReadOnly(true);
+        view->setLineWrapMode(QPlainTextEdit::NoWrap);
+        view->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+        view->setMinimumHeight(220);
+        view->setPlainText(text);
+        placeholder->setText(0, QString());
+        m_largestTree->setItemWidget(placeholder, 0, view);
+    });
+
+    process->setWorkingDirectory(m_repoPath);
+    process->start("git", QStringList() << "diff" << "--cached" << "--no-renames" << "--no-ext-diff"
+                                        << "--" << ":(literal)" + item->text(0));
+}
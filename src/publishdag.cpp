@@ -0,0 +1,117 @@
+﻿#include "include/publishdag.h"
+#include <QThreadPool>
+#include <QEventLoop>
+#include <QDebug>
+
+PublishDag::PublishDag(QObject* parent)
+    : QObject(parent)
+    , m_running(0) {
+}
+
+void PublishDag::addStep(const Step& step) {
+    m_steps.append(step);
+    m_outcomes.insert(step.id, Outcome::Pending);
+}
+
+QStringList PublishDag::skippedSteps() const {
+    QStringList skipped;
+    for (const Step& step : m_steps) {
+        if (m_outcomes.value(step.id) == Outcome::Skipped) {
+            skipped << step.id;
+        }
+    }
+    return skipped;
+}
+
+bool PublishDag::isReady(const Step& step) const {
+    for (const QString& dependency : step.dependsOn) {
+        Outcome state = m_outcomes.value(dependency, Outcome::Pending);
+        if (state != Outcome::Done && state != Outcome::Skipped) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void PublishDag::finishStep(const QString& id, bool success) {
+    m_outcomes[id] = success ? Outcome::Done : Outcome::Failed;
+    if (!success && m_failedStep.isEmpty()) {
+        m_failedStep = id;
+    }
+    emit stepFinished(id, success);
+}
+
+bool PublishDag::run() {
+    m_failedStep.clear();
+    QEventLoop loop;
+
+    while (true) {
+        bool progressed = false;
+
+        // Etapes concurrentes d'abord: elles avancent pendant les etapes synchrones
+        for (int pass = 0; pass < 2 && m_failedStep.isEmpty(); ++pass) {
+            bool concurrentPass = (pass == 0);
+            for (const Step& step : m_steps) {
+                if (m_outcomes.value(step.id) != Outcome::Pending || step.concurrent != concurrentPass ||
+                    !isReady(step)) {
+                    continue;
+                }
+
+                if (step.satisfied && step.satisfied()) {
+                    m_outcomes[step.id] = Outcome::Skipped;
+                    emit stepSkipped(step.id);
+                    progressed = true;
+                    continue;
+                }
+
+                emit stepStarted(step.id);
+                progressed = true;
+
+                if (step.concurrent) {
+                    // Le resultat revient dans ce thread; run() ne rend pas la main avant
+                    m_outcomes[step.id] = Outcome::Running;
+                    ++m_running;
+                    const QString id = step.id;
+                    const std::function<bool()> work = step.run;
+                    QThreadPool::globalInstance()->start([this, id, work, &loop]() {
+                        bool success = work();
+                        QMetaObject::invokeMethod(this, [this, id, success, &loop]() {
+                            --m_running;
+                            finishStep(id, success);
+                            loop.quit();
+                        }, Qt::QueuedConnection);
+                    });
+                } else {
+                    finishStep(step.id, step.run());
+                    if (!m_failedStep.isEmpty()) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (progressed && m_failedStep.isEmpty()) {
+            continue;
+        }
+
+        // Plus rien a lancer: attendre les etapes concurrentes en cours
+        if (m_running > 0) {
+            loop.exec();
+            continue;
+        }
+        break;
+    }
+
+    if (!m_failedStep.isEmpty()) {
+        return false;
+    }
+
+    for (const Step& step : m_steps) {
+        if (m_outcomes.value(step.id) == Outcome::Pending) {
+            qWarning() << "Etape jamais executee (dependance manquante ou cycle):" << step.id;
+            m_failedStep = step.id;
+            return false;
+        }
+    }
+    return true;
+}
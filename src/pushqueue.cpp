@@ -0,0 +1,369 @@
+﻿#include "include/pushqueue.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QThread>
+#include <QNetworkInformation>
+#include <algorithm>
+
+PushQueue::PushQueue(QObject* parent)
+    : QObject(parent)
+    , m_retryTimer(new QTimer(this))
+    , m_thread(new QThread(this))
+    , m_git(new GitManager())
+    , m_pushing(false)
+    , m_generation(0)
+    , m_state(State::Idle)
+    , m_pauseCount(0)
+    , m_pendingAttempt(false)
+    , m_minRetryMs(15000)
+    , m_maxRetryMs(10 * 60 * 1000)
+    , m_retryMs(15000)
+    , m_transportProfile(TransportProfile::Default)
+    , m_chunkThreshold(1024LL * 1024 * 1024)
+    , m_pushTimeoutMs(120000) {
+    m_retryTimer->setSingleShot(true);
+    connect(m_retryTimer, &QTimer::timeout, this, &PushQueue::attempt);
+
+    // Push, lots et attentes hors du thread de l'interface
+    m_git->moveToThread(m_thread);
+    connect(m_thread, &QThread::finished, m_git, &QObject::deleteLater);
+    m_thread->start();
+
+    // Retour du reseau signale par le systeme: essai sans attendre la fin du delai
+    if (QNetworkInformation::loadBackendByFeatures(QNetworkInformation::Feature::Reachability)) {
+        connect(QNetworkInformation::instance(), &QNetworkInformation::reachabilityChanged, this,
+                [this](QNetworkInformation::Reachability reachability) {
+            if (reachability == QNetworkInformation::Reachability::Online && m_state == State::Waiting) {
+                m_retryTimer->stop();
+                attempt();
+            }
+        });
+    }
+}
+
+PushQueue::~PushQueue() {
+    // Push en cours annule: le GitManager tue git avant d'etre detruit avec son thread
+    QMetaObject::invokeMethod(m_git, &GitManager::cancelOperation, Qt::QueuedConnection);
+    m_thread->quit();
+    m_thread->wait();
+}
+
+void PushQueue::setRepository(const QString& repoPath, const QString& remoteUrl) {
+    if (repoPath == m_repoPath && remoteUrl == m_remoteUrl) {
+        return;
+    }
+
+    // Push de l'ancien depot abandonne: son resultat sera ignore
+    ++m_generation;
+    if (m_pushing) {
+        QMetaObject::invokeMethod(m_git, &GitManager::cancelOperation, Qt::QueuedConnection);
+    }
+    m_retryTimer->stop();
+    m_retryMs = m_minRetryMs;
+    m_lastError.clear();
+
+    m_repoPath = repoPath;
+    m_remoteUrl = remoteUrl;
+    load();
+    setState(State::Idle);
+
+    // Commits restes en file a la derniere fermeture
+    if (!m_entries.isEmpty()) {
+        QTimer::singleShot(0, this, &PushQueue::attempt);
+    }
+}
+
+void PushQueue::setCredentials(const QString& username, const QString& token) {
+    m_username = username;
+    m_token = token;
+}
+
+void PushQueue::setPushLimits(qint64 chunkThreshold, int pushTimeoutMs) {
+    m_chunkThreshold = chunkThreshold;
+    m_pushTimeoutMs = pushTimeoutMs;
+}
+
+void PushQueue::setRetryDelays(int minimumMs, int maximumMs) {
+    m_minRetryMs = minimumMs;
+    m_maxRetryMs = qMax(minimumMs, maximumMs);
+    m_retryMs = m_minRetryMs;
+}
+
+bool PushQueue::enqueue(const QString& branch, const QString& commit, const QString& message) {
+    Entry entry;
+    entry.commit = commit;
+    entry.branch = branch;
+    entry.message = message.section('\n', 0, 0).simplified();
+    entry.queuedAt = QDateTime::currentDateTimeUtc();
+    m_entries.append(entry);
+
+    const bool saved = save();
+    notify();
+
+    // Un refus precedent attend l'utilisateur: ce nouveau commit ne change rien
+    if (m_state != State::Blocked) {
+        m_retryTimer->stop();
+        attempt();
+    }
+    return saved;
+}
+
+void PushQueue::discard(const QString& branch) {
+    m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+                                   [&branch](const Entry& entry) { return entry.branch == branch; }),
+                    m_entries.end());
+    save();
+
+    if (m_entries.isEmpty() && !m_pushing) {
+        m_retryTimer->stop();
+        m_lastError.clear();
+        setState(State::Idle);
+    } else {
+        notify();
+    }
+}
+
+void PushQueue::pushNow() {
+    m_retryTimer->stop();
+    m_retryMs = m_minRetryMs;
+    if (m_state == State::Blocked) {
+        setState(State::Idle);
+    }
+    attempt();
+}
+
+void PushQueue::pause() {
+    ++m_pauseCount;
+
+    // Annulation transmise au thread du push, sans l'attendre: le resultat
+    // annule arrive plus tard et le push est rejoue a la reprise
+    if (m_pushing) {
+        m_pendingAttempt = true;
+        QMetaObject::invokeMethod(m_git, &GitManager::cancelOperation, Qt::QueuedConnection);
+    }
+}
+
+void PushQueue::resume() {
+    if (m_pauseCount == 0) {
+        return;
+    }
+
+    if (--m_pauseCount == 0 && m_pendingAttempt) {
+        QTimer::singleShot(0, this, &PushQueue::attempt);
+    }
+}
+
+void PushQueue::attempt() {
+    if (m_pauseCount > 0) {
+        m_pendingAttempt = true;
+        return;
+    }
+    if (m_pushing || m_state == State::Blocked) {
+        return;
+    }
+    if (m_entries.isEmpty()) {
+        setState(State::Idle);
+        return;
+    }
+    if (m_repoPath.isEmpty() || m_remoteUrl.isEmpty() ||
+        !QFileInfo::exists(QDir(m_repoPath).filePath(".git"))) {
+        return;
+    }
+
+    m_pendingAttempt = false;
+
+    // Un seul push pour toute la file: la branche emporte tous ses commits en attente
+    m_inFlight.clear();
+    for (auto it = m_entries.crbegin(); it != m_entries.crend(); ++it) {
+        const QString& branch = it->branch;
+        if (std::none_of(m_inFlight.cbegin(), m_inFlight.cend(),
+                         [&branch](const Entry& entry) { return entry.branch == branch; })) {
+            m_inFlight.prepend(*it);
+        }
+    }
+    QStringList branches;
+    for (const Entry& head : std::as_const(m_inFlight)) {
+        branches << head.branch;
+    }
+
+    m_pushing = true;
+    setState(State::Pushing);
+
+    // Une seule tentative par essai: la file porte elle-meme l'attente entre
+    // deux essais, sans sonde reseau prealable (git rapporte l'echec)
+    const int generation = m_generation;
+    const QString repoPath = m_repoPath;
+    const QString username = m_username;
+    const QString token = m_token;
+    const TransportProfile profile = m_transportProfile;
+    const qint64 chunkThreshold = m_chunkThreshold;
+    const int pushTimeoutMs = m_pushTimeoutMs;
+    GitManager* git = m_git;
+    QMetaObject::invokeMethod(m_git, [this, git, generation, repoPath, branches, username, token, profile,
+                                      chunkThreshold, pushTimeoutMs]() {
+        git->setTransportProfile(profile);
+        git->setChunkThreshold(chunkThreshold);
+        git->setPushTimeout(pushTimeoutMs);
+        git->setConnectivityVerified(true);
+        const bool success = branches.size() == 1
+            ? git->push(repoPath, branches.first(), username, token, 1)
+            : git->pushBranches(repoPath, branches, username, token, 1);
+        const GitError code = git->lastErrorCode();
+        const QString error = git->lastError();
+        QMetaObject::invokeMethod(this, [this, generation, success, code, error]() {
+            onPushFinished(generation, success, code, error);
+        }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
+
+void PushQueue::onPushFinished(int generation, bool success, GitError code, const QString& error) {
+    m_pushing = false;
+
+    // Resultat d'un depot abandonne entre-temps
+    if (generation != m_generation) {
+        attempt();
+        return;
+    }
+
+    // Push annule par pause(): rejoue a la reprise
+    if (!success && (code == GitError::UserCancelled || m_pauseCount > 0)) {
+        m_pendingAttempt = true;
+        setState(State::Waiting);
+        if (m_pauseCount == 0) {
+            QTimer::singleShot(0, this, &PushQueue::attempt);
+        }
+        return;
+    }
+
+    if (!success) {
+        m_lastError = redact(error).trimmed();
+        if (m_lastError.isEmpty()) {
+            m_lastError = "Push interrompu.";
+        }
+
+        // Refus du distant: reessayer ne changerait rien
+        const QString output = m_lastError.toLower();
+        const bool refused = code == GitError::AuthenticationFailed ||
+                             output.contains("[rejected]") || output.contains("non-fast-forward") ||
+                             output.contains("fetch first") || output.contains("permission to") ||
+                             output.contains("protected branch") || output.contains("[remote rejected]");
+        if (refused) {
+            m_retryTimer->stop();
+            setState(State::Blocked);
+        } else {
+            scheduleRetry();
+        }
+        emit pushFailed(m_lastError, !refused);
+        return;
+    }
+
+    // Retrait des entrees poussees: pour chaque branche, le commit pousse et
+    // tout ce qui le precede dans la file (les commits mis en file pendant le
+    // push restent pour le prochain essai)
+    int count = 0;
+    for (const Entry& head : std::as_const(m_inFlight)) {
+        int last = -1;
+        for (int i = 0; i < m_entries.size(); ++i) {
+            if (m_entries.at(i).branch == head.branch && m_entries.at(i).commit == head.commit) {
+                last = i;
+            }
+        }
+        for (int i = last; i >= 0; --i) {
+            if (m_entries.at(i).branch == head.branch) {
+                m_entries.removeAt(i);
+                ++count;
+            }
+        }
+    }
+    save();
+    m_retryMs = m_minRetryMs;
+    m_lastError.clear();
+    setState(State::Idle);
+    emit pushed(count);
+
+    if (!m_entries.isEmpty()) {
+        attempt();
+    }
+}
+
+void PushQueue::scheduleRetry() {
+    setState(State::Waiting);
+    m_retryTimer->start(m_retryMs);
+    m_retryMs = qMin(m_retryMs * 2, m_maxRetryMs);
+}
+
+void PushQueue::setState(State state) {
+    m_state = state;
+    notify();
+}
+
+void PushQueue::notify() {
+    emit queueChanged(pending(), m_state);
+}
+
+QString PushQueue::storagePath() const {
+    return QDir(m_repoPath).filePath(".git/rogue-publisher/push-queue");
+}
+
+bool PushQueue::load() {
+    m_entries.clear();
+    if (m_repoPath.isEmpty()) {
+        return false;
+    }
+
+    QFile file(storagePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return !file.exists();
+    }
+
+    // Une entree par ligne: commit, branche, date ISO, message, separes par des tabulations
+    while (!file.atEnd()) {
+        const QList<QByteArray> fields = file.readLine().trimmed().split('\t');
+        if (fields.size() < 4 || fields.at(0).isEmpty() || fields.at(1).isEmpty()) {
+            continue;
+        }
+        Entry entry;
+        entry.commit = QString::fromLatin1(fields.at(0));
+        entry.branch = QString::fromUtf8(fields.at(1));
+        entry.queuedAt = QDateTime::fromString(QString::fromLatin1(fields.at(2)), Qt::ISODate);
+        entry.message = QString::fromUtf8(fields.at(3));
+        m_entries.append(entry);
+    }
+    return true;
+}
+
+bool PushQueue::save() {
+    if (m_repoPath.isEmpty()) {
+        return false;
+    }
+
+    const QString path = storagePath();
+    if (m_entries.isEmpty()) {
+        return !QFile::exists(path) || QFile::remove(path);
+    }
+
+    if (!QDir().mkpath(QFileInfo(path).path())) {
+        return false;
+    }
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    for (const Entry& entry : std::as_const(m_entries)) {
+        file.write(QString("%1\t%2\t%3\t%4\n")
+                   .arg(entry.commit, entry.branch, entry.queuedAt.toString(Qt::ISODate), entry.message)
+                   .toUtf8());
+    }
+    return file.commit();
+}
+
+QString PushQueue::redact(const QString& text) const {
+    if (m_token.isEmpty()) {
+        return text;
+    }
+
+    QString redacted = text;
+    return redacted.replace(m_token, "********");
+}
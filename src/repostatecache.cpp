@@ -0,0 +1,212 @@
+﻿#include "include/repostatecache.h"
+#include <QFileSystemWatcher>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+
+RepoStateCache::RepoStateCache(QObject* parent)
+    : QObject(parent)
+    , m_watcher(new QFileSystemWatcher(this))
+    , m_loadCount(0) {
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &RepoStateCache::onPathChanged);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &RepoStateCache::onPathChanged);
+}
+
+const RepoState& RepoStateCache::state(const QString& repoPath) {
+    const QString key = QDir(repoPath).absolutePath();
+    auto found = m_entries.find(key);
+    if (found != m_entries.end()) {
+        return found->state;
+    }
+
+    Entry& entry = m_entries[key];
+    entry.state = load(key, entry);
+    return entry.state;
+}
+
+void RepoStateCache::invalidate(const QString& repoPath) {
+    if (repoPath.isEmpty()) {
+        const QStringList watched = m_watcher->files() + m_watcher->directories();
+        if (!watched.isEmpty()) {
+            m_watcher->removePaths(watched);
+        }
+        const QStringList keys = m_entries.keys();
+        m_entries.clear();
+        for (const QString& key : keys) {
+            emit invalidated(key);
+        }
+        return;
+    }
+
+    const QString key = QDir(repoPath).absolutePath();
+    auto found = m_entries.find(key);
+    if (found == m_entries.end()) {
+        return;
+    }
+    if (!found->watchedPaths.isEmpty()) {
+        m_watcher->removePaths(found->watchedPaths);
+    }
+    m_entries.erase(found);
+    emit invalidated(key);
+}
+
+void RepoStateCache::setOriginUrl(const QString& repoPath, const QString& url) {
+    const QString key = QDir(repoPath).absolutePath();
+    const QFileInfo config(key + "/.git/config");
+    if (!config.isFile()) {
+        return; // .git fichier (worktree): configuration non surveillee
+    }
+
+    m_origins.insert(key, KnownOrigin { config.lastModified(), config.size(), url });
+    auto found = m_entries.find(key);
+    if (found != m_entries.end()) {
+        found->state.originUrl = url;
+        found->state.originResolved = true;
+    }
+}
+
+void RepoStateCache::onPathChanged(const QString& path) {
+    QStringList stale;
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+        if (!it->watchedPaths.contains(path)) {
+            continue;
+        }
+
+        // Un dossier change pour bien d'autres raisons (index.lock, objets...):
+        // seuls les fichiers lus au chargement comptent
+        bool changed = !QFileInfo(path).isDir() ||
+                       QFileInfo::exists(it.key() + "/.git") != it->state.isRepository;
+        for (auto stamp = it->stamps.cbegin(); !changed && stamp != it->stamps.cend(); ++stamp) {
+            QFileInfo info(stamp.key());
+            changed = (info.exists() ? info.lastModified() : QDateTime()) != stamp.value();
+        }
+        if (changed) {
+            stale << it.key();
+        }
+    }
+
+    for (const QString& key : stale) {
+        invalidate(key);
+    }
+}
+
+void RepoStateCache::watch(Entry& entry, const QString& path, bool stamp) {
+    QFileInfo info(path);
+    if (stamp) {
+        entry.stamps.insert(path, info.exists() ? info.lastModified() : QDateTime());
+    }
+    if (info.exists() && m_watcher->addPath(path)) {
+        entry.watchedPaths << path;
+    }
+}
+
+RepoState RepoStateCache::load(const QString& key, Entry& entry) {
+    m_loadCount++;
+    RepoState state;
+
+    // Surveillance posee avant la lecture: une ecriture concurrente invalide l'entree
+    const QString gitDir = key + "/.git";
+    watch(entry, key, false);
+    watch(entry, gitDir, false);
+
+    QFileInfo gitInfo(gitDir);
+    state.isRepository = gitInfo.exists();
+    if (!gitInfo.isDir()) {
+        return state; // Pas de depot, ou .git fichier (worktree): git resoudra le reste
+    }
+
+    const QString configPath = gitDir + "/config";
+    const QString headPath = gitDir + "/HEAD";
+    const QString packedRefsPath = gitDir + "/packed-refs";
+    watch(entry, configPath);
+    watch(entry, headPath);
+    watch(entry, packedRefsPath);
+    watch(entry, gitDir + "/info", false);
+    watch(entry, gitDir + "/info/sparse-checkout");
+
+    readConfig(configPath, state);
+
+    // URL deja lue par git, valable si .git/config n'a pas bouge depuis
+    auto origin = m_origins.constFind(key);
+    if (origin != m_origins.cend()) {
+        const QFileInfo config(configPath);
+        if (config.lastModified() == origin->modified && config.size() == origin->size) {
+            state.originUrl = origin->url;
+            state.originResolved = true;
+        }
+    }
+
+    QFile headFile(headPath);
+    if (!headFile.open(QIODevice::ReadOnly)) {
+        return state;
+    }
+    QString head = QString::fromUtf8(headFile.readAll()).trimmed();
+
+    if (head.startsWith("ref: refs/heads/")) {
+        state.branch = head.mid(16);
+        const QString refPath = gitDir + "/refs/heads/" + state.branch;
+        watch(entry, QFileInfo(refPath).path(), false);
+        watch(entry, refPath);
+        state.head = readRef(gitDir, "refs/heads/" + state.branch, state.headResolved);
+    } else if (!head.startsWith("ref:")) {
+        state.head = head; // HEAD detachee
+        state.headResolved = !head.isEmpty();
+    }
+
+    return state;
+}
+
+void RepoStateCache::readConfig(const QString& configPath, RepoState& state) {
+    QFile config(configPath);
+    if (!config.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    // [core] sparseCheckout, seule cle lue ici
+    bool inCore = false;
+    const QList<QByteArray> lines = config.readAll().split('\n');
+    for (const QByteArray& rawLine : lines) {
+        QString line = QString::fromUtf8(rawLine).trimmed();
+        if (line.isEmpty() || line.startsWith('#') || line.startsWith(';')) {
+            continue;
+        }
+        if (line.startsWith('[')) {
+            QString section = line.mid(1, line.indexOf(']') - 1).simplified();
+            inCore = (section.compare("core", Qt::CaseInsensitive) == 0);
+            continue;
+        }
+        int equals = line.indexOf('=');
+        if (inCore && equals > 0 &&
+            line.left(equals).trimmed().compare("sparseCheckout", Qt::CaseInsensitive) == 0) {
+            state.sparseCheckout = (line.mid(equals + 1).trimmed().compare("true", Qt::CaseInsensitive) == 0);
+        }
+    }
+}
+
+QString RepoStateCache::readRef(const QString& gitDir, const QString& ref, bool& resolved) {
+    resolved = false;
+
+    QFile loose(gitDir + "/" + ref);
+    if (loose.open(QIODevice::ReadOnly)) {
+        QString value = QString::fromUtf8(loose.readAll()).trimmed();
+        resolved = !value.startsWith("ref:");
+        return resolved ? value : QString();
+    }
+
+    // Lignes: <sha> <reference>; "^<sha>" suit une etiquette annotee
+    QFile packed(gitDir + "/packed-refs");
+    if (packed.open(QIODevice::ReadOnly)) {
+        const QByteArray wanted = ' ' + ref.toUtf8();
+        while (!packed.atEnd()) {
+            QByteArray line = packed.readLine().trimmed();
+            if (line.endsWith(wanted) && !line.startsWith('#') && !line.startsWith('^')) {
+                resolved = true;
+                return QString::fromLatin1(line.left(line.size() - wanted.size()));
+            }
+        }
+    }
+
+    // Branche sans commit (depot neuf)
+    resolved = true;
+    return QString();
+}
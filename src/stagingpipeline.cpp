@@ -0,0 +1,199 @@
+﻿#include "include/stagingpipeline.h"
+#include <QDeadlineTimer>
+#include <QEventLoop>
+#include <QTimer>
+
+namespace {
+
+bool hasGitSegment(const QByteArray& path) {
+    for (qsizetype start = 0; start <= path.size();) {
+        qsizetype end = path.indexOf('/', start);
+        if (end < 0) {
+            end = path.size();
+        }
+        if (end - start == 4 && qstrnicmp(path.constData() + start, ".git", 4) == 0) {
+            return true;
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
+} // namespace
+
+StagingPipeline::StagingPipeline(const QString& repoPath)
+    : m_repoPath(repoPath)
+    , m_running(false)
+    , m_submitted(0)
+    , m_staged(0)
+    , m_ignored(0) {
+    // Verdicts traites des leur arrivee, sans attente bloquante
+    QObject::connect(&m_filter, &QProcess::readyReadStandardOutput, &m_filter, [this]() {
+        if (m_running) {
+            parseVerdicts();
+        }
+    });
+}
+
+StagingPipeline::~StagingPipeline() {
+    if (m_running) {
+        abort();
+    }
+}
+
+bool StagingPipeline::startProcess(QProcess& process, const QStringList& arguments) {
+    process.setWorkingDirectory(m_repoPath);
+    process.start("git", arguments);
+    if (!process.waitForStarted(5000)) {
+        m_error = "Impossible de demarrer git " + arguments.value(0);
+        return false;
+    }
+    return true;
+}
+
+bool StagingPipeline::start() {
+    // -v -n: un verdict par chemin, ignore ou non, emis des sa lecture
+    if (!startProcess(m_filter, QStringList() << "check-ignore" << "--stdin" << "-z" << "-v" << "-n")) {
+        return false;
+    }
+    // --remove: un chemin supprime de l'arbre de travail (miroir) quitte l'index
+    if (!startProcess(m_stager, QStringList() << "update-index" << "--add" << "--remove" << "-z" << "--stdin")) {
+        m_filter.kill();
+        m_filter.waitForFinished(1000);
+        return false;
+    }
+
+    m_running = true;
+    return true;
+}
+
+void StagingPipeline::submit(const QByteArray& relativePathUtf8) {
+    // Jamais de chemin sous un .git: update-index le refuserait et son arret
+    // interromprait toute l'indexation
+    if (!m_running || hasGitSegment(relativePathUtf8)) {
+        return;
+    }
+
+    m_filter.write(relativePathUtf8);
+    m_filter.write("\0", 1);
+    ++m_submitted;
+
+    // Contre-pression: la copie attend que git rattrape son retard
+    while (m_running &&
+           (m_submitted - m_staged - m_ignored > maxInFlightPaths() ||
+            m_stager.bytesToWrite() > maxBufferedBytes())) {
+        if (m_filter.state() == QProcess::NotRunning || m_stager.state() == QProcess::NotRunning) {
+            m_error = "Processus d'indexation interrompu";
+            abort();
+            return;
+        }
+        waitForProgress(100);
+    }
+}
+
+void StagingPipeline::waitForProgress(int waitMs) {
+    // Boucle locale: rendue des que git lit, ecrit ou se termine, et au plus
+    // tard apres waitMs. Les autres evenements du thread restent traites.
+    QEventLoop loop;
+    QTimer::singleShot(waitMs, &loop, &QEventLoop::quit);
+    QObject::connect(&m_filter, &QProcess::readyReadStandardOutput, &loop, &QEventLoop::quit);
+    QObject::connect(&m_stager, &QProcess::bytesWritten, &loop, &QEventLoop::quit);
+    for (QProcess* process : { &m_filter, &m_stager }) {
+        QObject::connect(process, &QProcess::finished, &loop, &QEventLoop::quit);
+    }
+    loop.exec();
+}
+
+void StagingPipeline::parseVerdicts() {
+    m_verdicts.append(m_filter.readAllStandardOutput());
+
+    // Enregistrement: source NUL ligne NUL motif NUL chemin NUL
+    qsizetype position = 0;
+    while (true) {
+        qsizetype fields[4];
+        qsizetype cursor = position;
+        int found = 0;
+        for (; found < 4; ++found) {
+            qsizetype end = m_verdicts.indexOf('\0', cursor);
+            if (end < 0) {
+                break;
+            }
+            fields[found] = end;
+            cursor = end + 1;
+        }
+        if (found < 4) {
+            break;
+        }
+
+        bool matched = fields[0] > position;
+        bool negated = m_verdicts.at(fields[1] + 1) == '!';
+        if (matched && !negated) {
+            ++m_ignored;
+        } else {
+            m_stager.write(m_verdicts.constData() + fields[2] + 1, fields[3] - fields[2]);
+            ++m_staged;
+        }
+        position = cursor;
+    }
+
+    if (position > 0) {
+        m_verdicts.remove(0, position);
+    }
+}
+
+bool StagingPipeline::finish(int timeoutMs) {
+    if (!m_running) {
+        return false;
+    }
+
+    QDeadlineTimer deadline(timeoutMs);
+    m_filter.closeWriteChannel();
+    while (m_filter.state() != QProcess::NotRunning) {
+        if (deadline.hasExpired()) {
+            m_error = "Timeout de git check-ignore";
+            abort();
+            return false;
+        }
+        waitForProgress(100);
+    }
+    parseVerdicts();
+
+    // check-ignore: 0 = au moins un chemin ignore, 1 = aucun
+    if (m_filter.exitStatus() != QProcess::NormalExit || m_filter.exitCode() > 1) {
+        m_error = QString::fromUtf8(m_filter.readAllStandardError()).trimmed();
+        abort();
+        return false;
+    }
+
+    m_stager.closeWriteChannel();
+    while (m_stager.state() != QProcess::NotRunning) {
+        if (deadline.hasExpired()) {
+            m_error = "Timeout de git update-index";
+            abort();
+            return false;
+        }
+        waitForProgress(100);
+    }
+    m_running = false;
+
+    if (m_stager.exitStatus() != QProcess::NormalExit || m_stager.exitCode() != 0) {
+        m_error = QString::fromUtf8(m_stager.readAllStandardError()).trimmed();
+        return false;
+    }
+
+    if (m_staged + m_ignored != m_submitted) {
+        m_error = QString("%1 chemin(s) sans verdict").arg(m_submitted - m_staged - m_ignored);
+        return false;
+    }
+    return true;
+}
+
+void StagingPipeline::abort() {
+    m_running = false;
+    for (QProcess* process : { &m_filter, &m_stager }) {
+        if (process->state() != QProcess::NotRunning) {
+            process->kill();
+            process->waitForFinished(1000);
+        }
+    }
+}
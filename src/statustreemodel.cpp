@@ -0,0 +1,420 @@
+﻿#include "include/statustreemodel.h"
+#include <QApplication>
+#include <QStyle>
+#include <QColor>
+#include <QDir>
+#include <QSignalBlocker>
+#include <algorithm>
+#include <cstring>
+
+StatusTreeModel::StatusTreeModel(QObject* parent)
+    : QAbstractItemModel(parent)
+    , m_process(new QProcess(this))
+    , m_skipOriginalPath(false)
+    , m_lastLoadMs(-1) {
+    connect(m_process, &QProcess::readyReadStandardOutput, this, &StatusTreeModel::onReadyRead);
+    connect(m_process, &QProcess::finished, this, &StatusTreeModel::onFinished);
+    connect(m_process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            emit loadingFailed("Impossible de demarrer Git.");
+        }
+    });
+
+    clear();
+}
+
+StatusTreeModel::~StatusTreeModel() {
+    if (m_process->state() != QProcess::NotRunning) {
+        const QSignalBlocker blocker(m_process);
+        m_process->kill();
+        m_process->waitForFinished(1000);
+    }
+}
+
+void StatusTreeModel::refresh(const QString& repoPath) {
+    // finished est emis pendant waitForFinished: la lecture remplacee ne doit
+    // signaler ni echec ni donnees
+    if (m_process->state() != QProcess::NotRunning) {
+        const QSignalBlocker blocker(m_process);
+        m_process->kill();
+        m_process->waitForFinished(1000);
+    }
+
+    m_pending.clear();
+    m_skipOriginalPath = false;
+    m_loadingArena.clear();
+    m_loadingRecords.clear();
+    m_lastLoadMs = -1;
+
+    if (repoPath.isEmpty() || !QDir(repoPath).exists(".git")) {
+        clear();
+        emit loadingFinished(0);
+        return;
+    }
+
+    // -uall: les fichiers non suivis sont listes un par un, pas par dossier.
+    // --no-optional-locks: pas d'index.lock pris pour rafraichir les stats,
+    // qui ferait echouer un add ou un commit lance pendant la lecture
+    m_process->setWorkingDirectory(repoPath);
+    m_loadTimer.start();
+    m_process->start("git", QStringList() << "--no-optional-locks" << "status" << "--porcelain=v2" << "-z"
+                                          << "--untracked-files=all");
+}
+
+void StatusTreeModel::clear() {
+    beginResetModel();
+    m_arena.clear();
+    m_records.clear();
+    m_sorted.clear();
+    m_nodes.clear();
+    m_nodes.append(Node { -1, 0, QByteArray(), 0, 0, true, {}, {} });
+    endResetModel();
+}
+
+void StatusTreeModel::onReadyRead() {
+    m_pending.append(m_process->readAllStandardOutput());
+    parseRecords(false);
+}
+
+void StatusTreeModel::parseRecords(bool atEnd) {
+    qsizetype position = 0;
+    while (true) {
+        qsizetype end = m_pending.indexOf('\0', position);
+        if (end < 0) {
+            break;
+        }
+
+        const char* record = m_pending.constData() + position;
+        qsizetype length = end - position;
+        position = end + 1;
+
+        if (m_skipOriginalPath) {
+            m_skipOriginalPath = false;
+            continue;
+        }
+        if (length < 3) {
+            continue;
+        }
+
+        // Nombre de champs separes par un espace avant le chemin
+        int fieldsBeforePath;
+        switch (record[0]) {
+        case '1': fieldsBeforePath = 8; break;
+        case '2': fieldsBeforePath = 9; m_skipOriginalPath = true; break;
+        case 'u': fieldsBeforePath = 10; break;
+        case '?': appendRecord('?', '?', record + 2, length - 2); continue;
+        default: continue; // En-tetes "#" et fichiers ignores "!"
+        }
+
+        qsizetype cursor = 0;
+        for (int field = 0; field < fieldsBeforePath && cursor < length; ++cursor) {
+            if (record[cursor] == ' ') {
+                ++field;
+            }
+        }
+        if (cursor >= length) {
+            continue;
+        }
+
+        char x = record[0] == 'u' ? 'U' : record[2];
+        char y = record[0] == 'u' ? 'U' : record[3];
+        appendRecord(x, y, record + cursor, length - cursor);
+    }
+
+    m_pending.remove(0, position);
+    if (atEnd) {
+        m_pending.clear();
+    }
+}
+
+void StatusTreeModel::appendRecord(char x, char y, const char* path, qsizetype length) {
+    // L'etat dans l'index prime: c'est ce que publiera le prochain commit
+    char state = (x != '.') ? x : y;
+    switch (state) {
+    case 'A': case 'M': case 'D': case 'R': case 'C': case 'T': case 'U': case '?':
+        break;
+    default:
+        state = 'M';
+    }
+
+    m_loadingRecords.append(Record { static_cast<quint32>(m_loadingArena.size()),
+                                     static_cast<quint32>(length),
+                                     static_cast<FileState>(state) });
+    m_loadingArena.append(path, length);
+}
+
+void StatusTreeModel::onFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    if (exitStatus != QProcess::NormalExit || exitCode != 0) {
+        QString error = QString::fromUtf8(m_process->readAllStandardError()).trimmed();
+        m_loadingArena.clear();
+        m_loadingRecords.clear();
+        emit loadingFailed(error.isEmpty() ? "git status a echoue." : error);
+        return;
+    }
+
+    m_pending.append(m_process->readAllStandardOutput());
+    parseRecords(true);
+    m_lastLoadMs = m_loadTimer.elapsed();
+
+    beginResetModel();
+    m_arena = std::move(m_loadingArena);
+    m_records = std::move(m_loadingRecords);
+    m_loadingArena = QByteArray();
+    m_loadingRecords = QVector<Record>();
+    buildTree();
+    endResetModel();
+
+    emit loadingFinished(m_sorted.size());
+}
+
+void StatusTreeModel::buildTree() {
+    m_sorted.resize(m_records.size());
+    for (qint32 i = 0; i < m_sorted.size(); ++i) {
+        m_sorted[i] = i;
+    }
+
+    // Ordre octet par octet: tout dossier devient un intervalle contigu
+    const char* arena = m_arena.constData();
+    std::sort(m_sorted.begin(), m_sorted.end(), [this, arena](qint32 a, qint32 b) {
+        const Record& left = m_records.at(a);
+        const Record& right = m_records.at(b);
+        int cmp = std::memcmp(arena + left.offset, arena + right.offset, qMin(left.length, right.length));
+        return cmp != 0 ? cmp < 0 : left.length < right.length;
+    });
+
+    m_nodes.clear();
+    m_nodes.append(Node { -1, 0, QByteArray(), 0, static_cast<qint32>(m_sorted.size()), false, {}, {} });
+    populate(0);
+    m_nodes[0].fetched = true;
+}
+
+void StatusTreeModel::populate(int nodeId) {
+    const QByteArray prefix = m_nodes.at(nodeId).prefix;
+    const qint32 begin = m_nodes.at(nodeId).begin;
+    const qint32 end = m_nodes.at(nodeId).end;
+
+    QVector<int> dirs;
+    QVector<qint32> files;
+    qint32 i = begin;
+    while (i < end) {
+        const Record& record = m_records.at(m_sorted.at(i));
+        const char* path = m_arena.constData() + record.offset;
+        const char* rest = path + prefix.size();
+        const char* slash = static_cast<const char*>(
+            std::memchr(rest, '/', record.length - prefix.size()));
+
+        if (!slash) {
+            files.append(i);
+            ++i;
+            continue;
+        }
+
+        // Tous les chemins du sous-dossier suivent: on saute l'intervalle entier
+        QByteArray childPrefix(path, static_cast<qsizetype>(slash - path) + 1);
+        qint32 j = i + 1;
+        while (j < end) {
+            const Record& next = m_records.at(m_sorted.at(j));
+            if (next.length < static_cast<quint32>(childPrefix.size()) ||
+                std::memcmp(m_arena.constData() + next.offset, childPrefix.constData(), childPrefix.size()) != 0) {
+                break;
+            }
+            ++j;
+        }
+
+        dirs.append(m_nodes.size());
+        m_nodes.append(Node { nodeId, static_cast<int>(dirs.size() - 1), childPrefix, i, j, false, {}, {} });
+        i = j;
+    }
+
+    m_nodes[nodeId].dirs = std::move(dirs);
+    m_nodes[nodeId].files = std::move(files);
+}
+
+QByteArray StatusTreeModel::pathOf(qint32 sortedIndex) const {
+    const Record& record = m_records.at(m_sorted.at(sortedIndex));
+    return QByteArray(m_arena.constData() + record.offset, record.length);
+}
+
+QByteArray StatusTreeModel::nameOf(qint32 sortedIndex, const Node& node) const {
+    return pathOf(sortedIndex).mid(node.prefix.size());
+}
+
+QString StatusTreeModel::relativePath(const QModelIndex& index) const {
+    if (!index.isValid()) {
+        return QString();
+    }
+
+    const Node& parentNode = m_nodes.at(static_cast<int>(index.internalId()));
+    if (index.row() < parentNode.dirs.size()) {
+        return QString::fromUtf8(m_nodes.at(parentNode.dirs.at(index.row())).prefix.chopped(1));
+    }
+    return QString::fromUtf8(pathOf(parentNode.files.at(index.row() - parentNode.dirs.size())));
+}
+
+QModelIndex StatusTreeModel::index(int row, int column, const QModelIndex& parent) const {
+    if (column < 0 || column >= 2 || row < 0) {
+        return QModelIndex();
+    }
+
+    int parentId = 0;
+    if (parent.isValid()) {
+        const Node& grandParent = m_nodes.at(static_cast<int>(parent.internalId()));
+        if (parent.row() >= grandParent.dirs.size()) {
+            return QModelIndex(); // Un fichier n'a pas d'enfant
+        }
+        parentId = grandParent.dirs.at(parent.row());
+    }
+
+    const Node& node = m_nodes.at(parentId);
+    if (row >= node.dirs.size() + node.files.size()) {
+        return QModelIndex();
+    }
+    // internalId: noeud parent; le rang distingue sous-dossiers et fichiers
+    return createIndex(row, column, static_cast<quintptr>(parentId));
+}
+
+QModelIndex StatusTreeModel::parent(const QModelIndex& child) const {
+    if (!child.isValid()) {
+        return QModelIndex();
+    }
+
+    int parentId = static_cast<int>(child.internalId());
+    if (parentId == 0) {
+        return QModelIndex();
+    }
+    const Node& node = m_nodes.at(parentId);
+    return createIndex(node.row, 0, static_cast<quintptr>(node.parent));
+}
+
+int StatusTreeModel::rowCount(const QModelIndex& parent) const {
+    if (parent.column() > 0) {
+        return 0;
+    }
+
+    int nodeId = 0;
+    if (parent.isValid()) {
+        const Node& grandParent = m_nodes.at(static_cast<int>(parent.internalId()));
+        if (parent.row() >= grandParent.dirs.size()) {
+            return 0;
+        }
+        nodeId = grandParent.dirs.at(parent.row());
+    }
+
+    const Node& node = m_nodes.at(nodeId);
+    return node.fetched ? static_cast<int>(node.dirs.size() + node.files.size()) : 0;
+}
+
+int StatusTreeModel::columnCount(const QModelIndex& parent) const {
+    Q_UNUSED(parent);
+    return 2;
+}
+
+bool StatusTreeModel::hasChildren(const QModelIndex& parent) const {
+    if (!parent.isValid()) {
+        return !m_sorted.isEmpty();
+    }
+    if (parent.column() > 0) {
+        return false;
+    }
+    const Node& grandParent = m_nodes.at(static_cast<int>(parent.internalId()));
+    return parent.row() < grandParent.dirs.size();
+}
+
+bool StatusTreeModel::canFetchMore(const QModelIndex& parent) const {
+    if (!parent.isValid()) {
+        return false;
+    }
+    const Node& grandParent = m_nodes.at(static_cast<int>(parent.internalId()));
+    if (parent.row() >= grandParent.dirs.size()) {
+        return false;
+    }
+    return !m_nodes.at(grandParent.dirs.at(parent.row())).fetched;
+}
+
+void StatusTreeModel::fetchMore(const QModelIndex& parent) {
+    if (!canFetchMore(parent)) {
+        return;
+    }
+
+    int nodeId = m_nodes.at(static_cast<int>(parent.internalId())).dirs.at(parent.row());
+    populate(nodeId);
+
+    int rows = static_cast<int>(m_nodes.at(nodeId).dirs.size() + m_nodes.at(nodeId).files.size());
+    if (rows == 0) {
+        m_nodes[nodeId].fetched = true;
+        return;
+    }
+    beginInsertRows(parent, 0, rows - 1);
+    m_nodes[nodeId].fetched = true;
+    endInsertRows();
+}
+
+QVariant StatusTreeModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    const Node& parentNode = m_nodes.at(static_cast<int>(index.internalId()));
+    bool isDir = index.row() < parentNode.dirs.size();
+
+    if (isDir) {
+        const Node& node = m_nodes.at(parentNode.dirs.at(index.row()));
+        switch (role) {
+        case Qt::DisplayRole:
+            if (index.column() == 0) {
+                return QString::fromUtf8(node.prefix.mid(parentNode.prefix.size()).chopped(1));
+            }
+            return QString("%1 fichier(s)").arg(node.end - node.begin);
+        case Qt::DecorationRole:
+            return index.column() == 0 ? QApplication::style()->standardIcon(QStyle::SP_DirIcon) : QVariant();
+        case Qt::ForegroundRole:
+            return QColor(0, 100, 200);
+        case Qt::ToolTipRole:
+            return QString::fromUtf8(node.prefix.chopped(1));
+        default:
+            return QVariant();
+        }
+    }
+
+    qint32 sortedIndex = parentNode.files.at(index.row() - parentNode.dirs.size());
+    FileState state = m_records.at(m_sorted.at(sortedIndex)).state;
+    switch (role) {
+    case Qt::DisplayRole:
+        return index.column() == 0 ? QString::fromUtf8(nameOf(sortedIndex, parentNode)) : stateName(state);
+    case Qt::DecorationRole:
+        return index.column() == 0 ? QApplication::style()->standardIcon(QStyle::SP_FileIcon) : QVariant();
+    case Qt::ForegroundRole:
+        switch (state) {
+        case FileState::Added:
+        case FileState::Untracked: return QColor(0, 150, 0);
+        case FileState::Deleted: return QColor(200, 0, 0);
+        case FileState::Unmerged: return QColor(200, 100, 0);
+        default: return QVariant();
+        }
+    case Qt::ToolTipRole:
+        return QString::fromUtf8(pathOf(sortedIndex));
+    default:
+        return QVariant();
+    }
+}
+
+QVariant StatusTreeModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    return section == 0 ? QString("Fichier") : QString("Etat");
+}
+
+QString StatusTreeModel::stateName(FileState state) {
+    switch (state) {
+    case FileState::Added: return "Ajoute";
+    case FileState::Modified: return "Modifie";
+    case FileState::Deleted: return "Supprime";
+    case FileState::Renamed: return "Renomme";
+    case FileState::Copied: return "Copie";
+    case FileState::TypeChanged: return "Type modifie";
+    case FileState::Unmerged: return "En conflit";
+    case FileState::Untracked: return "Nouveau (non indexe)";
+    }
+    return QString();
+}
@@ -0,0 +1,81 @@
+﻿#include "include/tracer.h"
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QThread>
+
+std::atomic<bool> Tracer::s_enabled{false};
+
+Tracer& Tracer::instance() {
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::~Tracer() {
+    stop();
+}
+
+bool Tracer::start(const QString& filePath) {
+    QMutexLocker locker(&m_mutex);
+
+    if (m_file.isOpen()) {
+        return true;
+    }
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    m_file.write("[\n");
+    m_firstEvent = true;
+    m_clock.start();
+    s_enabled.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void Tracer::stop() {
+    QMutexLocker locker(&m_mutex);
+
+    s_enabled.store(false, std::memory_order_relaxed);
+    if (m_file.isOpen()) {
+        m_file.write("\n]\n");
+        m_file.close();
+    }
+}
+
+void Tracer::addCompleteEvent(const char* name, const char* category, qint64 startUs,
+                              qint64 durationUs, const QJsonObject& args) {
+    QJsonObject event;
+    event.insert("name", QString::fromUtf8(name));
+    event.insert("cat", QString::fromUtf8(category));
+    event.insert("ph", "X");
+    event.insert("ts", startUs);
+    event.insert("dur", durationUs);
+    event.insert("pid", QCoreApplication::applicationPid());
+    event.insert("tid", static_cast<qint64>(reinterpret_cast<quintptr>(QThread::currentThreadId())));
+    if (!args.isEmpty()) {
+        event.insert("args", args);
+    }
+
+    QByteArray line = QJsonDocument(event).toJson(QJsonDocument::Compact);
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    if (!m_firstEvent) {
+        m_file.write(",\n");
+    }
+    m_firstEvent = false;
+    m_file.write(line);
+    // Trace exploitable meme si l'application se termine brutalement
+    m_file.flush();
+}
+
+QString Tracer::redactCredentials(const QString& text) {
+    static const QRegularExpression userInfo("://[^/@\\s]+@");
+    QString redacted = text;
+    return redacted.replace(userInfo, "://***@");
+}
@@ -0,0 +1,511 @@
+﻿#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QRandomGenerator>
+#include <QDirIterator>
+#include "include/gitmanager.h"
+#include "localgitserver.h"
+
+/**
+ * @class GitManagerBenchmark
+ * @brief Benchmarks a lancer a la demande (ctest -C Benchmark -L benchmark)
+ *
+ * Les arborescences synthetiques sont generees une fois dans initTestCase:
+ * beaucoup de petits fichiers, quelques gros fichiers et une arborescence profonde.
+ */
+class GitManagerBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void benchmarkCopyDirectoryRecursively_data();
+    void benchmarkCopyDirectoryRecursively();
+    void benchmarkCopyProjectRecursively_data();
+    void benchmarkCopyProjectRecursively();
+    void benchmarkCopyAndStage_data();
+    void benchmarkCopyAndStage();
+    void benchmarkAddFiles();
+    void benchmarkAddAllFiles_data();
+    void benchmarkAddAllFiles();
+    void benchmarkLargeRepoStatus_data();
+    void benchmarkLargeRepoStatus();
+    void benchmarkCommit_data();
+    void benchmarkCommit();
+    void benchmarkBackendOperation_data();
+    void benchmarkBackendOperation();
+    void benchmarkDetectErrorType_data();
+    void benchmarkDetectErrorType();
+    void benchmarkGetGitErrorMessage_data();
+    void benchmarkGetGitErrorMessage();
+
+    void benchmarkPushProfile_data();
+    void benchmarkPushProfile();
+
+private:
+    bool runGit(const QString& workingDir, const QStringList& arguments);
+    void writeFile(const QString& path, const QByteArray& content);
+    void addFixtureRows();
+    void addErrorOutputRows();
+    QString prepareRepository(const QString& fixture);
+
+    QTemporaryDir m_workDir;
+    QString m_fixturesDir;
+    QString m_sourceRepo;
+    QString m_servedDir;
+    QScopedPointer<LocalGitServer> m_server;
+};
+
+bool GitManagerBenchmark::runGit(const QString& workingDir, const QStringList& arguments)
+{
+    QProcess process;
+    process.setWorkingDirectory(workingDir);
+    process.start("git", arguments);
+    if (!process.waitForFinished(600000)) {
+        process.kill();
+        return false;
+    }
+    if (process.exitCode() != 0) {
+        qWarning() << "git" << arguments << process.readAllStandardError();
+        return false;
+    }
+    return true;
+}
+
+void GitManagerBenchmark::writeFile(const QString& path, const QByteArray& content)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(content), content.size());
+}
+
+void GitManagerBenchmark::addFixtureRows()
+{
+    QTest::addColumn<QString>("fixture");
+    QTest::newRow("petits_fichiers") << "petits_fichiers";
+    QTest::newRow("gros_fichiers") << "gros_fichiers";
+    QTest::newRow("arborescence_profonde") << "arborescence_profonde";
+}
+
+void GitManagerBenchmark::addErrorOutputRows()
+{
+    QTest::addColumn<QString>("output");
+    QTest::newRow("authentification")
+        << "remote: Invalid username or password.\n"
+           "fatal: Authentication failed for 'https://github.com/user/repo.git/'";
+    QTest::newRow("reseau")
+        << "fatal: unable to access 'https://github.com/user/repo.git/': "
+           "Could not resolve host: github.com";
+    QTest::newRow("depot_introuvable")
+        << "remote: Repository not found.\n"
+           "fatal: repository 'https://github.com/user/repo.git/' not found";
+    QTest::newRow("rien_a_commiter")
+        << "On branch main\nnothing to commit, working tree clean";
+    QTest::newRow("inconnue")
+        << QString("error: failed to push some refs to 'origin'\n").repeated(50);
+}
+
+QString GitManagerBenchmark::prepareRepository(const QString& fixture)
+{
+    // Depot neuf contenant une copie de l'arborescence synthetique
+    QString repo = m_workDir.filePath("repos/" + fixture);
+    QDir(repo).removeRecursively();
+    QDir().mkpath(repo);
+    if (!runGit(repo, QStringList() << "init" << "-q")) {
+        return QString();
+    }
+
+    GitManager manager;
+    if (!manager.copyProjectRecursively(repo, QStringList() << QDir(m_fixturesDir).filePath(fixture))) {
+        return QString();
+    }
+    return repo;
+}
+
+void GitManagerBenchmark::initTestCase()
+{
+    QVERIFY(m_workDir.isValid());
+
+    // Identite neutre pour les commits des benchmarks
+    qputenv("GIT_AUTHOR_NAME", "bench");
+    qputenv("GIT_AUTHOR_EMAIL", "bench@localhost");
+    qputenv("GIT_COMMITTER_NAME", "bench");
+    qputenv("GIT_COMMITTER_EMAIL", "bench@localhost");
+
+    QRandomGenerator generator(42);
+    m_fixturesDir = m_workDir.filePath("fixtures");
+
+    // Beaucoup de petits fichiers
+    QDir tiny(QDir(m_fixturesDir).filePath("petits_fichiers"));
+    for (int i = 0; i < 5000; ++i) {
+        writeFile(tiny.filePath(QString("d%1/f%2.txt").arg(i % 50).arg(i)),
+                  QByteArray::number(generator.generate64()).repeated(4));
+    }
+
+    // Quelques gros fichiers incompressibles
+    QDir huge(QDir(m_fixturesDir).filePath("gros_fichiers"));
+    for (int i = 0; i < 3; ++i) {
+        QByteArray blob(32 * 1024 * 1024, Qt::Uninitialized);
+        generator.fillRange(reinterpret_cast<quint32*>(blob.data()), blob.size() / 4);
+        writeFile(huge.filePath(QString("blob_%1.bin").arg(i)), blob);
+    }
+
+    // Arborescence profonde
+    QString deepPath = QDir(m_fixturesDir).filePath("arborescence_profonde");
+    for (int depth = 0; depth < 64; ++depth) {
+        deepPath = QDir(deepPath).filePath(QString("niveau_%1").arg(depth));
+        for (int i = 0; i < 8; ++i) {
+            writeFile(QDir(deepPath).filePath(QString("f%1.txt").arg(i)),
+                      QString("%1/%2\n").arg(depth).arg(i).toUtf8());
+        }
+    }
+
+    // Depot source du benchmark de profils de transport
+    m_sourceRepo = m_workDir.filePath("source");
+    QVERIFY(QDir().mkpath(m_sourceRepo));
+    QVERIFY(runGit(m_sourceRepo, QStringList() << "init" << "-q" << "-b" << "main"));
+
+    // Quelques gros fichiers deja compresses (donnees aleatoires)...
+    for (int i = 0; i < 16; ++i) {
+        QByteArray blob(2 * 1024 * 1024, Qt::Uninitialized);
+        generator.fillRange(reinterpret_cast<quint32*>(blob.data()), blob.size() / 4);
+        writeFile(QDir(m_sourceRepo).filePath(QString("assets/blob_%1.bin").arg(i)), blob);
+    }
+
+    // ... et beaucoup de petits fichiers texte
+    for (int i = 0; i < 2000; ++i) {
+        writeFile(QDir(m_sourceRepo).filePath(QString("docs/%1/page_%2.txt").arg(i % 20).arg(i)),
+                  QString("Page %1\n").arg(i).repeated(20).toUtf8());
+    }
+
+    QVERIFY(runGit(m_sourceRepo, QStringList() << "add" << "-A"));
+    QVERIFY(runGit(m_sourceRepo, QStringList() << "commit" << "-q" << "-m" << "fixture"));
+
+    // Distant smart HTTP local: http.version et http.postBuffer s'appliquent
+    // comme face a GitHub, sans proxy ni invite d'identifiants
+    qputenv("GIT_TERMINAL_PROMPT", "0");
+    qputenv("no_proxy", "127.0.0.1,localhost");
+    qputenv("NO_PROXY", "127.0.0.1,localhost");
+    m_servedDir = m_workDir.filePath("served");
+    QVERIFY(QDir().mkpath(m_servedDir));
+    m_server.reset(new LocalGitServer(m_servedDir));
+    QVERIFY(m_server->start());
+}
+
+void GitManagerBenchmark::cleanupTestCase()
+{
+    if (m_server) {
+        m_server->stop();
+    }
+}
+
+void GitManagerBenchmark::benchmarkCopyDirectoryRecursively_data()
+{
+    addFixtureRows();
+}
+
+void GitManagerBenchmark::benchmarkCopyDirectoryRecursively()
+{
+    QFETCH(QString, fixture);
+
+    GitManager manager;
+    QString source = QDir(m_fixturesDir).filePath(fixture);
+    QString dest = m_workDir.filePath("copy_dir/" + fixture);
+
+    QBENCHMARK {
+        CompactPathList copiedFiles(m_workDir.path());
+        QVERIFY(manager.copyDirectoryRecursively(source, dest, copiedFiles) > 0);
+    }
+}
+
+void GitManagerBenchmark::benchmarkCopyProjectRecursively_data()
+{
+    addFixtureRows();
+}
+
+void GitManagerBenchmark::benchmarkCopyProjectRecursively()
+{
+    QFETCH(QString, fixture);
+
+    GitManager manager;
+    QString dest = m_workDir.filePath("copy_project");
+    QDir().mkpath(dest);
+
+    QBENCHMARK {
+        QVERIFY(manager.copyProjectRecursively(dest, QStringList() << QDir(m_fixturesDir).filePath(fixture)));
+    }
+}
+
+void GitManagerBenchmark::benchmarkCopyAndStage_data()
+{
+    QTest::addColumn<QString>("fixture");
+    QTest::addColumn<bool>("pipelined");
+
+    for (const char* fixture : { "petits_fichiers", "gros_fichiers", "arborescence_profonde" }) {
+        QTest::newRow(qPrintable(QString("%1/sequentiel").arg(fixture))) << QString(fixture) << false;
+        QTest::newRow(qPrintable(QString("%1/pipeline").arg(fixture))) << QString(fixture) << true;
+    }
+}
+
+void GitManagerBenchmark::benchmarkCopyAndStage()
+{
+    QFETCH(QString, fixture);
+    QFETCH(bool, pipelined);
+
+    // Copie puis git add -A, avec ou sans indexation au fil de la copie:
+    // le mode pipeline doit tendre vers max(copie, hachage)
+    GitManager manager;
+    manager.setPipelinedStaging(pipelined);
+    QString repo = m_workDir.filePath("copy_stage");
+
+    QBENCHMARK {
+        QDir(repo).removeRecursively();
+        QDir().mkpath(repo);
+        QVERIFY(runGit(repo, QStringList() << "init" << "-q"));
+        QVERIFY(manager.copyProjectRecursively(repo, QStringList() << QDir(m_fixturesDir).filePath(fixture)));
+        QVERIFY(manager.addAllFiles(repo));
+    }
+}
+
+void GitManagerBenchmark::benchmarkAddFiles()
+{
+    QString repo = prepareRepository("petits_fichiers");
+    QVERIFY(!repo.isEmpty());
+
+    // addFiles lance un processus par fichier: echantillon de 200 fichiers
+    QStringList files;
+    QDirIterator it(QDir(repo).filePath("petits_fichiers"), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext() && files.size() < 200) {
+        files << it.next();
+    }
+
+    GitManager manager;
+    QBENCHMARK {
+        QVERIFY(manager.addFiles(repo, files));
+    }
+}
+
+void GitManagerBenchmark::benchmarkAddAllFiles_data()
+{
+    addFixtureRows();
+}
+
+void GitManagerBenchmark::benchmarkAddAllFiles()
+{
+    QFETCH(QString, fixture);
+
+    QString repo = prepareRepository(fixture);
+    QVERIFY(!repo.isEmpty());
+
+    GitManager manager;
+    QString index = QDir(repo).filePath(".git/index");
+
+    QBENCHMARK {
+        // Index vide a chaque iteration: tous les fichiers sont re-hashes
+        QFile::remove(index);
+        QVERIFY(manager.addAllFiles(repo));
+    }
+}
+
+void GitManagerBenchmark::benchmarkLargeRepoStatus_data()
+{
+    QTest::addColumn<bool>("largeRepoMode");
+    QTest::newRow("index_standard") << false;
+    QTest::newRow("mode_grand_depot") << true;
+}
+
+void GitManagerBenchmark::benchmarkLargeRepoStatus()
+{
+    QFETCH(bool, largeRepoMode);
+
+    QString repo = prepareRepository("petits_fichiers");
+    QVERIFY(!repo.isEmpty());
+
+    // Seuil au plus bas: le premier ajout active le mode grand depot
+    GitManager manager;
+    manager.setLargeRepoThreshold(largeRepoMode ? 1 : 0);
+    QVERIFY(manager.addAllFiles(repo));
+    QVERIFY(runGit(repo, QStringList() << "status" << "--porcelain=v2")); // Remplit le cache des non suivis
+
+    QBENCHMARK {
+        QVERIFY(runGit(repo, QStringList() << "status" << "--porcelain=v2" << "-z"));
+    }
+}
+
+void GitManagerBenchmark::benchmarkCommit_data()
+{
+    addFixtureRows();
+}
+
+void GitManagerBenchmark::benchmarkCommit()
+{
+    QFETCH(QString, fixture);
+
+    QString repo = prepareRepository(fixture);
+    QVERIFY(!repo.isEmpty());
+
+    GitManager manager;
+    QVERIFY(manager.addAllFiles(repo));
+
+    QBENCHMARK_ONCE {
+        QVERIFY(manager.commit(repo, "Benchmark " + fixture));
+    }
+}
+
+void GitManagerBenchmark::benchmarkBackendOperation_data()
+{
+    QTest::addColumn<int>("backend");
+    QTest::addColumn<QString>("operation");
+
+    // Operations courtes: le cout fixe (processus, decouverte, index) domine
+    const QStringList operations = { "status", "ajout", "ajout_commit", "update_ref", "remote" };
+    for (GitBackend::Kind kind : GitManager::availableBackends()) {
+        for (const QString& operation : operations) {
+            QTest::newRow(qPrintable(GitBackend::kindName(kind) + "/" + operation))
+                << static_cast<int>(kind) << operation;
+        }
+    }
+}
+
+void GitManagerBenchmark::benchmarkBackendOperation()
+{
+    QFETCH(int, backend);
+    QFETCH(QString, operation);
+
+    QString repo = m_workDir.filePath("backend");
+    QDir(repo).removeRecursively();
+    QVERIFY(QDir().mkpath(repo));
+    QVERIFY(runGit(repo, QStringList() << "init" << "-q"));
+    QVERIFY(runGit(repo, QStringList() << "config" << "user.name" << "bench"));
+    QVERIFY(runGit(repo, QStringList() << "config" << "user.email" << "bench@localhost"));
+    QVERIFY(runGit(repo, QStringList() << "remote" << "add" << "origin" << "https://example.invalid/a.git"));
+    for (int i = 0; i < 200; ++i) {
+        writeFile(QDir(repo).filePath(QString("d%1/f%2.txt").arg(i % 10).arg(i)), QByteArray::number(i));
+    }
+    QVERIFY(runGit(repo, QStringList() << "add" << "-A"));
+    QVERIFY(runGit(repo, QStringList() << "commit" << "-q" << "-m" << "base"));
+
+    GitManager manager;
+    QVERIFY(manager.setBackend(static_cast<GitBackend::Kind>(backend)));
+    GitBackend* engine = manager.backendFor(repo);
+    QCOMPARE(static_cast<int>(engine->kind()), backend);
+
+    const QString changed = QDir(repo).filePath("d0/f0.txt");
+    QVector<GitStatusEntry> entries;
+    int iteration = 0;
+
+    QBENCHMARK {
+        ++iteration;
+        if (operation == "status") {
+            QVERIFY(engine->status(repo, entries));
+        } else if (operation == "ajout") {
+            writeFile(changed, QByteArray::number(iteration));
+            QVERIFY(engine->addAll(repo));
+        } else if (operation == "ajout_commit") {
+            writeFile(changed, QByteArray::number(iteration));
+            QVERIFY(engine->addAll(repo));
+            QVERIFY(engine->commit(repo, "iteration"));
+        } else if (operation == "update_ref") {
+            QVERIFY(engine->updateRef(repo, "refs/heads/bench", "HEAD"));
+        } else {
+            QVERIFY(engine->setRemoteUrl(repo, "origin", QString("https://example.invalid/%1.git").arg(iteration % 2),
+                                         false));
+        }
+    }
+}
+
+void GitManagerBenchmark::benchmarkDetectErrorType_data()
+{
+    addErrorOutputRows();
+}
+
+void GitManagerBenchmark::benchmarkDetectErrorType()
+{
+    QFETCH(QString, output);
+
+    GitManager manager;
+    GitError result = GitError::None;
+
+    QBENCHMARK {
+        result = manager.detectErrorType(output);
+    }
+    QVERIFY(result != GitError::None);
+}
+
+void GitManagerBenchmark::benchmarkGetGitErrorMessage_data()
+{
+    addErrorOutputRows();
+}
+
+void GitManagerBenchmark::benchmarkGetGitErrorMessage()
+{
+    QFETCH(QString, output);
+
+    GitManager manager;
+    QString message;
+
+    QBENCHMARK {
+        message = manager.getGitErrorMessage(output);
+    }
+    QVERIFY(!message.isEmpty());
+}
+
+void GitManagerBenchmark::benchmarkPushProfile_data()
+{
+    QTest::addColumn<int>("profile");
+    QTest::addColumn<int>("bandwidth");
+
+    const QList<TransportProfile> profiles = {
+        TransportProfile::Default,
+        TransportProfile::LanBulk,
+        TransportProfile::WanLowBandwidth,
+        TransportProfile::ManySmallFiles
+    };
+    // Sans limite, puis reponses du serveur bridees a 256 Kio/s avec 50 ms
+    // de latence par requete (liaison lente)
+    for (TransportProfile profile : profiles) {
+        const QString name = GitManager::transportProfileName(profile);
+        QTest::newRow(qPrintable(name)) << static_cast<int>(profile) << 0;
+        QTest::newRow(qPrintable(name + ", bride")) << static_cast<int>(profile) << 256 * 1024;
+    }
+}
+
+void GitManagerBenchmark::benchmarkPushProfile()
+{
+    QFETCH(int, profile);
+    QFETCH(int, bandwidth);
+
+    // Un depot nu neuf par ligne: chaque push transfere tout l'historique
+    const QString name = QString("remote_%1_%2.git").arg(profile).arg(bandwidth);
+    const QString remote = QDir(m_servedDir).filePath(name);
+    QDir(remote).removeRecursively();
+    QVERIFY(runGit(m_workDir.path(), QStringList() << "init" << "-q" << "--bare" << remote));
+    QVERIFY(runGit(remote, QStringList() << "config" << "http.receivepack" << "true"));
+
+    QList<LocalGitServer::Fault> faults;
+    if (bandwidth > 0) {
+        LocalGitServer::Fault slowLink;
+        slowLink.target = "git";
+        slowLink.latencyMs = 50;
+        slowLink.bandwidthBytesPerSec = bandwidth;
+        faults.append(slowLink);
+    }
+    m_server->setFaults(faults);
+    auto clearFaults = qScopeGuard([this]() { m_server->clearFaults(); });
+
+    // Chemin reel de publication: sondes locales, profil de transport et nouvelles tentatives
+    GitManager manager;
+    manager.setConnectivityEndpoints(QStringList() << m_server->baseUrl() + "/probe",
+                                     m_server->baseUrl() + "/api");
+    manager.setTransportProfile(static_cast<TransportProfile>(profile));
+    QVERIFY2(manager.setRemoteUrl(m_sourceRepo, m_server->gitUrl(name)), qPrintable(manager.lastError()));
+
+    QBENCHMARK_ONCE {
+        QVERIFY2(manager.push(m_sourceRepo, "main", QString(), QString()), qPrintable(manager.lastError()));
+    }
+}
+
+QTEST_MAIN(GitManagerBenchmark)
+#include "bench_gitmanager.moc"
@@ -0,0 +1,282 @@
+﻿#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "include/gitmanager.h"
+#include "localgitserver.h"
+
+/**
+ * @class GitManagerIntegrationTest
+ * @brief Pipeline complet init -> remote -> add -> commit -> push -> pull sans reseau
+ *
+ * Les depots distants sont des depots nus locaux, servis en file:// et en smart
+ * HTTP par LocalGitServer, qui repond aussi aux sondes de connectivite.
+ *
+ * Les scenarios de pannes (tests/fault_scenarios/*.json) sont rejoues pour
+ * chaque politique de nouvelle tentative; le temps jusqu'au succes et le
+ * nombre de tentatives sont rapportes.
+ */
+class GitManagerIntegrationTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testPipeline_data();
+    void testPipeline();
+
+    void testFaultScenario_data();
+    void testFaultScenario();
+
+private:
+    bool runGit(const QString& workingDir, const QStringList& arguments);
+    void writeFile(const QString& path, const QByteArray& content);
+    QString createBareRemote(const QString& path);
+
+    QTemporaryDir m_workDir;
+    QScopedPointer<LocalGitServer> m_server;
+};
+
+bool GitManagerIntegrationTest::runGit(const QString& workingDir, const QStringList& arguments)
+{
+    QProcess process;
+    process.setWorkingDirectory(workingDir);
+    process.start("git", arguments);
+    if (!process.waitForFinished(60000)) {
+        process.kill();
+        return false;
+    }
+    if (process.exitCode() != 0) {
+        qWarning() << "git" << arguments << process.readAllStandardError();
+        return false;
+    }
+    return true;
+}
+
+void GitManagerIntegrationTest::writeFile(const QString& path, const QByteArray& content)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(content), content.size());
+}
+
+QString GitManagerIntegrationTest::createBareRemote(const QString& path)
+{
+    if (!runGit(m_workDir.path(), QStringList() << "init" << "-q" << "--bare" << path)) {
+        return QString();
+    }
+    // Autorise le push anonyme via git http-backend
+    if (!runGit(path, QStringList() << "config" << "http.receivepack" << "true")) {
+        return QString();
+    }
+    return path;
+}
+
+void GitManagerIntegrationTest::initTestCase()
+{
+    QVERIFY(m_workDir.isValid());
+
+    // Environnement hermetique: aucune configuration utilisateur ni systeme,
+    // aucun proxy, aucune invite d'identifiants
+    QString home = m_workDir.filePath("home");
+    QVERIFY(QDir().mkpath(home));
+    qputenv("HOME", home.toUtf8());
+    qputenv("GIT_CONFIG_NOSYSTEM", "1");
+    qputenv("GIT_TERMINAL_PROMPT", "0");
+    qputenv("no_proxy", "127.0.0.1,localhost");
+    qputenv("NO_PROXY", "127.0.0.1,localhost");
+    qputenv("GIT_AUTHOR_NAME", "integration");
+    qputenv("GIT_AUTHOR_EMAIL", "integration@localhost");
+    qputenv("GIT_COMMITTER_NAME", "integration");
+    qputenv("GIT_COMMITTER_EMAIL", "integration@localhost");
+    qputenv("GIT_CONFIG_COUNT", "1");
+    qputenv("GIT_CONFIG_KEY_0", "init.defaultBranch");
+    qputenv("GIT_CONFIG_VALUE_0", "main");
+
+    QString served = m_workDir.filePath("served");
+    QVERIFY(QDir().mkpath(served));
+    QVERIFY(!createBareRemote(QDir(served).filePath("http-remote.git")).isEmpty());
+    QVERIFY(!createBareRemote(m_workDir.filePath("file-remote.git")).isEmpty());
+
+    m_server.reset(new LocalGitServer(served));
+    QVERIFY(m_server->start());
+}
+
+void GitManagerIntegrationTest::cleanupTestCase()
+{
+    if (m_server) {
+        m_server->stop();
+    }
+}
+
+void GitManagerIntegrationTest::testPipeline_data()
+{
+    QTest::addColumn<QString>("remoteKind");
+
+    QTest::newRow("file") << "file";
+    QTest::newRow("smart-http") << "http";
+}
+
+void GitManagerIntegrationTest::testPipeline()
+{
+    QFETCH(QString, remoteKind);
+
+    QString remoteUrl = (remoteKind == "file")
+        ? QUrl::fromLocalFile(m_workDir.filePath("file-remote.git")).toString()
+        : m_server->gitUrl("http-remote.git");
+
+    GitManager manager;
+    manager.setConnectivityEndpoints(QStringList() << m_server->baseUrl() + "/probe",
+                                     m_server->baseUrl() + "/api");
+
+    QString repo = m_workDir.filePath("work-" + remoteKind);
+    QString source = m_workDir.filePath("source-" + remoteKind);
+    for (int i = 0; i < 50; ++i) {
+        writeFile(QDir(source).filePath(QString("dossier_%1/fichier_%2.txt").arg(i % 5).arg(i)),
+                  QString("Contenu %1\n").arg(i).toUtf8());
+    }
+
+    QList<QPair<QString, qint64>> timings;
+    QElapsedTimer timer;
+    auto step = [&timings, &timer](const QString& name) {
+        timings.append({ name, timer.restart() });
+    };
+    timer.start();
+
+    QVERIFY2(manager.initRepository(repo), qPrintable(manager.lastError()));
+    step("init");
+    QVERIFY2(manager.setRemoteUrl(repo, remoteUrl), qPrintable(manager.lastError()));
+    step("remote");
+    QVERIFY2(manager.copyProjectRecursively(repo, QStringList() << source), qPrintable(manager.lastError()));
+    QVERIFY2(manager.addAllFiles(repo), qPrintable(manager.lastError()));
+    step("add");
+    QVERIFY2(manager.commit(repo, "Premier commit"), qPrintable(manager.lastError()));
+    step("commit");
+    QVERIFY2(manager.push(repo, "main", QString(), QString()), qPrintable(manager.lastError()));
+    step("push");
+
+    // Deja a jour: la reference en cache suffit, sans sonde ni git push
+    int probesBefore = m_server->probeRequests();
+    qint64 spawnsBefore = manager.metrics().processSpawns();
+    QVERIFY2(manager.push(repo, "main", QString(), QString()), qPrintable(manager.lastError()));
+    QCOMPARE(m_server->probeRequests(), probesBefore);
+    QVERIFY(manager.metrics().processSpawns() - spawnsBefore <= 2);
+    step("push-noop");
+
+    // Un second poste pousse un commit que le premier doit recuperer
+    QString other = m_workDir.filePath("other-" + remoteKind);
+    QVERIFY(runGit(m_workDir.path(), QStringList() << "clone" << "-q" << remoteUrl << other));
+    writeFile(QDir(other).filePath("distant.txt"), "Modification distante\n");
+    QVERIFY(runGit(other, QStringList() << "add" << "distant.txt"));
+    QVERIFY(runGit(other, QStringList() << "commit" << "-q" << "-m" << "Commit distant"));
+    QVERIFY(runGit(other, QStringList() << "push" << "-q" << "origin" << "main"));
+    timer.restart();
+
+    QVERIFY2(manager.pull(repo, "main", QString(), QString()), qPrintable(manager.lastError()));
+    step("pull");
+    QVERIFY(QFile::exists(QDir(repo).filePath("distant.txt")));
+    QVERIFY2(manager.checkRemoteStatus(repo, "main"), qPrintable(manager.lastError()));
+    step("status");
+
+    QVERIFY(m_server->probeRequests() > 0);
+    if (remoteKind == "http") {
+        QVERIFY(m_server->gitRequests() > 0);
+    }
+
+    for (const auto& timing : timings) {
+        qInfo().noquote() << QString("%1 %2: %3 ms").arg(remoteKind, -5).arg(timing.first, -7).arg(timing.second);
+    }
+}
+
+void GitManagerIntegrationTest::testFaultScenario_data()
+{
+    QTest::addColumn<QString>("scenarioFile");
+    QTest::addColumn<int>("initialDelayMs");
+    QTest::addColumn<double>("multiplier");
+    QTest::addColumn<int>("maxDelayMs");
+
+    struct Policy {
+        const char* name;
+        int initialDelayMs;
+        double multiplier;
+        int maxDelayMs;
+    };
+    const Policy policies[] = {
+        { "immediate", 0, 1.0, 0 },
+        { "constante", 250, 1.0, 250 },
+        { "exponentielle", 100, 2.0, 1000 }
+    };
+
+    QDir scenarios(FAULT_SCENARIOS_DIR);
+    const QStringList files = scenarios.entryList(QStringList() << "*.json", QDir::Files, QDir::Name);
+    for (const QString& file : files) {
+        for (const Policy& policy : policies) {
+            QTest::newRow(qPrintable(QFileInfo(file).baseName() + "/" + policy.name))
+                << scenarios.filePath(file) << policy.initialDelayMs
+                << policy.multiplier << policy.maxDelayMs;
+        }
+    }
+}
+
+void GitManagerIntegrationTest::testFaultScenario()
+{
+    QFETCH(QString, scenarioFile);
+    QFETCH(int, initialDelayMs);
+    QFETCH(double, multiplier);
+    QFETCH(int, maxDelayMs);
+
+    QFile file(scenarioFile);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonObject scenario = QJsonDocument::fromJson(file.readAll()).object();
+    QJsonObject expect = scenario.value("expect").toObject();
+
+    // Depot distant et depot local neufs pour chaque ligne
+    static int counter = 0;
+    QString name = QString("fault-%1").arg(++counter);
+    QString served = m_workDir.filePath("served");
+    QVERIFY(!createBareRemote(QDir(served).filePath(name + ".git")).isEmpty());
+
+    QString repo = m_workDir.filePath(name);
+    QVERIFY(runGit(m_workDir.path(), QStringList() << "init" << "-q" << repo));
+    writeFile(QDir(repo).filePath("README.md"), "Scenario de panne\n");
+    QVERIFY(runGit(repo, QStringList() << "add" << "-A"));
+    QVERIFY(runGit(repo, QStringList() << "commit" << "-q" << "-m" << "Commit initial"));
+    QVERIFY(runGit(repo, QStringList() << "remote" << "add" << "origin" << m_server->gitUrl(name + ".git")));
+
+    GitManager manager;
+    manager.setConnectivityEndpoints(QStringList() << m_server->baseUrl() + "/probe",
+                                     m_server->baseUrl() + "/api");
+    RetryPolicy policy;
+    policy.initialDelayMs = initialDelayMs;
+    policy.multiplier = multiplier;
+    policy.maxDelayMs = maxDelayMs;
+    manager.setRetryPolicy(policy);
+
+    m_server->setFaults(LocalGitServer::faultsFromJson(scenario.value("faults").toArray()));
+    QElapsedTimer timer;
+    timer.start();
+    bool success = manager.push(repo, "main", QString(), QString(), 4);
+    qint64 elapsed = timer.elapsed();
+    m_server->clearFaults();
+
+    qint64 retries = manager.metrics().totalRetries();
+    qInfo().noquote() << QString("%1: %2 en %3 ms, %4 nouvelle(s) tentative(s)")
+        .arg(QTest::currentDataTag(), success ? "succes" : "echec").arg(elapsed).arg(retries);
+
+    QCOMPARE(success, expect.value("success").toBool());
+    if (expect.contains("error")) {
+        QCOMPARE(GitMetrics::errorName(manager.lastErrorCode()), expect.value("error").toString());
+    }
+    if (expect.contains("minRetries")) {
+        QVERIFY(retries >= expect.value("minRetries").toInt());
+    }
+    if (expect.contains("maxRetries")) {
+        QVERIFY(retries <= expect.value("maxRetries").toInt());
+    }
+}
+
+QTEST_MAIN(GitManagerIntegrationTest)
+#include "integration_gitmanager.moc"
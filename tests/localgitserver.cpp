@@ -0,0 +1,384 @@
+﻿#include "localgitserver.h"
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QHostAddress>
+#include <QJsonObject>
+#include <QTimer>
+#if defined(Q_OS_WIN)
+#include <winsock2.h>
+using NativeSocket = SOCKET;
+#else
+#include <sys/socket.h>
+using NativeSocket = int;
+#endif
+
+LocalGitServer::LocalGitServer(const QString& projectRoot)
+    : m_projectRoot(projectRoot)
+    , m_port(0)
+    , m_probeRequests(0)
+    , m_gitRequests(0) {
+}
+
+LocalGitServer::~LocalGitServer() {
+    stop();
+}
+
+bool LocalGitServer::start() {
+    moveToThread(&m_thread);
+    m_thread.start();
+
+    bool listening = false;
+    QMetaObject::invokeMethod(this, [this, &listening]() {
+        listening = listen(QHostAddress::LocalHost, 0);
+        m_port = serverPort();
+    }, Qt::BlockingQueuedConnection);
+    return listening;
+}
+
+void LocalGitServer::stop() {
+    if (!m_thread.isRunning()) {
+        return;
+    }
+
+    QMetaObject::invokeMethod(this, [this]() {
+        close();
+        for (auto it = m_buffers.keyBegin(); it != m_buffers.keyEnd(); ++it) {
+            (*it)->abort();
+            (*it)->deleteLater();
+        }
+        m_buffers.clear();
+    }, Qt::BlockingQueuedConnection);
+
+    m_thread.quit();
+    m_thread.wait();
+}
+
+QString LocalGitServer::baseUrl() const {
+    return QString("http://127.0.0.1:%1").arg(m_port);
+}
+
+QString LocalGitServer::gitUrl(const QString& repositoryName) const {
+    return baseUrl() + "/git/" + repositoryName;
+}
+
+void LocalGitServer::incomingConnection(qintptr socketDescriptor) {
+    QTcpSocket* socket = new QTcpSocket(this);
+    if (!socket->setSocketDescriptor(socketDescriptor)) {
+        delete socket;
+        return;
+    }
+
+    m_buffers.insert(socket, QByteArray());
+    connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+    connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+        m_buffers.remove(socket);
+        socket->deleteLater();
+    });
+}
+
+void LocalGitServer::onReadyRead(QTcpSocket* socket) {
+    if (!m_buffers.contains(socket)) {
+        return;
+    }
+
+    QByteArray& buffer = m_buffers[socket];
+    buffer += socket->readAll();
+
+    Request request;
+    if (!parseRequest(buffer, request)) {
+        return; // Requete incomplete: on attend la suite
+    }
+
+    // Une requete par connexion (Connection: close)
+    m_buffers.remove(socket);
+    handleRequest(socket, request);
+}
+
+QList<LocalGitServer::Fault> LocalGitServer::faultsFromJson(const QJsonArray& array) {
+    QList<Fault> faults;
+    for (const QJsonValue& value : array) {
+        QJsonObject object = value.toObject();
+        Fault fault;
+        fault.target = object.value("target").toString("any");
+        fault.skip = object.value("skip").toInt(0);
+        fault.times = object.value("times").toInt(-1);
+        fault.latencyMs = object.value("latencyMs").toInt(0);
+        fault.bandwidthBytesPerSec = object.value("bandwidthBytesPerSec").toInt(0);
+        fault.reset = object.value("reset").toBool(false);
+        fault.rst = object.value("rst").toBool(false);
+        fault.status = object.value("status").toInt(0);
+        faults.append(fault);
+    }
+    return faults;
+}
+
+void LocalGitServer::setFaults(const QList<Fault>& faults) {
+    QMutexLocker locker(&m_faultMutex);
+    m_faults = faults;
+}
+
+LocalGitServer::Fault LocalGitServer::takeFault(const QString& target) {
+    QMutexLocker locker(&m_faultMutex);
+
+    // Premiere panne applicable; chaque requete consomme un "skip" ou un "times"
+    for (Fault& fault : m_faults) {
+        bool matches = fault.target == "any" || fault.target == target ||
+                       (fault.target == "git" && target == "push");
+        if (!matches) {
+            continue;
+        }
+        if (fault.skip > 0) {
+            --fault.skip;
+            continue;
+        }
+        if (fault.times == 0) {
+            continue;
+        }
+        if (fault.times > 0) {
+            --fault.times;
+        }
+        return fault;
+    }
+    return Fault();
+}
+
+void LocalGitServer::handleRequest(QTcpSocket* socket, const Request& request) {
+    bool isGit = request.path.startsWith("/git/");
+    if (isGit) {
+        ++m_gitRequests;
+    } else {
+        ++m_probeRequests;
+    }
+
+    bool isPush = isGit && (request.path.endsWith("/git-receive-pack") ||
+                            request.query.contains("service=git-receive-pack"));
+    Fault fault = takeFault(isPush ? "push" : isGit ? "git" : "probe");
+    if (fault.latencyMs > 0) {
+        QPointer<QTcpSocket> guarded(socket);
+        QTimer::singleShot(fault.latencyMs, this, [this, guarded, request, fault]() {
+            if (guarded) {
+                respond(guarded, request, fault);
+            }
+        });
+        return;
+    }
+
+    respond(socket, request, fault);
+}
+
+void LocalGitServer::resetConnection(QTcpSocket* socket) {
+    // Fermeture avec SO_LINGER nul: le noyau envoie un RST au lieu d'un FIN,
+    // et curl rapporte "Connection reset by peer"
+    struct linger immediate;
+    immediate.l_onoff = 1;
+    immediate.l_linger = 0;
+    setsockopt(static_cast<NativeSocket>(socket->socketDescriptor()), SOL_SOCKET, SO_LINGER,
+               reinterpret_cast<const char*>(&immediate), sizeof(immediate));
+    socket->abort();
+}
+
+void LocalGitServer::respond(QTcpSocket* socket, const Request& request, const Fault& fault) {
+    if (fault.rst) {
+        resetConnection(socket);
+        return;
+    }
+    if (fault.reset) {
+        socket->abort();
+        return;
+    }
+
+    if (fault.status > 0) {
+        sendResponse(socket, QByteArray::number(fault.status) + " Injected Fault",
+                     { { "Content-Type", "text/plain" } }, "Panne injectee",
+                     fault.bandwidthBytesPerSec);
+        return;
+    }
+
+    if (request.path.startsWith("/git/")) {
+        serveGit(socket, request, fault.bandwidthBytesPerSec);
+        return;
+    }
+
+    sendResponse(socket, "200 OK", { { "Content-Type", "text/plain" } },
+                 request.method == "HEAD" ? QByteArray() : QByteArray("OK"),
+                 fault.bandwidthBytesPerSec);
+}
+
+void LocalGitServer::serveGit(QTcpSocket* socket, const Request& request, int bandwidth) {
+    // Interface CGI de git http-backend
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert("GIT_PROJECT_ROOT", m_projectRoot);
+    env.insert("GIT_HTTP_EXPORT_ALL", "1");
+    env.insert("GATEWAY_INTERFACE", "CGI/1.1");
+    env.insert("REQUEST_METHOD", QString::fromLatin1(request.method));
+    env.insert("PATH_INFO", QString::fromUtf8(request.path.mid(4)));
+    env.insert("QUERY_STRING", QString::fromUtf8(request.query));
+    env.insert("REMOTE_ADDR", "127.0.0.1");
+    env.insert("CONTENT_TYPE", QString::fromLatin1(request.headers.value("content-type")));
+    env.insert("CONTENT_LENGTH", QString::number(request.body.size()));
+    if (request.headers.contains("content-encoding")) {
+        env.insert("HTTP_CONTENT_ENCODING", QString::fromLatin1(request.headers.value("content-encoding")));
+    }
+    if (request.headers.contains("git-protocol")) {
+        env.insert("GIT_PROTOCOL", QString::fromLatin1(request.headers.value("git-protocol")));
+    }
+
+    QProcess backend;
+    backend.setProcessEnvironment(env);
+    backend.start("git", QStringList() << "http-backend");
+    if (!backend.waitForStarted(5000)) {
+        sendResponse(socket, "500 Internal Server Error", {}, "git http-backend indisponible");
+        return;
+    }
+
+    backend.write(request.body);
+    backend.closeWriteChannel();
+    backend.waitForFinished(-1);
+    QByteArray output = backend.readAllStandardOutput();
+
+    // En-tetes CGI puis corps
+    int separator = output.indexOf("\r\n\r\n");
+    int separatorLength = 4;
+    if (separator < 0) {
+        separator = output.indexOf("\n\n");
+        separatorLength = 2;
+    }
+    if (separator < 0) {
+        sendResponse(socket, "500 Internal Server Error", {}, backend.readAllStandardError());
+        return;
+    }
+
+    QByteArray status = "200 OK";
+    QList<QPair<QByteArray, QByteArray>> headers;
+    const QList<QByteArray> lines = output.left(separator).split('\n');
+    for (QByteArray line : lines) {
+        line = line.trimmed();
+        int colon = line.indexOf(':');
+        if (colon <= 0) {
+            continue;
+        }
+        QByteArray name = line.left(colon).trimmed();
+        QByteArray value = line.mid(colon + 1).trimmed();
+        if (name.compare("Status", Qt::CaseInsensitive) == 0) {
+            status = value;
+        } else {
+            headers.append({ name, value });
+        }
+    }
+
+    sendResponse(socket, status, headers, output.mid(separator + separatorLength), bandwidth);
+}
+
+void LocalGitServer::sendResponse(QTcpSocket* socket, const QByteArray& status,
+                                  const QList<QPair<QByteArray, QByteArray>>& headers,
+                                  const QByteArray& body, int bandwidth) {
+    QByteArray response = "HTTP/1.1 " + status + "\r\n";
+    for (const auto& header : headers) {
+        response += header.first + ": " + header.second + "\r\n";
+    }
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += body;
+
+    if (bandwidth > 0) {
+        writeThrottled(socket, response, bandwidth);
+        return;
+    }
+
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+void LocalGitServer::writeThrottled(QPointer<QTcpSocket> socket, const QByteArray& data, int bandwidth) {
+    if (!socket) {
+        return;
+    }
+
+    // Un dixieme du debit toutes les 100 ms
+    int chunkSize = qMax(1, bandwidth / 10);
+    socket->write(data.left(chunkSize));
+    if (data.size() <= chunkSize) {
+        socket->disconnectFromHost();
+        return;
+    }
+
+    QByteArray remaining = data.mid(chunkSize);
+    QTimer::singleShot(100, this, [this, socket, remaining, bandwidth]() {
+        writeThrottled(socket, remaining, bandwidth);
+    });
+}
+
+bool LocalGitServer::parseRequest(const QByteArray& buffer, Request& request) {
+    int headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        return false;
+    }
+
+    const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+    const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+    if (requestLine.size() < 2) {
+        return false;
+    }
+
+    request.method = requestLine.at(0);
+    QByteArray target = requestLine.at(1);
+    int question = target.indexOf('?');
+    request.path = question >= 0 ? target.left(question) : target;
+    request.query = question >= 0 ? target.mid(question + 1) : QByteArray();
+
+    for (int i = 1; i < lines.size(); ++i) {
+        int colon = lines.at(i).indexOf(':');
+        if (colon > 0) {
+            request.headers.insert(lines.at(i).left(colon).trimmed().toLower(),
+                                   lines.at(i).mid(colon + 1).trimmed());
+        }
+    }
+
+    QByteArray payload = buffer.mid(headerEnd + 4);
+    if (request.headers.value("transfer-encoding").toLower() == "chunked") {
+        return decodeChunked(payload, request.body);
+    }
+
+    qsizetype length = request.headers.value("content-length", "0").toLongLong();
+    if (payload.size() < length) {
+        return false;
+    }
+    request.body = payload.left(length);
+    return true;
+}
+
+bool LocalGitServer::decodeChunked(const QByteArray& data, QByteArray& decoded) {
+    decoded.clear();
+    qsizetype position = 0;
+
+    while (true) {
+        qsizetype lineEnd = data.indexOf("\r\n", position);
+        if (lineEnd < 0) {
+            return false;
+        }
+
+        QByteArray sizeField = data.mid(position, lineEnd - position);
+        int extension = sizeField.indexOf(';');
+        if (extension >= 0) {
+            sizeField.truncate(extension);
+        }
+
+        bool ok = false;
+        qsizetype size = sizeField.trimmed().toLongLong(&ok, 16);
+        if (!ok) {
+            return false;
+        }
+
+        position = lineEnd + 2;
+        if (size == 0) {
+            // Dernier morceau: attendre la ligne vide finale
+            return data.indexOf("\r\n", position) >= 0;
+        }
+
+        if (data.size() < position + size + 2) {
+            return false;
+        }
+        decoded += data.mid(position, size);
+        position += size + 2;
+    }
+}
@@ -0,0 +1,113 @@
+﻿#ifndef LOCALGITSERVER_H
+#define LOCALGITSERVER_H
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QHash>
+#include <QMap>
+#include <QByteArray>
+#include <QString>
+#include <QList>
+#include <QMutex>
+#include <QPointer>
+#include <QJsonArray>
+#include <atomic>
+
+/**
+ * @class LocalGitServer
+ * @brief Serveur HTTP local pour les tests d'integration hors reseau
+ *
+ * Les requetes sous /git/ sont transmises a `git http-backend` (smart HTTP) avec
+ * pour racine projectRoot; toute autre requete repond 200 et sert de bouchon aux
+ * sondes de connectivite. Le serveur tourne dans son propre thread: les tests
+ * peuvent lancer git de facon bloquante sans interbloquage.
+ *
+ * Des pannes peuvent etre injectees (latence, debit limite, connexion coupee,
+ * statut HTTP d'erreur) pour exercer les chemins de nouvelle tentative.
+ */
+class LocalGitServer : public QTcpServer {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Requete HTTP complete (corps deja decode s'il etait transmis par morceaux)
+     */
+    struct Request {
+        QByteArray method;
+        QByteArray path;
+        QByteArray query;
+        QMap<QByteArray, QByteArray> headers; // Noms en minuscules
+        QByteArray body;
+    };
+
+    /**
+     * @brief Panne appliquee aux requetes d'une cible ("probe", "git", "push" ou "any")
+     *
+     * "push" ne vise que le service git-receive-pack; "git" vise aussi les
+     * lectures (ls-remote, fetch).
+     */
+    struct Fault {
+        QString target = "any";
+        int skip = 0;                 // Requetes servies normalement avant la panne
+        int times = -1;               // Nombre de requetes affectees (-1: toutes)
+        int latencyMs = 0;            // Delai avant la reponse
+        int bandwidthBytesPerSec = 0; // Debit maximal de la reponse (0: illimite)
+        bool reset = false;           // Coupe la connexion sans repondre
+        bool rst = false;             // Coupe la connexion par un RST TCP (SO_LINGER nul)
+        int status = 0;               // Statut HTTP renvoye a la place de la reponse
+    };
+
+    /**
+     * @brief Lit une liste de pannes au format des scenarios JSON
+     */
+    static QList<Fault> faultsFromJson(const QJsonArray& array);
+
+    void setFaults(const QList<Fault>& faults);
+    void clearFaults() { setFaults(QList<Fault>()); }
+
+    explicit LocalGitServer(const QString& projectRoot);
+    ~LocalGitServer();
+
+    /**
+     * @brief Demarre l'ecoute sur 127.0.0.1 (port choisi par le systeme)
+     * @return true si le serveur ecoute
+     */
+    bool start();
+    void stop();
+
+    QString baseUrl() const;
+    QString gitUrl(const QString& repositoryName) const;
+
+    int probeRequests() const { return m_probeRequests.load(); }
+    int gitRequests() const { return m_gitRequests.load(); }
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) override;
+
+private:
+    void onReadyRead(QTcpSocket* socket);
+    void handleRequest(QTcpSocket* socket, const Request& request);
+    void respond(QTcpSocket* socket, const Request& request, const Fault& fault);
+    void serveGit(QTcpSocket* socket, const Request& request, int bandwidth);
+    void sendResponse(QTcpSocket* socket, const QByteArray& status,
+                      const QList<QPair<QByteArray, QByteArray>>& headers, const QByteArray& body,
+                      int bandwidth = 0);
+    void writeThrottled(QPointer<QTcpSocket> socket, const QByteArray& data, int bandwidth);
+    static void resetConnection(QTcpSocket* socket);
+    Fault takeFault(const QString& target);
+
+    static bool parseRequest(const QByteArray& buffer, Request& request);
+    static bool decodeChunked(const QByteArray& data, QByteArray& decoded);
+
+    QString m_projectRoot;
+    QThread m_thread;
+    quint16 m_port;
+    QHash<QTcpSocket*, QByteArray> m_buffers;
+    QMutex m_faultMutex;
+    QList<Fault> m_faults;
+    std::atomic<int> m_probeRequests;
+    std::atomic<int> m_gitRequests;
+};
+
+#endif // LOCALGITSERVER_H
@@ -1,5 +1,12 @@
 ﻿#include <QtTest/QtTest>
 #include "include/gitmanager.h" // Assurez-vous que le chemin est correct
+#include "include/publishdag.h"
+#include "include/repostatecache.h"
+#include "include/archivereader.h"
+#include "include/pushqueue.h"
+#include "include/statustreemodel.h"
+#include "include/fetchscheduler.h"
+#include <atomic>
 
 class TestGitManager : public QObject
 {
@@ -7,6 +14,25 @@ class TestGitManager : public QObject
 
 private slots:
     void testIsGitAvailable();
+    void testTransportConfigArgs();
+    void testCancelLatency();
+    void testLatencyHistogram();
+    void testCompactPathList();
+    void testDirWalker();
+    void testPipelinedStaging();
+    void testSummarizeStagedChanges();
+    void testPublishDag();
+    void testRepoStateCache();
+    void testLargeRepoMode();
+    void testSparseSubdirectory();
+    void testBackends();
+    void testArchiveExtraction();
+    void testPushQueue();
+    void testMirrorMode();
+    void testMultiBranchPublish();
+    void testChunkedCommit();
+    void testStatusTreeModel();
+    void testFetchScheduler();
 };
 
 void TestGitManager::testIsGitAvailable()
@@ -16,5 +42,1371 @@ void TestGitManager::testIsGitAvailable()
     QVERIFY(manager.isGitAvailable());
 }
 
-QTEST_MAIN(TestGitManager)
+void TestGitManager::testTransportConfigArgs()
+{
+    QVERIFY(GitManager::transportConfigArgs(TransportProfile::Default).isEmpty());
+
+    QStringList args = GitManager::transportConfigArgs(TransportProfile::WanLowBandwidth);
+    QCOMPARE(args.size() % 2, 0);
+    for (int i = 0; i < args.size(); i += 2) {
+        QCOMPARE(args.at(i), QString("-c"));
+        QVERIFY(args.at(i + 1).contains('='));
+    }
+    QVERIFY(args.contains("core.compression=9"));
+
+    // Identifiants en en-tete, a la suite de la configuration deja passee par l'environnement
+    QProcessEnvironment base;
+    base.insert("GIT_CONFIG_COUNT", "1");
+    base.insert("GIT_CONFIG_KEY_0", "init.defaultBranch");
+    base.insert("GIT_CONFIG_VALUE_0", "main");
+    const QString url = "https://example.invalid/depot.git";
+    QProcessEnvironment env = GitManager::credentialEnvironment(base, url, "user", "secret");
+    QCOMPARE(env.value("GIT_CONFIG_COUNT"), QString("2"));
+    QCOMPARE(env.value("GIT_CONFIG_KEY_0"), QString("init.defaultBranch"));
+    QCOMPARE(env.value("GIT_CONFIG_KEY_1"), "http." + url + ".extraHeader");
+    QCOMPARE(env.value("GIT_CONFIG_VALUE_1"),
+             "Authorization: Basic " + QString::fromLatin1(QByteArray("user:secret").toBase64()));
+    QCOMPARE(GitManager::credentialEnvironment(base, "http://example.invalid/depot.git", "user", "secret")
+                 .toStringList(), base.toStringList());
+    QCOMPARE(GitManager::credentialEnvironment(base, url, "user", QString()).toStringList(), base.toStringList());
+}
+
+void TestGitManager::testCancelLatency()
+{
+    QTemporaryDir workDir;
+    QVERIFY(workDir.isValid());
+
+    GitManager manager;
+    QVERIFY(manager.executeGitCommand(workDir.path(), QStringList() << "init" << "-q"));
+
+    // Verrou d'un autre git, anterieur a la commande: l'annulation le laisse en place
+    QFile foreignLock(QDir(workDir.path()).filePath(".git/index.lock"));
+    QVERIFY(foreignLock.open(QIODevice::WriteOnly));
+    foreignLock.close();
+
+    // Commande lancee pendant l'attente de la premiere: refusee sans toucher au processus
+    bool nestedRefused = false;
+    GitError nestedCode = GitError::None;
+    QTimer::singleShot(50, &manager, [&]() {
+        nestedRefused = !manager.executeGitCommand(workDir.path(), QStringList() << "--version");
+        nestedCode = manager.lastErrorCode();
+    });
+    QTimer::singleShot(100, &manager, [&manager]() { manager.cancelOperation(); });
+
+    // hash-object --stdin attend la fin de stdin: il ne se termine qu'a l'annulation
+    QElapsedTimer elapsed;
+    elapsed.start();
+    QVERIFY(!manager.executeGitCommand(workDir.path(), QStringList() << "hash-object" << "--stdin", 10000));
+
+    QCOMPARE(manager.lastErrorCode(), GitError::UserCancelled);
+    QVERIFY(nestedRefused);
+    QCOMPARE(nestedCode, GitError::ProcessFailed);
+    QVERIFY(!manager.isBusy());
+    QVERIFY(foreignLock.exists());
+
+    // Objectif de 200 ms suivi par un avertissement; marge pour les machines chargees
+    QVERIFY(manager.lastCancelLatencyMs() >= 0);
+    QVERIFY2(manager.lastCancelLatencyMs() < 2000,
+             qPrintable(QString("Latence d'annulation: %1 ms").arg(manager.lastCancelLatencyMs())));
+    QVERIFY(elapsed.elapsed() < 5000);
+}
+
+void TestGitManager::testLatencyHistogram()
+{
+    LatencyHistogram histogram;
+    QCOMPARE(histogram.percentile(0.95), qint64(0));
+
+    for (int i = 0; i < 95; ++i) {
+        histogram.record(3);
+    }
+    for (int i = 0; i < 5; ++i) {
+        histogram.record(400);
+    }
+
+    QCOMPARE(histogram.count(), qint64(100));
+    QCOMPARE(histogram.percentile(0.50), qint64(5));
+    QCOMPARE(histogram.percentile(0.95), qint64(5));
+    QCOMPARE(histogram.percentile(0.99), qint64(400));
+
+    GitManager manager;
+    QVERIFY(manager.isGitAvailable());
+    QCOMPARE(manager.metrics().processSpawns(), qint64(1));
+    QVERIFY(manager.metrics().toPrometheus().contains("rogue_git_process_spawns_total 1"));
+}
+
+void TestGitManager::testCompactPathList()
+{
+    const QString accented = QString::fromUtf8("\xc3\xa9t\xc3\xa9.txt");
+    CompactPathList list("/depot");
+    list.append(QString(), "README.md");
+    list.append("src/ui", "fenetre.cpp");
+    list.append("src/ui", "fenetre.h");
+    list.appendPath("docs/guide/prise_en_main.md");
+    list.append("src/ui", accented);
+
+    QCOMPARE(list.size(), qsizetype(5));
+    QCOMPARE(list.relativePath(0), QString("README.md"));
+    QCOMPARE(list.relativePath(2), QString("src/ui/fenetre.h"));
+    QCOMPARE(list.relativePath(3), QString("docs/guide/prise_en_main.md"));
+    QCOMPARE(list.relativePath(4), "src/ui/" + accented);
+    QCOMPARE(list.absolutePath(1), QString("/depot/src/ui/fenetre.cpp"));
+
+    CompactPathList moved = std::move(list);
+    moved.squeeze();
+    QCOMPARE(moved.size(), qsizetype(5));
+    QCOMPARE(moved.relativePathUtf8(4), QString("src/ui/" + accented).toUtf8());
+}
+
+void TestGitManager::testDirWalker()
+{
+    QTemporaryDir workDir;
+    QVERIFY(workDir.isValid());
+    QDir root(workDir.path());
+    QVERIFY(root.mkpath("a/b/c"));
+    for (const QString& path : { QString("racine.txt"), QString("a/un.txt"), QString("a/b/c/trois.txt") }) {
+        QFile file(root.filePath(path));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+
+    auto walk = [&root](DirWalker::SymlinkPolicy policy) {
+        DirWalker walker(root.path(), policy);
+        DirWalker::Entry entry;
+        QStringList files;
+        while (walker.next(entry)) {
+            if (!entry.isDirectory) {
+                files << entry.relativePath();
+            }
+        }
+        files.sort();
+        return files;
+    };
+
+    const QStringList expected = { "a/b/c/trois.txt", "a/un.txt", "racine.txt" };
+    QCOMPARE(walk(DirWalker::SymlinkPolicy::FollowFiles), expected);
+
+#if defined(Q_OS_UNIX)
+    // Lien vers un ancetre: le parcours doit se terminer sans doublon
+    QVERIFY(QFile::link(root.filePath("a"), root.filePath("a/b/c/boucle")));
+    QVERIFY(QFile::link(root.filePath("racine.txt"), root.filePath("a/lien.txt")));
+    QCOMPARE(walk(DirWalker::SymlinkPolicy::FollowAll),
+             QStringList({ "a/b/c/trois.txt", "a/lien.txt", "a/un.txt", "racine.txt" }));
+    QCOMPARE(walk(DirWalker::SymlinkPolicy::Skip), expected);
+    QCOMPARE(DirWalker::countFiles(root.path()), qint64(4));
+
+    // Un seul dossier, fichiers dates, liens renvoyes sans etre suivis (miroir)
+    DirWalker single(root.filePath("a"), DirWalker::SymlinkPolicy::FollowAll);
+    single.setRecursive(false);
+    single.setFileMetadata(true);
+    single.setReportSymlinks(true);
+    QStringList listed;
+    DirWalker::Entry item;
+    while (single.next(item)) {
+        listed << item.name + (item.isDirectory ? "/" : item.isSymlink ? "@" : QString(":%1").arg(item.size));
+        if (item.name == "un.txt") {
+            QCOMPARE(item.modifiedMSecs / 1000,
+                     QFileInfo(root.filePath("a/un.txt")).lastModified().toSecsSinceEpoch());
+        }
+    }
+    listed.sort();
+    QCOMPARE(listed, QStringList({ "b/", "lien.txt@", "un.txt:0" }));
+#endif
+
+    // Depot imbrique jamais parcouru; entrees cachees seulement sur demande
+    QVERIFY(root.mkpath(".git/objects"));
+    QVERIFY(root.mkpath("a/.cache"));
+    QVERIFY(root.mkpath("a/sous/.GIT"));
+    for (const QString& path : { QString(".git/config"), QString(".env"), QString("a/.cache/donnees"),
+                                 QString("a/sous/.GIT/HEAD") }) {
+        QFile file(root.filePath(path));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+    QCOMPARE(walk(DirWalker::SymlinkPolicy::Skip), expected);
+
+    DirWalker hiddenWalker(root.path(), DirWalker::SymlinkPolicy::Skip, true);
+    DirWalker::Entry entry;
+    QStringList hidden;
+    while (hiddenWalker.next(entry)) {
+        QVERIFY2(!DirWalker::isGitDirName(entry.name), qPrintable(entry.relativePath()));
+        if (!entry.isDirectory) {
+            hidden << entry.relativePath();
+        }
+    }
+    hidden.sort();
+    QCOMPARE(hidden, QStringList({ ".env", "a/.cache/donnees", "a/b/c/trois.txt", "a/un.txt", "racine.txt" }));
+
+    // La copie suit le meme filtre: ni .git ni .env dans la destination
+    QTemporaryDir destDir;
+    QVERIFY(destDir.isValid());
+    GitManager manager;
+    manager.setSymlinkPolicy(DirWalker::SymlinkPolicy::Skip);
+    CompactPathList copied(destDir.path());
+    QCOMPARE(manager.copyDirectoryRecursively(root.path(), destDir.path(), copied), 3);
+    QVERIFY(!QFileInfo::exists(destDir.filePath(".git")));
+    QVERIFY(!QFileInfo::exists(destDir.filePath(".env")));
+    QVERIFY(!QFileInfo::exists(destDir.filePath("a/.cache")));
+    QVERIFY(QFileInfo::exists(destDir.filePath("a/b/c/trois.txt")));
+}
+
+void TestGitManager::testPipelinedStaging()
+{
+    QTemporaryDir workDir;
+    QVERIFY(workDir.isValid());
+    QDir root(workDir.path());
+
+    QString repo = root.filePath("depot");
+    QVERIFY(root.mkpath("depot"));
+    QCOMPARE(QProcess::execute("git", QStringList() << "init" << "-q" << repo), 0);
+
+    // Le .gitignore du sous-dossier doit s'appliquer quel que soit l'ordre de lecture
+    const QStringList sources = { "projet/a.txt", "projet/sous/.gitignore", "projet/sous/b.txt",
+                                  "projet/sous/journal.log", "projet/sous/profond/c.txt" };
+    for (const QString& path : sources) {
+        QVERIFY(root.mkpath(QFileInfo(root.filePath(path)).path()));
+        QFile file(root.filePath(path));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(path.endsWith(".gitignore") ? "*.log\n" : path.toUtf8());
+    }
+
+    // Desactive par defaut: l'application l'active explicitement
+    GitManager manager;
+    QVERIFY(!manager.pipelinedStaging());
+    manager.setPipelinedStaging(true);
+    QSignalSpy warnings(&manager, &GitManager::operationWarning);
+    QVERIFY2(manager.copyProjectRecursively(repo, QStringList() << root.filePath("projet")),
+             qPrintable(manager.lastError()));
+    QCOMPARE(warnings.count(), 0);
+
+    QProcess lsFiles;
+    lsFiles.setWorkingDirectory(repo);
+    lsFiles.start("git", QStringList() << "ls-files");
+    QVERIFY(lsFiles.waitForFinished());
+    QStringList staged = QString::fromUtf8(lsFiles.readAllStandardOutput()).split('\n', Qt::SkipEmptyParts);
+    staged.sort();
+
+    QCOMPARE(staged, QStringList({ "projet/a.txt", "projet/sous/.gitignore",
+                                   "projet/sous/b.txt", "projet/sous/profond/c.txt" }));
+
+    // Index verrouille par un autre git: repli signale, la copie reussit quand meme
+    QFile lock(QDir(repo).filePath(".git/index.lock"));
+    QVERIFY(lock.open(QIODevice::WriteOnly));
+    lock.close();
+    QVERIFY2(manager.copyProjectRecursively(repo, QStringList() << root.filePath("projet")),
+             qPrintable(manager.lastError()));
+    QCOMPARE(warnings.count(), 1);
+    QVERIFY(lock.exists());
+    QVERIFY(lock.remove());
+
+    // Au-dela de la file bornee, submit() attend git dans une boucle locale:
+    // les evenements du thread (ici un minuteur) continuent d'etre servis
+    const qint64 count = StagingPipeline::maxInFlightPaths() + 500;
+    QDir many(QDir(repo).filePath("nombreux"));
+    QVERIFY(many.mkpath("."));
+    for (qint64 i = 0; i < count; ++i) {
+        QFile file(many.filePath(QString("f%1.txt").arg(i)));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray::number(i));
+    }
+    int ticks = 0;
+    QTimer ticker;
+    connect(&ticker, &QTimer::timeout, [&ticks]() { ++ticks; });
+    ticker.start(0);
+    StagingPipeline pipeline(repo);
+    QVERIFY2(pipeline.start(), qPrintable(pipeline.errorString()));
+    for (qint64 i = 0; i < count; ++i) {
+        pipeline.submit(QString("nombreux/f%1.txt").arg(i).toUtf8());
+    }
+    QVERIFY2(pipeline.finish(), qPrintable(pipeline.errorString()));
+    ticker.stop();
+    QCOMPARE(pipeline.staged(), count);
+    QVERIFY(ticks > 0);
+}
+
+void TestGitManager::testSummarizeStagedChanges()
+{
+    QTemporaryDir workDir;
+    QVERIFY(workDir.isValid());
+    QDir repo(workDir.path());
+    QCOMPARE(QProcess::execute("git", QStringList() << "init" << "-q" << repo.path()), 0);
+
+    const QList<QPair<QString, int>> files = { { "petit.txt", 10 }, { "moyen.txt", 1000 },
+                                                { "dossier/gros.bin", 50000 } };
+    for (const auto& file : files) {
+        QVERIFY(repo.mkpath(QFileInfo(repo.filePath(file.first)).path()));
+        QFile out(repo.filePath(file.first));
+        QVERIFY(out.open(QIODevice::WriteOnly));
+        out.write(QByteArray(file.second, 'x'));
+    }
+
+    GitManager manager;
+    QVERIFY(manager.addAllFiles(repo.path()));
+
+    ChangeSummary summary;
+    QVERIFY2(manager.summarizeStagedChanges(repo.path(), summary, 2), qPrintable(manager.lastError()));
+    QCOMPARE(summary.files, qint64(3));
+    QCOMPARE(summary.added, qint64(3));
+    QCOMPARE(summary.deleted, qint64(0));
+    QCOMPARE(summary.bytes, qint64(51010));
+    QCOMPARE(summary.largest.size(), 2);
+    QCOMPARE(summary.largest.at(0).path, QString("dossier/gros.bin"));
+    QCOMPARE(summary.largest.at(0).bytes, qint64(50000));
+    QCOMPARE(summary.largest.at(1).path, QString("moyen.txt"));
+
+    // Une trace sur stderr ne doit pas se meler a la sortie analysee
+    const QByteArray previousTrace = qgetenv("GIT_TRACE");
+    qputenv("GIT_TRACE", "1");
+    auto restoreTrace = qScopeGuard([&]() {
+        previousTrace.isNull() ? qunsetenv("GIT_TRACE") : qputenv("GIT_TRACE", previousTrace);
+    });
+    ChangeSummary traced;
+    QVERIFY2(manager.summarizeStagedChanges(repo.path(), traced, 2), qPrintable(manager.lastError()));
+    QCOMPARE(traced.files, summary.files);
+    QCOMPARE(traced.bytes, summary.bytes);
+    QCOMPARE(traced.largest.at(0).path, QString("dossier/gros.bin"));
+
+    QVERIFY(QFile::remove(repo.filePath("petit.txt")));
+    QVERIFY2(manager.restoreMissingFiles(repo.path()), qPrintable(manager.lastError()));
+    QVERIFY(QFile::exists(repo.filePath("petit.txt")));
+}
+
+void TestGitManager::testPublishDag()
+{
+    QTemporaryDir workDir;
+    QVERIFY(workDir.isValid());
+    QCOMPARE(QProcess::execute("git", QStringList() << "init" << "-q" << workDir.path()), 0);
+
+    // Remote deja configure: lu une fois par git, puis garde en cache
+    GitManager manager;
+    const QString url = "https://example.invalid/depot.git";
+    QVERIFY(manager.setRemoteUrl(workDir.path(), url));
+    QCOMPARE(manager.originUrl(workDir.path()), url);
+    qint64 spawns = manager.metrics().processSpawns();
+    QCOMPARE(manager.originUrl(workDir.path()), url);
+    QVERIFY(manager.setRemoteUrl(workDir.path(), url));
+    QCOMPARE(manager.metrics().processSpawns(), spawns);
+
+    QStringList order;
+    std::atomic<bool> concurrentDone(false);
+    PublishDag dag;
+    dag.addStep({ "a", {}, []() { return true; }, [&order]() { order << "a"; return true; } });
+    dag.addStep({ "sonde", {}, nullptr, [&concurrentDone]() {
+        QThread::msleep(50);
+        concurrentDone = true;
+        return true;
+    }, true });
+    dag.addStep({ "b", { "a" }, nullptr, [&order]() { order << "b"; return true; } });
+    dag.addStep({ "c", { "b", "sonde" }, nullptr, [&order, &concurrentDone]() {
+        order << (concurrentDone ? "c" : "c-trop-tot");
+        return true;
+    } });
+
+    QVERIFY(dag.run());
+    QCOMPARE(order, QStringList({ "b", "c" }));
+    QCOMPARE(dag.skippedSteps(), QStringList({ "a" }));
+
+    // Un echec arrete les etapes dependantes
+    PublishDag failing;
+    bool reached = false;
+    failing.addStep({ "x", {}, nullptr, []() { return false; } });
+    failing.addStep({ "y", { "x" }, nullptr, [&reached]() { reached = true; return true; } });
+    QVERIFY(!failing.run());
+    QCOMPARE(failing.failedStep(), QString("x"));
+    QCOMPARE(failing.outcome("y"), PublishDag::Outcome::Pending);
+    QVERIFY(!reached);
+}
+
+void TestGitManager::testRepoStateCache()
+{
+    QTemporaryDir workDir;
+    QVERIFY(workDir.isValid());
+    QDir repo(workDir.path());
+
+    GitManager manager;
+    RepoStateCache* cache = manager.repoState();
+    QVERIFY(!manager.isGitRepository(repo.path()));
+
+    // Creation exterieure du depot: detectee par la surveillance du dossier
+    QSignalSpy invalidated(cache, &RepoStateCache::invalidated);
+    QCOMPARE(QProcess::execute("git", QStringList() << "init" << "-q" << "-b" << "principale" << repo.path()), 0);
+    QVERIFY(invalidated.wait(5000));
+    QVERIFY(manager.isGitRepository(repo.path()));
+    QCOMPARE(cache->state(repo.path()).branch, QString("principale"));
+
+    QFile file(repo.filePath("a.txt"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("a");
+    file.close();
+    QVERIFY(manager.addAllFiles(repo.path()));
+    QVERIFY(manager.commit(repo.path(), "premier"));
+
+    // Lectures repetees: un seul chargement, aucun processus
+    QVERIFY(manager.executeGitCommand(repo.path(), QStringList() << "rev-parse" << "HEAD"));
+    const QString head = manager.lastOutput().trimmed();
+    int loads = cache->loadCount();
+    qint64 spawns = manager.metrics().processSpawns();
+    for (int i = 0; i < 3; ++i) {
+        QCOMPARE(cache->state(repo.path()).head, head);
+        QVERIFY(manager.isGitRepository(repo.path()));
+    }
+    QCOMPARE(cache->loadCount(), loads + 1);
+    QCOMPARE(manager.metrics().processSpawns(), spawns);
+
+    // Modification exterieure de la configuration
+    invalidated.clear();
+    QProcess config;
+    config.setWorkingDirectory(repo.path());
+    config.start("git", QStringList() << "remote" << "add" << "origin" << "https://example.invalid/x.git");
+    QVERIFY(config.waitForFinished());
+    QVERIFY(invalidated.wait(5000));
+    QCOMPARE(manager.originUrl(repo.path()), QString("https://example.invalid/x.git"));
+
+    // Une commande qui ecrit l'index invalide l'etat, pas l'URL deja lue
+    QVERIFY(manager.addAllFiles(repo.path()));
+    spawns = manager.metrics().processSpawns();
+    QCOMPARE(manager.originUrl(repo.path()), QString("https://example.invalid/x.git"));
+    QCOMPARE(manager.metrics().processSpawns(), spawns);
+
+    // Syntaxe que seul git interprete: casse de la section, commentaire en
+    // fin de ligne, continuation et include
+    QFile included(repo.filePath("inclus.cfg"));
+    QVERIFY(included.open(QIODevice::WriteOnly));
+    included.write("[REMOTE \"origin\"]\n\turl = https://example.invalid/\\\ninclus.git ; commentaire\n");
+    included.close();
+    QFile configFile(repo.filePath(".git/config"));
+    QVERIFY(configFile.open(QIODevice::Append));
+    configFile.write("[include]\n\tpath = ../inclus.cfg\n");
+    configFile.close();
+    cache->invalidate(repo.path());
+    QCOMPARE(manager.originUrl(repo.path()), QString("https://example.invalid/inclus.git"));
+}
+
+void TestGitManager::testLargeRepoMode()
+{
+    QTemporaryDir workDir;
+    QVERIFY(workDir.isValid());
+
+    // Configuration globale et systeme ignorees: un feature.manyFiles ou un
+    // index.version de la machine fausserait les versions attendues
+    const QString globalConfig = QDir(workDir.path()).filePath("gitconfig");
+    QVERIFY(QFile(globalConfig).open(QIODevice::WriteOnly));
+    const QByteArray previousGlobal = qgetenv("GIT_CONFIG_GLOBAL");
+    const QByteArray previousNoSystem = qgetenv("GIT_CONFIG_NOSYSTEM");
+    qputenv("GIT_CONFIG_GLOBAL", QFile::encodeName(globalConfig));
+    qputenv("GIT_CONFIG_NOSYSTEM", "1");
+    auto restoreEnvironment = qScopeGuard([&]() {
+        previousGlobal.isNull() ? qunsetenv("GIT_CONFIG_GLOBAL") : qputenv("GIT_CONFIG_GLOBAL", previousGlobal);
+        previousNoSystem.isNull() ? qunsetenv("GIT_CONFIG_NOSYSTEM") : qputenv("GIT_CONFIG_NOSYSTEM", previousNoSystem);
+    });
+
+    auto createRepo = [&workDir](const QString& name, int files) {
+        QDir repo(QDir(workDir.path()).filePath(name));
+        if (QProcess::execute("git", QStringList() << "init" << "-q" << repo.path()) != 0) {
+            return QString();
+        }
+        for (int i = 0; i < files; ++i) {
+            QFile file(repo.filePath(QString("f%1.txt").arg(i)));
+            if (!file.open(QIODevice::WriteOnly)) {
+                return QString();
+            }
+            file.write(QByteArray::number(i));
+        }
+        return repo.path();
+    };
+
+    GitManager manager;
+    manager.setLargeRepoThreshold(5);
+    int version = 0;
+    qint64 entries = 0;
+    QSignalSpy successes(&manager, &GitManager::operationSuccess);
+    auto lastSuccess = [&successes]() {
+        return successes.isEmpty() ? QString() : successes.last().at(0).toString();
+    };
+
+    // Petit depot: index par defaut
+    const QString small = createRepo("petit", 3);
+    QVERIFY(!small.isEmpty());
+    QVERIFY(manager.addAllFiles(small));
+    QVERIFY(GitManager::readIndexHeader(small, version, entries));
+    QCOMPARE(version, 2);
+    QVERIFY2(lastSuccess().endsWith("ms, index standard)"), qPrintable(lastSuccess()));
+
+    // Premiere publication de nombreux fichiers non suivis: active des le premier ajout
+    const QString large = createRepo("grand", 8);
+    QVERIFY(!large.isEmpty());
+    QVERIFY(manager.addAllFiles(large));
+    QVERIFY(GitManager::readIndexHeader(large, version, entries));
+    QCOMPARE(version, 4);
+
+    // Durees des appels reels journalisees, premier appel apres activation compris
+    QVERIFY2(lastSuccess().endsWith("ms, mode grand depot, premier appel apres activation)"),
+             qPrintable(lastSuccess()));
+    ChangeSummary summary;
+    QVERIFY(manager.summarizeStagedChanges(large, summary));
+    QCOMPARE(summary.files, qint64(8));
+    QVERIFY2(lastSuccess().startsWith("Etat de l'index lu: 8 fichier(s)"), qPrintable(lastSuccess()));
+    QVERIFY(lastSuccess().endsWith("ms, mode grand depot, premier appel apres activation)"));
+    QVERIFY(manager.executeGitCommand(large, QStringList() << "config" << "--get" << "core.untrackedCache"));
+    QCOMPARE(manager.lastOutput().trimmed(), QString("true"));
+
+    // Index existant qui franchit le seuil: reecrit en v4
+    QFile extra(QDir(small).filePath("g.txt"));
+    QVERIFY(extra.open(QIODevice::WriteOnly));
+    extra.close();
+    QVERIFY(manager.addAllFiles(small)); // 4 entrees: sous le seuil
+    QFile more(QDir(small).filePath("h.txt"));
+    QVERIFY(more.open(QIODevice::WriteOnly));
+    more.close();
+    QVERIFY(manager.addAllFiles(small)); // 5 entrees
+    QVERIFY(manager.addAllFiles(small)); // Seuil atteint par l'index: activation
+    QVERIFY(GitManager::readIndexHeader(small, version, entries));
+    QCOMPARE(version, 4);
+
+    // Mode deja actif: seul git add -A est lance
+    qint64 spawns = manager.metrics().processSpawns();
+    QVERIFY(manager.addAllFiles(large));
+    QCOMPARE(manager.metrics().processSpawns(), spawns + 1);
+    QVERIFY2(lastSuccess().endsWith("ms, mode grand depot)"), qPrintable(lastSuccess()));
+
+    // Echec de configuration: averti, l'ajout continue
+    const QString locked = createRepo("verrouille", 8);
+    QVERIFY(!locked.isEmpty());
+    QFile configLock(QDir(locked).filePath(".git/config.lock"));
+    QVERIFY(configLock.open(QIODevice::WriteOnly));
+    configLock.close();
+    QVERIFY(manager.addAllFiles(locked));
+    QVERIFY(manager.executeGitCommand(locked, QStringList() << "ls-files"));
+    QCOMPARE(manager.lastOutput().split('\n', Qt::SkipEmptyParts).size(), 8);
+}
+
+void TestGitManager::testSparseSubdirectory()
+{
+    QTemporaryDir workDir;
+    QVERIFY(workDir.isValid());
+    QDir root(workDir.path());
+
+    // Monorepo source: racine, dossier publie et dossier voisin
+    const QString sourcePath = root.filePath("source");
+    QCOMPARE(QProcess::execute("git", QStringList() << "init" << "-q" << "-b" << "main" << sourcePath), 0);
+    QDir source(sourcePath);
+    for (const QString& path : { QString("racine.txt"), QString("autre/a.txt"), QString("cible/b.txt") }) {
+        QVERIFY(source.mkpath(QFileInfo(source.filePath(path)).path()));
+        QFile file(source.filePath(path));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(path.toUtf8());
+    }
+    QCOMPARE(QProcess::execute("git", QStringList() << "-C" << sourcePath << "add" << "-A"), 0);
+    QCOMPARE(QProcess::execute("git", QStringList() << "-C" << sourcePath << "-c" << "user.name=t"
+                               << "-c" << "user.email=t@t" << "commit" << "-qm" << "init"), 0);
+
+    GitManager manager;
+    QVERIFY(manager.setPublishSubdirectory("cible/"));
+    QCOMPARE(manager.publishSubdirectory(), QString("cible"));
+
+    // Chemins qui sortent du depot ou visent .git: refuses, valeur conservee
+    for (const QString& rejected : { QString("/cible"), QString("../cible"), QString("cible/../.."),
+                                     QString("a/../../b"), QString("C:/cible"), QString("\\\\serveur\\cible"),
+                                     QString(".git/hooks"), QString("a/.GIT") }) {
+        QVERIFY2(!manager.setPublishSubdirectory(rejected), qPrintable(rejected));
+        QCOMPARE(manager.publishSubdirectory(), QString("cible"));
+    }
+
+    const QString repoPath = root.filePath("local");
+    QVERIFY2(manager.bootstrapRepository(repoPath, QUrl::fromLocalFile(sourcePath).toString(), "main",
+                                         "user", "secret"), qPrintable(manager.lastError()));
+    QDir repo(repoPath);
+    QFile config(repo.filePath(".git/config"));
+    QVERIFY(config.open(QIODevice::ReadOnly));
+    QVERIFY(!config.readAll().contains("secret"));
+    config.close();
+    QVERIFY(repo.exists("cible/b.txt"));
+    QVERIFY(repo.exists("racine.txt"));
+    QVERIFY(!repo.exists("autre"));
+    QVERIFY(manager.isSparseCheckoutCurrent(repoPath));
+
+    // Cone elargi a la main: ne correspond plus, puis remis au seul dossier publie
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "sparse-checkout" << "add" << "autre"));
+    QVERIFY(!manager.isSparseCheckoutCurrent(repoPath));
+    QVERIFY(manager.ensureSparseCheckout(repoPath));
+    QVERIFY(manager.isSparseCheckoutCurrent(repoPath));
+    QVERIFY(!repo.exists("autre"));
+
+    // La copie arrive dans le sous-dossier; le reste du depot n'est pas supprime
+    QFile input(root.filePath("nouveau.txt"));
+    QVERIFY(input.open(QIODevice::WriteOnly));
+    input.write("nouveau");
+    input.close();
+    QVERIFY(manager.copyProjectRecursively(repoPath, QStringList() << input.fileName()));
+    QVERIFY(repo.exists("cible/nouveau.txt"));
+    QVERIFY(manager.addAllFiles(repoPath));
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "-c" << "user.name=t" << "-c" << "user.email=t@t"
+                                      << "commit" << "-qm" << "publication"));
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "ls-tree" << "-r" << "--name-only" << "HEAD"));
+    QStringList tree = manager.lastOutput().split('\n', Qt::SkipEmptyParts);
+    tree.sort();
+    QCOMPARE(tree, QStringList({ "autre/a.txt", "cible/b.txt", "cible/nouveau.txt", "racine.txt" }));
+}
+
+void TestGitManager::testBackends()
+{
+    // Memes resultats quel que soit le moteur compile
+    for (GitBackend::Kind kind : GitManager::availableBackends()) {
+        QTemporaryDir workDir;
+        QVERIFY(workDir.isValid());
+        QDir repo(workDir.path());
+        QCOMPARE(QProcess::execute("git", QStringList() << "init" << "-q" << repo.path()), 0);
+        QCOMPARE(QProcess::execute("git", QStringList() << "-C" << repo.path() << "config" << "user.name" << "t"), 0);
+        QCOMPARE(QProcess::execute("git", QStringList() << "-C" << repo.path() << "config" << "user.email" << "t@t"), 0);
+
+        GitManager manager;
+        QVERIFY(manager.setBackend(kind));
+        GitBackend* backend = manager.backendFor(repo.path());
+        QCOMPARE(backend->kind(), kind);
+
+        QFile file(repo.filePath("a.txt"));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("a");
+        file.close();
+
+        QVector<GitStatusEntry> entries;
+        QVERIFY(backend->status(repo.path(), entries));
+        QCOMPARE(entries.size(), 1);
+        QCOMPARE(entries.at(0).path, QString("a.txt"));
+        QCOMPARE(entries.at(0).index, '?');
+
+        auto writeFile = [&repo](const QString& name) {
+            QVERIFY(repo.mkpath(QFileInfo(name).path()));
+            QFile created(repo.filePath(name));
+            QVERIFY(created.open(QIODevice::WriteOnly));
+            created.write(name.toUtf8());
+        };
+        writeFile("a1/suivi.txt");
+
+        QVERIFY2(manager.addAllFiles(repo.path()), qPrintable(manager.lastError()));
+        QVERIFY2(manager.commit(repo.path(), "premier", 0), qPrintable(manager.lastError()));
+        QVERIFY(!manager.commit(repo.path(), "vide", 0));
+        QCOMPARE(manager.lastErrorCode(), GitError::NothingToCommit);
+
+        QVERIFY(manager.setRemoteUrl(repo.path(), "https://example.invalid/b.git"));
+        QCOMPARE(manager.originUrl(repo.path()), QString("https://example.invalid/b.git"));
+        QVERIFY(backend->updateRef(repo.path(), "refs/remotes/origin/test", "HEAD"));
+        QVERIFY(manager.executeGitCommand(repo.path(), QStringList() << "rev-parse" << "refs/remotes/origin/test"));
+
+        // Sous-dossier publie pris a la lettre: "a[1]" n'est pas un motif qui couvre a1
+        writeFile("a[1]/x.txt");
+        writeFile("a1/y.txt");
+        QVERIFY(QFile::remove(repo.filePath("a1/suivi.txt")));
+        QVERIFY2(backend->addAll(repo.path(), "a[1]"), qPrintable(backend->lastError()));
+        QVERIFY(manager.executeGitCommand(repo.path(), QStringList() << "diff" << "--cached" << "--name-status"));
+        QCOMPARE(manager.lastOutput().trimmed(), QString("A\ta[1]/x.txt"));
+    }
+
+    // Reglage altere: moteur processus
+    GitManager clamped;
+    QVERIFY(!clamped.setBackend(static_cast<GitBackend::Kind>(42)));
+    QCOMPARE(clamped.backendKind(), GitBackend::Kind::Process);
+
+#if defined(ROGUE_HAVE_LIBGIT2)
+    // Filtre clean, crochet ou signature: libgit2 les ignorerait, git les applique
+    QTemporaryDir fallbackDir;
+    QVERIFY(fallbackDir.isValid());
+    QDir fallbackRepo(fallbackDir.path());
+    QCOMPARE(QProcess::execute("git", QStringList() << "init" << "-q" << fallbackRepo.path()), 0);
+    GitManager inProcess;
+    QVERIFY(inProcess.setBackend(GitBackend::Kind::Libgit2));
+    QCOMPARE(inProcess.backendFor(fallbackRepo.path())->kind(), GitBackend::Kind::Libgit2);
+
+    QCOMPARE(QProcess::execute("git", QStringList() << "-C" << fallbackRepo.path() << "config"
+                               << "filter.lfs.clean" << "git-lfs clean -- %f"), 0);
+    GitManager withFilter;
+    QVERIFY(withFilter.setBackend(GitBackend::Kind::Libgit2));
+    QCOMPARE(withFilter.backendFor(fallbackRepo.path())->kind(), GitBackend::Kind::Process);
+
+    QCOMPARE(QProcess::execute("git", QStringList() << "-C" << fallbackRepo.path() << "config"
+                               << "--unset" << "filter.lfs.clean"), 0);
+    QFile hook(fallbackRepo.filePath(".git/hooks/pre-commit"));
+    QVERIFY(hook.open(QIODevice::WriteOnly));
+    hook.write("#!/bin/sh\nexit 0\n");
+    hook.close();
+    GitManager withHook;
+    QVERIFY(withHook.setBackend(GitBackend::Kind::Libgit2));
+    QCOMPARE(withHook.backendFor(fallbackRepo.path())->kind(), GitBackend::Kind::Process);
+#else
+    GitManager manager;
+    QVERIFY(!manager.setBackend(GitBackend::Kind::Libgit2));
+    QCOMPARE(manager.backendKind(), GitBackend::Kind::Process);
+#endif
+}
+
+void TestGitManager::testArchiveExtraction()
+{
+    QTemporaryDir workDir;
+    QVERIFY(workDir.isValid());
+    QDir root(workDir.path());
+
+    QCOMPARE(ArchiveReader::sanitizePath("./a/./b.txt"), QString("a/b.txt"));
+    QCOMPARE(ArchiveReader::sanitizePath("a\\b.txt"), QString("a/b.txt"));
+    QVERIFY(ArchiveReader::sanitizePath("../b.txt").isEmpty());
+    QVERIFY(ArchiveReader::sanitizePath("a/../../b.txt").isEmpty());
+    QVERIFY(ArchiveReader::sanitizePath("/etc/passwd").isEmpty());
+    QVERIFY(ArchiveReader::sanitizePath("C:/b.txt").isEmpty());
+    QVERIFY(ArchiveReader::sanitizePath("a/.GIT/config").isEmpty());
+    QCOMPARE(ArchiveReader::baseName("/tmp/build-1.2.tar.gz"), QString("build-1.2"));
+
+    // Archives produites par git archive a partir d'un petit projet
+    const QString sourcePath = root.filePath("source");
+    QCOMPARE(QProcess::execute("git", QStringList() << "init" << "-q" << sourcePath), 0);
+    QDir source(sourcePath);
+    for (const QString& path : { QString("a.txt"), QString("docs/guide.md"), QString("bin/run.sh") }) {
+        QVERIFY(source.mkpath(QFileInfo(source.filePath(path)).path()));
+        QFile file(source.filePath(path));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(path.toUtf8());
+    }
+    QFile::setPermissions(source.filePath("bin/run.sh"),
+                          QFile::permissions(source.filePath("bin/run.sh")) | QFile::ExeOwner | QFile::ExeUser);
+    QCOMPARE(QProcess::execute("git", QStringList() << "-C" << sourcePath << "add" << "-A"), 0);
+    QCOMPARE(QProcess::execute("git", QStringList() << "-C" << sourcePath << "-c" << "user.name=t"
+                               << "-c" << "user.email=t@t" << "commit" << "-qm" << "init"), 0);
+
+    QStringList archives = { "artefact.tar" };
+#if defined(ROGUE_HAVE_ZLIB)
+    archives << "artefact.tar.gz" << "artefact.zip";
+#endif
+    for (const QString& name : archives) {
+        const QString archivePath = root.filePath(name);
+        QCOMPARE(QProcess::execute("git", QStringList() << "-C" << sourcePath << "archive"
+                                   << "-o" << archivePath << "HEAD"), 0);
+        QVERIFY(ArchiveReader::isArchive(archivePath));
+
+        const QString repoPath = root.filePath("depot-" + name);
+        GitManager manager;
+        manager.setArchiveExtraction(true);
+        QVERIFY2(manager.copyProjectRecursively(repoPath, QStringList() << archivePath),
+                 qPrintable(manager.lastError()));
+
+        QDir repo(repoPath);
+        QFile guide(repo.filePath("artefact/docs/guide.md"));
+        QVERIFY2(guide.open(QIODevice::ReadOnly), qPrintable(name));
+        QCOMPARE(guide.readAll(), QByteArray("docs/guide.md"));
+        QVERIFY(repo.exists("artefact/a.txt"));
+#if defined(Q_OS_UNIX)
+        QVERIFY(QFile::permissions(repo.filePath("artefact/bin/run.sh")) & QFile::ExeOwner);
+        QVERIFY(!(QFile::permissions(repo.filePath("artefact/a.txt")) & QFile::ExeOwner));
+#endif
+        QCOMPARE(manager.copiedFileCount(), qsizetype(3));
+    }
+
+    // Extraction desactivee: l'archive est copiee telle quelle
+    GitManager copier;
+    const QString copyRepo = root.filePath("depot-copie");
+    QVERIFY(copier.copyProjectRecursively(copyRepo, QStringList() << root.filePath("artefact.tar")));
+    QVERIFY(QFileInfo(QDir(copyRepo).filePath("artefact.tar")).isFile());
+
+    // Tar malveillant: seules les entrees qui restent dans la destination sont ecrites
+    auto tarEntry = [](const QByteArray& name, const QByteArray& data) {
+        QByteArray header(512, '\0');
+        header.replace(0, name.size(), name);
+        header.replace(100, 7, "0000644");
+        header.replace(124, 11, QByteArray::number(data.size(), 8).rightJustified(11, '0'));
+        header[156] = '0';
+        header.replace(257, 6, QByteArray("ustar\0", 6));
+        header.replace(263, 2, "00");
+        header.replace(148, 8, "        ");
+        int sum = 0;
+        for (char byte : header) {
+            sum += static_cast<unsigned char>(byte);
+        }
+        header.replace(148, 7, QByteArray::number(sum, 8).rightJustified(6, '0') + '\0');
+        return header + data + QByteArray((512 - data.size() % 512) % 512, '\0');
+    };
+    const QString evilPath = root.filePath("malveillant.tar");
+    QFile evil(evilPath);
+    QVERIFY(evil.open(QIODevice::WriteOnly));
+    evil.write(tarEntry("../evade.txt", "x") + tarEntry(".git/config", "x") + tarEntry(".git./config", "x") +
+               tarEntry(".GIT  /hooks/post-checkout", "x") + tarEntry("a/git~1/config", "x") +
+               tarEntry("sain.txt", "ok") + QByteArray(1024, '\0'));
+    evil.close();
+
+    ArchiveReader reader(evilPath);
+    QVERIFY(reader.open());
+    QCOMPARE(reader.format(), ArchiveReader::Format::Tar);
+    ArchiveReader::Entry entry;
+    QVERIFY(reader.next(entry));
+    QCOMPARE(entry.path, QString("sain.txt"));
+    char data[8];
+    QCOMPARE(reader.read(data, sizeof(data)), qint64(2));
+    QCOMPARE(reader.read(data, sizeof(data)), qint64(0));
+    QVERIFY(!reader.next(entry));
+    QVERIFY(reader.errorString().isEmpty());
+    QCOMPARE(reader.errors().size(), 5);
+    QCOMPARE(ArchiveReader::sanitizePath("a/.gitignore"), QString("a/.gitignore"));
+    QCOMPARE(ArchiveReader::sanitizePath("git~10/x"), QString("git~10/x"));
+
+    GitManager manager;
+    manager.setArchiveExtraction(true);
+    const QString evilRepo = root.filePath("depot-malveillant");
+    QVERIFY(manager.copyProjectRecursively(evilRepo, QStringList() << evilPath));
+    QVERIFY(QFile::exists(QDir(evilRepo).filePath("malveillant/sain.txt")));
+    QVERIFY(!QFile::exists(root.filePath("evade.txt")));
+    QVERIFY(!QFile::exists(QDir(evilRepo).filePath("evade.txt")));
+    QVERIFY(!QDir(evilRepo).exists("malveillant/.git"));
+    QVERIFY(!QDir(evilRepo).exists("malveillant/.git."));
+
+    // Archive tronquee: echec signale, la publication ne continue pas
+    const QString truncatedPath = root.filePath("tronquee.tar");
+    QFile truncated(truncatedPath);
+    QVERIFY(truncated.open(QIODevice::WriteOnly));
+    truncated.write(tarEntry("complet.txt", "ok") + tarEntry("coupe.txt", QByteArray(4096, 'x')).left(512 + 100));
+    truncated.close();
+    int failures = 0;
+    connect(&manager, &GitManager::operationFailed, this, [&failures]() { ++failures; });
+    QVERIFY(!manager.copyProjectRecursively(root.filePath("depot-tronque"), QStringList() << truncatedPath));
+    QCOMPARE(manager.lastErrorCode(), GitError::UnknownError);
+    QCOMPARE(failures, 1);
+
+    // Fichier illisible comme archive zip
+    const QString corruptPath = root.filePath("corrompue.zip");
+    QFile corrupt(corruptPath);
+    QVERIFY(corrupt.open(QIODevice::WriteOnly));
+    corrupt.write(QByteArray("PK\x03\x04", 4) + QByteArray(64, '\x7f'));
+    corrupt.close();
+    QVERIFY(!manager.copyProjectRecursively(root.filePath("depot-corrompu"), QStringList() << corruptPath));
+    QCOMPARE(failures, 2);
+}
+
+void TestGitManager::testPushQueue()
+{
+    QTemporaryDir workDir;
+    QVERIFY(workDir.isValid());
+    QDir root(workDir.path());
+
+    const QString remotePath = root.filePath("distant.git");
+    QCOMPARE(QProcess::execute("git", QStringList() << "init" << "-q" << "--bare" << remotePath), 0);
+
+    // Deux commits locaux mis en file l'un apres l'autre
+    const QString repoPath = root.filePath("local");
+    QCOMPARE(QProcess::execute("git", QStringList() << "init" << "-q" << "-b" << "main" << repoPath), 0);
+    QStringList commits;
+    for (const QString& name : { QString("a.txt"), QString("b.txt") }) {
+        QFile file(QDir(repoPath).filePath(name));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(name.toUtf8());
+        file.close();
+        QCOMPARE(QProcess::execute("git", QStringList() << "-C" << repoPath << "add" << "-A"), 0);
+        QCOMPARE(QProcess::execute("git", QStringList() << "-C" << repoPath << "-c" << "user.name=t"
+                                   << "-c" << "user.email=t@t" << "commit" << "-qm" << name), 0);
+        QProcess revParse;
+        revParse.start("git", QStringList() << "-C" << repoPath << "rev-parse" << "HEAD");
+        QVERIFY(revParse.waitForFinished());
+        commits << QString::fromLatin1(revParse.readAllStandardOutput()).trimmed();
+    }
+
+    // Tete lue sans processus, comme l'etape de mise en file de la publication
+    GitManager manager;
+    QCOMPARE(manager.headCommit(repoPath), commits.at(1));
+
+    // Distant injoignable: la file attend et reessaie
+    {
+        PushQueue queue;
+        queue.setRetryDelays(60000, 60000);
+        queue.setRepository(repoPath, QUrl::fromLocalFile(root.filePath("absent.git")).toString());
+        QSignalSpy failed(&queue, &PushQueue::pushFailed);
+        QVERIFY(queue.enqueue("main", commits.at(0), "a.txt"));
+        QVERIFY(queue.enqueue("main", commits.at(1), "b.txt\n\ndetail"));
+        QVERIFY(failed.wait(10000));
+        QCOMPARE(failed.first().at(1).toBool(), true);
+        QCOMPARE(queue.state(), PushQueue::State::Waiting);
+        QCOMPARE(queue.pending(), 2);
+        QCOMPARE(queue.entries().at(1).message, QString("b.txt"));
+        QVERIFY(queue.retryInMs() > 0);
+    }
+
+    // La file survit a la fermeture et part en un seul push des que le distant repond
+    PushQueue queue;
+    QSignalSpy pushed(&queue, &PushQueue::pushed);
+    queue.setRepository(repoPath, QUrl::fromLocalFile(remotePath).toString());
+    QCOMPARE(queue.pending(), 2);
+    QVERIFY(pushed.wait(10000));
+    QCOMPARE(pushed.size(), 1);
+    QCOMPARE(pushed.first().at(0).toInt(), 2);
+    QCOMPARE(queue.pending(), 0);
+    QVERIFY(!QFile::exists(QDir(repoPath).filePath(".git/rogue-publisher/push-queue")));
+
+    QProcess remoteHead;
+    remoteHead.start("git", QStringList() << "--git-dir" << remotePath << "rev-parse" << "refs/heads/main");
+    QVERIFY(remoteHead.waitForFinished());
+    QCOMPARE(QString::fromLatin1(remoteHead.readAllStandardOutput()).trimmed(), commits.at(1));
+
+    // Pause pendant une publication directe: la branche poussee quitte la file
+    {
+        PushQueue::PauseGuard pause(&queue);
+        QVERIFY(queue.enqueue("main", commits.at(1), "b.txt"));
+        QCOMPARE(queue.state(), PushQueue::State::Idle);
+        queue.discard("main");
+        QCOMPARE(queue.pending(), 0);
+    }
+}
+
+void TestGitManager::testMirrorMode()
+{
+    QTemporaryDir workDir;
+    QVERIFY(workDir.isValid());
+    QDir root(workDir.path());
+
+    auto writeFile = [](const QString& path, const QByteArray& data) {
+        QDir().mkpath(QFileInfo(path).path());
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(data);
+    };
+
+    const QString sourcePath = root.filePath("projet");
+    QDir source(sourcePath);
+    writeFile(source.filePath("a.txt"), "a");
+    writeFile(source.filePath("sous/b.txt"), "b");
+    writeFile(source.filePath("ancien/c.txt"), "c");
+    writeFile(source.filePath(".gitignore"), "*.log\n");
+
+    const QString repoPath = root.filePath("depot");
+    QCOMPARE(QProcess::execute("git", QStringList() << "init" << "-q" << repoPath), 0);
+    QDir repo(repoPath);
+
+    // Le change set est indexe pendant la copie
+    GitManager manager;
+    manager.setMirrorMode(true);
+    manager.setPipelinedStaging(true);
+    QVERIFY2(manager.copyProjectRecursively(repoPath, QStringList() << sourcePath), qPrintable(manager.lastError()));
+    QCOMPARE(manager.lastMirrorSummary().added, qint64(4));
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "-c" << "user.name=t" << "-c" << "user.email=t@t"
+                                      << "commit" << "-qm" << "init"));
+
+    // Suppressions, modification et ajout a la source
+    QVERIFY(QDir(source.filePath("ancien")).removeRecursively());
+    QVERIFY(QFile::remove(source.filePath("sous/b.txt")));
+    writeFile(source.filePath("a.txt"), "a modifie");
+    writeFile(source.filePath("nouveau.txt"), "n");
+
+    QVERIFY2(manager.copyProjectRecursively(repoPath, QStringList() << sourcePath), qPrintable(manager.lastError()));
+    MirrorSummary summary = manager.lastMirrorSummary();
+    QCOMPARE(summary.added, qint64(1));
+    QCOMPARE(summary.changed, qint64(1));
+    QCOMPARE(summary.removed, qint64(2));
+    QCOMPARE(summary.unchanged, qint64(1));
+    QVERIFY(!repo.exists("projet/ancien"));
+    QVERIFY(!repo.exists("projet/sous/b.txt"));
+    QCOMPARE(manager.copiedFileCount(), qsizetype(2));
+
+    const CompactPathList& removed = manager.m_removedFiles;
+    QStringList removedPaths;
+    for (qsizetype i = 0; i < removed.size(); ++i) {
+        removedPaths << removed.relativePath(i);
+    }
+    removedPaths.sort();
+    QCOMPARE(removedPaths, QStringList({ "projet/ancien/c.txt", "projet/sous/b.txt" }));
+
+    // Une copie en echec ne laisse pas la liste de la precedente
+    QVERIFY(!manager.copyProjectRecursively(repoPath, QStringList() << root.filePath("absent")));
+    QCOMPARE(manager.copiedFileCount(), qsizetype(0));
+
+    // Le change set est deja dans l'index, suppressions comprises
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "diff" << "--cached" << "--name-status"));
+    QStringList staged = manager.lastOutput().split('\n', Qt::SkipEmptyParts);
+    staged.sort();
+    QCOMPARE(staged, QStringList({ "A\tprojet/nouveau.txt", "D\tprojet/ancien/c.txt",
+                                   "D\tprojet/sous/b.txt", "M\tprojet/a.txt" }));
+
+    // Miroir deja a jour: rien a copier, pas d'erreur
+    QVERIFY2(manager.copyProjectRecursively(repoPath, QStringList() << sourcePath), qPrintable(manager.lastError()));
+    summary = manager.lastMirrorSummary();
+    QCOMPARE(summary.added + summary.changed + summary.removed, qint64(0));
+    QCOMPARE(summary.unchanged, qint64(3));
+    QCOMPARE(summary.failed, qint64(0));
+
+    // Depot imbrique absent de la source: conserve, compte en echec, jamais indexe
+    QCOMPARE(QProcess::execute("git", QStringList() << "init" << "-q" << repo.filePath("projet/vendor")), 0);
+    writeFile(repo.filePath("projet/vendor/v.txt"), "v");
+    QVERIFY2(manager.copyProjectRecursively(repoPath, QStringList() << sourcePath), qPrintable(manager.lastError()));
+    summary = manager.lastMirrorSummary();
+    QCOMPARE(summary.removed, qint64(0));
+    QCOMPARE(summary.failed, qint64(1));
+    QVERIFY(repo.exists("projet/vendor/.git/HEAD"));
+    QVERIFY(repo.exists("projet/vendor/v.txt"));
+    QCOMPARE(manager.m_removedFiles.size(), qsizetype(0));
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "diff" << "--cached" << "--name-only"));
+    QVERIFY(!manager.lastOutput().contains("vendor"));
+    QVERIFY(QDir(repo.filePath("projet/vendor")).removeRecursively());
+    QVERIFY(manager.addAllFiles(repoPath));
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "-c" << "user.name=t" << "-c" << "user.email=t@t"
+                                      << "commit" << "-qm" << "miroir"));
+
+    // Sans indexation pendant la copie, addAllFiles indexe exactement le
+    // change set du miroir: un fichier etranger au miroir n'est pas parcouru
+    GitManager publisher;
+    publisher.setMirrorMode(true);
+    QVERIFY(QFile::remove(source.filePath("nouveau.txt")));
+    writeFile(source.filePath("a.txt"), "a modifie encore");
+    writeFile(source.filePath("sous/ignore.log"), "journal");
+    writeFile(source.filePath("sous/d.txt"), "d");
+    writeFile(repo.filePath("etranger.txt"), "hors miroir");
+    QVERIFY2(publisher.copyProjectRecursively(repoPath, QStringList() << sourcePath),
+             qPrintable(publisher.lastError()));
+    QVERIFY(publisher.m_exactChangeSet);
+    QVERIFY(!publisher.m_changeSetStaged);
+    QVERIFY2(publisher.addAllFiles(repoPath), qPrintable(publisher.lastError()));
+    QVERIFY(publisher.executeGitCommand(repoPath, QStringList() << "diff" << "--cached" << "--name-status"));
+    staged = publisher.lastOutput().split('\n', Qt::SkipEmptyParts);
+    staged.sort();
+    QCOMPARE(staged, QStringList({ "A\tprojet/sous/d.txt", "D\tprojet/nouveau.txt", "M\tprojet/a.txt" }));
+    QVERIFY(!publisher.m_exactChangeSet);
+
+    // Deux copies avant l'ajout: la premiere ne serait pas couverte, tout le depot est repris
+    writeFile(source.filePath("e.txt"), "e");
+    QVERIFY(publisher.copyProjectRecursively(repoPath, QStringList() << source.filePath("e.txt")));
+    QVERIFY(publisher.copyProjectRecursively(repoPath, QStringList() << sourcePath));
+    QVERIFY(!publisher.m_exactChangeSet);
+    QVERIFY(publisher.addAllFiles(repoPath));
+    QVERIFY(publisher.executeGitCommand(repoPath, QStringList() << "diff" << "--cached" << "--name-only"));
+    QVERIFY(publisher.lastOutput().contains("etranger.txt"));
+}
+
+void TestGitManager::testMultiBranchPublish()
+{
+    QTemporaryDir workDir;
+    QVERIFY(workDir.isValid());
+    QDir root(workDir.path());
+
+    const QString remotePath = root.filePath("distant.git");
+    QCOMPARE(QProcess::execute("git", QStringList() << "init" << "-q" << "--bare" << remotePath), 0);
+
+    const QString repoPath = root.filePath("local");
+    QCOMPARE(QProcess::execute("git", QStringList() << "init" << "-q" << "-b" << "main" << repoPath), 0);
+    QCOMPARE(QProcess::execute("git", QStringList() << "-C" << repoPath << "config" << "user.name" << "t"), 0);
+    QCOMPARE(QProcess::execute("git", QStringList() << "-C" << repoPath << "config" << "user.email" << "t@t"), 0);
+    QDir repo(repoPath);
+
+    auto writeFile = [&repo](const QString& name, const QByteArray& data) {
+        QFile file(repo.filePath(name));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(data);
+    };
+
+    // release existe deja (premier commit), docs est nouvelle
+    GitManager manager;
+    writeFile("a.txt", "a");
+    QVERIFY(manager.addAllFiles(repoPath));
+    QVERIFY(manager.commit(repoPath, "premier", 0));
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "branch" << "release"));
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "rev-parse" << "release"));
+    const QString releaseBefore = manager.lastOutput().trimmed();
+
+    writeFile("b.txt", "b");
+    QVERIFY(manager.addAllFiles(repoPath));
+    QVERIFY(manager.commit(repoPath, "second", 0));
+
+    QHash<QString, QString> heads;
+    QVERIFY2(manager.commitToBranches(repoPath, QStringList() << "release" << "docs", "second", &heads),
+             qPrintable(manager.lastError()));
+    QCOMPARE(heads.size(), 2);
+
+    // Meme arbre partout, arbre de travail et HEAD inchanges
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "rev-parse" << "HEAD^{tree}"
+                                      << "release^{tree}" << "docs^{tree}" << "release^" << "HEAD"));
+    const QStringList values = manager.lastOutput().split('\n', Qt::SkipEmptyParts);
+    QCOMPARE(values.size(), 5);
+    QCOMPARE(values.at(1), values.at(0));
+    QCOMPARE(values.at(2), values.at(0));
+    QCOMPARE(values.at(3), releaseBefore);
+    QVERIFY(!manager.executeGitCommand(repoPath, QStringList() << "rev-parse" << "-q" << "--verify" << "docs^"));
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "symbolic-ref" << "--short" << "HEAD"));
+    QCOMPARE(manager.lastOutput().trimmed(), QString("main"));
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "status" << "--porcelain"));
+    QVERIFY(manager.lastOutput().trimmed().isEmpty());
+
+    // Branches deja a jour: aucun nouveau commit
+    QHash<QString, QString> again;
+    QVERIFY(manager.commitToBranches(repoPath, QStringList() << "release" << "docs", "second", &again));
+    QCOMPARE(again, heads);
+
+    // Un seul push pour les trois branches
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "remote" << "add" << "origin"
+                                      << QUrl::fromLocalFile(remotePath).toString()));
+    manager.setConnectivityVerified(true);
+    QVERIFY2(manager.pushBranches(repoPath, QStringList() << "main" << "release" << "docs"),
+             qPrintable(manager.lastError()));
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "ls-remote" << "--heads" << "origin"));
+    const QString remoteHeads = manager.lastOutput();
+    QVERIFY(remoteHeads.contains(heads.value("release") + "\trefs/heads/release"));
+    QVERIFY(remoteHeads.contains(heads.value("docs") + "\trefs/heads/docs"));
+    QVERIFY(remoteHeads.contains(values.at(4) + "\trefs/heads/main"));
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "rev-parse" << "origin/docs"));
+    QCOMPARE(manager.lastOutput().trimmed(), heads.value("docs"));
+
+    // Noms verifies par git check-ref-format --branch
+    QVERIFY(manager.isValidBranchName("feature/x"));
+    QVERIFY(!manager.isValidBranchName("a..b"));
+    QVERIFY(!manager.isValidBranchName("-x"));
+    QVERIFY(!manager.isValidBranchName(QString()));
+
+    // origin/release en avance sur release (fetch): le nouveau commit le prolonge
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "-c" << "user.name=t" << "-c" << "user.email=t@t"
+                                      << "commit-tree" << "release^{tree}" << "-p" << "release" << "-m" << "distant"));
+    const QString remoteAhead = manager.lastOutput().trimmed();
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "update-ref" << "refs/remotes/origin/release"
+                                      << remoteAhead));
+    // origin/docs sans lien avec docs: divergence
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "-c" << "user.name=t" << "-c" << "user.email=t@t"
+                                      << "commit-tree" << "docs^{tree}" << "-m" << "autre"));
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "update-ref" << "refs/remotes/origin/docs"
+                                      << manager.lastOutput().trimmed()));
+
+    writeFile("c.txt", "c");
+    QVERIFY(manager.addAllFiles(repoPath));
+    QVERIFY(manager.commit(repoPath, "troisieme", 0));
+    QVERIFY(!manager.commitToBranches(repoPath, QStringList() << "release" << "docs", "troisieme"));
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "rev-parse" << "release" << "docs"));
+    QCOMPARE(manager.lastOutput().split('\n', Qt::SkipEmptyParts),
+             QStringList({ heads.value("release"), heads.value("docs") }));
+
+    QHash<QString, QString> ahead;
+    QVERIFY2(manager.commitToBranches(repoPath, QStringList() << "release", "troisieme", &ahead),
+             qPrintable(manager.lastError()));
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "rev-parse" << "release^"));
+    QCOMPARE(manager.lastOutput().trimmed(), remoteAhead);
+
+    // Au-dela du seuil: push lot par lot, branche par branche
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "update-ref" << "refs/remotes/origin/release"
+                                      << heads.value("release")));
+    manager.setChunkThreshold(1);
+    manager.setConnectivityVerified(true);
+    QVERIFY2(manager.pushBranches(repoPath, QStringList() << "main" << "release"), qPrintable(manager.lastError()));
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "ls-remote" << "--heads" << "origin"));
+    const QString chunkedHeads = manager.lastOutput();
+    QVERIFY(chunkedHeads.contains(ahead.value("release") + "\trefs/heads/release"));
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "rev-parse" << "main" << "origin/main"));
+    const QStringList mainHeads = manager.lastOutput().split('\n', Qt::SkipEmptyParts);
+    QCOMPARE(mainHeads.size(), 2);
+    QCOMPARE(mainHeads.at(1), mainHeads.at(0));
+    QVERIFY(chunkedHeads.contains(mainHeads.at(0) + "\trefs/heads/main"));
+}
+
+void TestGitManager::testChunkedCommit()
+{
+    QTemporaryDir workDir;
+    QVERIFY(workDir.isValid());
+    QDir repo(workDir.path());
+    auto git = [&repo](const QStringList& args) {
+        return QProcess::execute("git", QStringList() << "-C" << repo.path() << args);
+    };
+    auto writeFile = [&repo](const QString& name, const QByteArray& data) {
+        QFile file(repo.filePath(name));
+        return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+    };
+    QCOMPARE(QProcess::execute("git", QStringList() << "init" << "-q" << repo.path()), 0);
+    QCOMPARE(git({ "config", "user.name", "t" }), 0);
+    QCOMPARE(git({ "config", "user.email", "t@t" }), 0);
+    QVERIFY(writeFile("ancien.txt", "ancien"));
+    QCOMPARE(git({ "add", "-A" }), 0);
+    QCOMPARE(git({ "commit", "-qm", "base" }), 0);
+
+    // Trois fichiers de 100 octets et une suppression indexes, puis un fichier
+    // modifie apres l'indexation: c'est le contenu indexe qui doit partir
+    QVERIFY(writeFile("f1.txt", QByteArray(100, '1')));
+    QVERIFY(writeFile("f2.txt", QByteArray(100, '2')));
+    QVERIFY(writeFile("f3.txt", QByteArray(100, '3')));
+    QCOMPARE(git({ "add", "-A" }), 0);
+    QCOMPARE(git({ "rm", "-q", "ancien.txt" }), 0);
+    QVERIFY(writeFile("f2.txt", "arbre de travail"));
+
+    GitManager manager;
+    manager.setChunkThreshold(150);
+    QVERIFY2(manager.commit(repo.path(), "gros"), qPrintable(manager.lastError()));
+
+    QVERIFY(manager.executeGitCommand(repo.path(), QStringList() << "log" << "--format=%s" << "-4"));
+    QCOMPARE(manager.lastOutput().split('\n', Qt::SkipEmptyParts).mid(0, 4),
+             QStringList({ "gros (partie 3/3)", "gros (partie 2/3)", "gros (partie 1/3)", "base" }));
+    QVERIFY(manager.executeGitCommand(repo.path(), QStringList() << "cat-file" << "blob" << "HEAD:f2.txt"));
+    QCOMPARE(manager.lastOutput().left(100), QString(100, '2'));
+    QVERIFY(!manager.executeGitCommand(repo.path(), QStringList() << "cat-file" << "-e" << "HEAD:ancien.txt"));
+
+    // Index egal a HEAD, modification de l'arbre de travail toujours non indexee
+    QVERIFY(manager.executeGitCommand(repo.path(), QStringList() << "status" << "--porcelain"));
+    QCOMPARE(manager.lastOutput().split('\n', Qt::SkipEmptyParts).value(0), QString(" M f2.txt"));
+
+    // Taille connue sous le seuil: aucun diff, un seul commit
+    QVERIFY(writeFile("f4.txt", "petit"));
+    QCOMPARE(git({ "add", "f4.txt" }), 0);
+    qint64 spawns = manager.metrics().processSpawns();
+    QVERIFY(manager.commit(repo.path(), "petit", 5));
+    QCOMPARE(manager.metrics().processSpawns(), spawns + 1);
+}
+
+void TestGitManager::testStatusTreeModel()
+{
+    QTemporaryDir workDir;
+    QVERIFY(workDir.isValid());
+    QDir repo(workDir.path());
+    auto git = [&repo](const QStringList& args) {
+        return QProcess::execute("git", QStringList() << "-C" << repo.path() << "-c" << "user.name=t"
+                                 << "-c" << "user.email=t@t" << args);
+    };
+    auto write = [&repo](const QString& path, const QByteArray& data) {
+        repo.mkpath(QFileInfo(repo.filePath(path)).path());
+        QFile file(repo.filePath(path));
+        return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+    };
+    QCOMPARE(QProcess::execute("git", QStringList() << "init" << "-q" << repo.path()), 0);
+    QVERIFY(write("a.txt", "a") && write("dossier/x.txt", "x") && write("dossier/ancien.txt", "ancien"));
+    QCOMPARE(git({ "add", "-A" }), 0);
+    QCOMPARE(git({ "commit", "-qm", "init" }), 0);
+
+    // Modifie, ajoute, renomme (enregistrement "2" suivi du chemin d'origine),
+    // supprime et non suivis dans un sous-dossier
+    QVERIFY(write("a.txt", "a modifie") && write("b.txt", "b"));
+    QCOMPARE(git({ "add", "b.txt" }), 0);
+    QCOMPARE(git({ "mv", "dossier/ancien.txt", "dossier/nouveau.txt" }), 0);
+    QVERIFY(repo.remove("dossier/x.txt"));
+    QVERIFY(write("dossier/sous/c.txt", "c") && write("dossier/sous/d.txt", "d"));
+
+    StatusTreeModel model;
+    QSignalSpy finished(&model, &StatusTreeModel::loadingFinished);
+    QSignalSpy failed(&model, &StatusTreeModel::loadingFailed);
+
+    // Lecture relancee avant la fin de la precedente: seule la derniere aboutit
+    model.refresh(repo.path());
+    QVERIFY(model.isLoading());
+    model.refresh(repo.path());
+    QVERIFY(finished.wait(10000));
+    QCOMPARE(finished.count(), 1);
+    QCOMPARE(failed.count(), 0);
+    QCOMPARE(model.fileCount(), qsizetype(6));
+    QVERIFY(!QFileInfo::exists(repo.filePath(".git/index.lock")));
+
+    // Racine: le dossier d'abord, puis les fichiers directs
+    QCOMPARE(model.rowCount(), 3);
+    const QModelIndex folder = model.index(0, 0);
+    QCOMPARE(model.relativePath(folder), QString("dossier"));
+    QCOMPARE(model.relativePath(model.index(1, 0)), QString("a.txt"));
+    QCOMPARE(model.data(model.index(1, 1)).toString(), StatusTreeModel::stateName(StatusTreeModel::FileState::Modified));
+    QCOMPARE(model.data(model.index(2, 1)).toString(), StatusTreeModel::stateName(StatusTreeModel::FileState::Added));
+
+    // Contenu du dossier cree seulement a son deploiement
+    QVERIFY(model.hasChildren(folder));
+    QVERIFY(model.canFetchMore(folder));
+    QCOMPARE(model.rowCount(folder), 0);
+    model.fetchMore(folder);
+    QVERIFY(!model.canFetchMore(folder));
+    QCOMPARE(model.rowCount(folder), 3);
+    QCOMPARE(model.relativePath(model.index(0, 0, folder)), QString("dossier/sous"));
+    QCOMPARE(model.relativePath(model.index(1, 0, folder)), QString("dossier/nouveau.txt"));
+    QCOMPARE(model.data(model.index(1, 1, folder)).toString(),
+             StatusTreeModel::stateName(StatusTreeModel::FileState::Renamed));
+    QCOMPARE(model.data(model.index(2, 1, folder)).toString(),
+             StatusTreeModel::stateName(StatusTreeModel::FileState::Deleted));
+    QCOMPARE(model.parent(model.index(1, 0, folder)), folder);
+
+    const QModelIndex subfolder = model.index(0, 0, folder);
+    QCOMPARE(model.rowCount(subfolder), 0);
+    model.fetchMore(subfolder);
+    QCOMPARE(model.rowCount(subfolder), 2);
+    QCOMPARE(model.data(model.index(0, 1, subfolder)).toString(),
+             StatusTreeModel::stateName(StatusTreeModel::FileState::Untracked));
+}
+
+void TestGitManager::testFetchScheduler()
+{
+    QTemporaryDir workDir;
+    QVERIFY(workDir.isValid());
+    QDir root(workDir.path());
+
+    const QString remotePath = root.filePath("distant.git");
+    const QString remoteUrl = QUrl::fromLocalFile(remotePath).toString();
+    QCOMPARE(QProcess::execute("git", QStringList() << "init" << "-q" << "--bare" << remotePath), 0);
+
+    // Un second clone fait avancer le depot distant
+    const QString upstreamPath = root.filePath("amont");
+    QCOMPARE(QProcess::execute("git", QStringList() << "init" << "-q" << "-b" << "main" << upstreamPath), 0);
+    GitManager manager;
+    QVERIFY(manager.executeGitCommand(upstreamPath, QStringList() << "config" << "user.name" << "t"));
+    QVERIFY(manager.executeGitCommand(upstreamPath, QStringList() << "config" << "user.email" << "t@t"));
+    int upstreamCommits = 0;
+    auto pushUpstream = [&]() {
+        QFile file(QDir(upstreamPath).filePath("a.txt"));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray::number(++upstreamCommits));
+        file.close();
+        QVERIFY(manager.executeGitCommand(upstreamPath, QStringList() << "commit" << "-q" << "-a"
+                                          << "--allow-empty" << "-m" << QString::number(upstreamCommits)));
+        QVERIFY(manager.executeGitCommand(upstreamPath, QStringList() << "push" << "-q" << remoteUrl
+                                          << "main:main"));
+    };
+    QFile first(QDir(upstreamPath).filePath("a.txt"));
+    QVERIFY(first.open(QIODevice::WriteOnly));
+    first.close();
+    QVERIFY(manager.executeGitCommand(upstreamPath, QStringList() << "add" << "a.txt"));
+    pushUpstream();
+
+    const QString repoPath = root.filePath("local");
+    QVERIFY(manager.executeGitCommand(root.path(), QStringList() << "clone" << "-q" << "-b" << "main"
+                                      << remoteUrl << repoPath));
+    auto head = [&](const QString& rev) {
+        manager.executeGitCommand(repoPath, QStringList() << "rev-parse" << rev);
+        return manager.lastOutput().trimmed();
+    };
+    auto remoteHead = [&]() {
+        manager.executeGitCommand(remotePath, QStringList() << "rev-parse" << "main");
+        return manager.lastOutput().trimmed();
+    };
+
+    FetchScheduler scheduler;
+    scheduler.setRepository(repoPath, remoteUrl, "main");
+    QSignalSpy forwarded(&scheduler, &FetchScheduler::fastForwarded);
+    QSignalSpy failed(&scheduler, &FetchScheduler::fetchFailed);
+
+    // En retard et propre: fast-forward
+    pushUpstream();
+    scheduler.fetchNow();
+    QTRY_COMPARE_WITH_TIMEOUT(forwarded.count(), 1, 10000);
+    QCOMPARE(forwarded.at(0).at(0).toInt(), 1);
+    QCOMPARE(head("HEAD"), remoteHead());
+    QTRY_VERIFY(!scheduler.isRunning());
+
+    // Arbre de travail modifie: pas de merge
+    pushUpstream();
+    QFile dirty(QDir(repoPath).filePath("a.txt"));
+    QVERIFY(dirty.open(QIODevice::WriteOnly));
+    dirty.write("local");
+    dirty.close();
+    const QString beforeDirty = head("HEAD");
+    scheduler.fetchNow();
+    QTRY_VERIFY_WITH_TIMEOUT(!scheduler.isRunning(), 10000);
+    QCOMPARE(scheduler.behind(), 1);
+    QCOMPARE(forwarded.count(), 1);
+    QCOMPARE(head("HEAD"), beforeDirty);
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "checkout" << "-q" << "--" << "a.txt"));
+
+    // HEAD sur une autre branche: ni main ni la branche courante n'avancent
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "checkout" << "-q" << "-b" << "autre"));
+    scheduler.fetchNow();
+    QTRY_VERIFY_WITH_TIMEOUT(!scheduler.isRunning(), 10000);
+    QCOMPARE(scheduler.behind(), 1);
+    QCOMPARE(forwarded.count(), 1);
+    QCOMPARE(head("HEAD"), beforeDirty);
+    QCOMPARE(head("refs/heads/main"), beforeDirty);
+    QVERIFY(manager.executeGitCommand(repoPath, QStringList() << "checkout" << "-q" << "main"));
+
+    // Pause pendant le fetch: le cycle interrompu est rejoue a la reprise
+    scheduler.fetchNow();
+    QVERIFY(scheduler.isRunning());
+    scheduler.pause();
+    QVERIFY(!scheduler.isRunning());
+    QTest::qWait(200);
+    QCOMPARE(forwarded.count(), 1);
+    QCOMPARE(head("HEAD"), beforeDirty);
+    scheduler.resume();
+    QTRY_COMPARE_WITH_TIMEOUT(forwarded.count(), 2, 10000);
+    QCOMPARE(head("HEAD"), remoteHead());
+    QCOMPARE(failed.count(), 0);
+}
+
+// Sans QApplication: StatusTreeModel est lie a Widgets mais ses icones ne sont pas demandees
+QTEST_GUILESS_MAIN(TestGitManager)
 #include "test_gitmanager.moc"
\ No newline at end of file